@@ -0,0 +1,71 @@
+// Compares startup asset loading from loose files against the packed
+// archive: wall time to read every asset, files opened, and size on disk
+// (allocated blocks, so per-file slack counts). Each mode runs in its own
+// process; drop the page cache between runs for cold-start numbers.
+//
+// Usage: AssetArchiveBench loose <asset directory>
+//        AssetArchiveBench pack  <assets.llrpak>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+#include "core/AssetArchive.h"
+#include "core/JobSystem.h"
+
+static uint64_t diskBytes(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return 0;
+    return static_cast<uint64_t>(info.st_blocks) * 512;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3 || (std::strcmp(argv[1], "loose") != 0 && std::strcmp(argv[1], "pack") != 0)) {
+        std::cerr << "Usage: " << argv[0] << " loose <asset directory> | pack <assets.llrpak>" << std::endl;
+        return 1;
+    }
+    bool packed = std::strcmp(argv[1], "pack") == 0;
+    JobSystem jobs;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t files = 0, opened = 0;
+    uint64_t bytes = 0, onDisk = 0, checksum = 0;
+
+    if (packed) {
+        AssetArchive archive;
+        if (!archive.open(argv[2])) return 1;
+        opened = 1;
+        std::vector<uint8_t> data;
+        for (size_t i = 0; i < archive.getEntryCount(); ++i) {
+            if (!archive.read(archive.getName(archive.getEntry(i)), data, &jobs)) return 1;
+            bytes += data.size();
+            if (!data.empty()) checksum += data[data.size() / 2];
+            ++files;
+        }
+        onDisk = diskBytes(argv[2]);
+    } else {
+        namespace fs = std::filesystem;
+        std::vector<char> data;
+        for (const auto& item : fs::recursive_directory_iterator(argv[2])) {
+            if (!item.is_regular_file()) continue;
+            std::ifstream file(item.path(), std::ios::binary | std::ios::ate);
+            if (!file.is_open()) return 1;
+            ++opened;
+            data.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(data.data(), static_cast<std::streamsize>(data.size()));
+            bytes += data.size();
+            if (!data.empty()) checksum += static_cast<uint8_t>(data[data.size() / 2]);
+            onDisk += diskBytes(item.path().string());
+            ++files;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << argv[1] << ": " << seconds * 1000.0 << " ms, " << files << " assets, " << opened
+              << " files opened, " << bytes / (1024.0 * 1024.0) << " MB read, "
+              << onDisk / (1024.0 * 1024.0) << " MB on disk (checksum " << checksum << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cmath>
+
+// Column-major 4x4 helpers in GL conventions, so benchmarks can build view
+// matrices without a dependency on glm
+
+inline void multiply(const float* a, const float* b, float* out) {
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k) sum += a[k * 4 + r] * b[c * 4 + k];
+            out[c * 4 + r] = sum;
+        }
+    }
+}
+
+inline void perspective(float fovY, float aspect, float nearZ, float farZ, float* out) {
+    float f = 1.0f / std::tan(fovY * 0.5f);
+    for (int i = 0; i < 16; ++i) out[i] = 0.0f;
+    out[0] = f / aspect;
+    out[5] = f;
+    out[10] = (farZ + nearZ) / (nearZ - farZ);
+    out[11] = -1.0f;
+    out[14] = 2.0f * farZ * nearZ / (nearZ - farZ);
+}
+
+inline void lookAt(const float* eye, const float* target, float* out) {
+    float f[3] = { target[0] - eye[0], target[1] - eye[1], target[2] - eye[2] };
+    float fl = std::sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+    for (float& v : f) v /= fl;
+    float up[3] = { 0.0f, 1.0f, 0.0f };
+    float s[3] = { f[1] * up[2] - f[2] * up[1], f[2] * up[0] - f[0] * up[2], f[0] * up[1] - f[1] * up[0] };
+    float sl = std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+    for (float& v : s) v /= sl;
+    float u[3] = { s[1] * f[2] - s[2] * f[1], s[2] * f[0] - s[0] * f[2], s[0] * f[1] - s[1] * f[0] };
+    const float m[16] = {
+        s[0], u[0], -f[0], 0.0f,
+        s[1], u[1], -f[1], 0.0f,
+        s[2], u[2], -f[2], 0.0f,
+        -(s[0] * eye[0] + s[1] * eye[1] + s[2] * eye[2]),
+        -(u[0] * eye[0] + u[1] * eye[1] + u[2] * eye[2]),
+        f[0] * eye[0] + f[1] * eye[1] + f[2] * eye[2], 1.0f
+    };
+    for (int i = 0; i < 16; ++i) out[i] = m[i];
+}
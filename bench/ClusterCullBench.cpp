@@ -0,0 +1,86 @@
+// Cluster culling throughput and triangle reduction: orbits a camera
+// around a mesh and culls its clusters against each view, single-threaded
+// and on all workers, then packs the surviving index ranges.
+//
+// Usage: ClusterCullBench <file.obj|file.llrmesh> [views]
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "BenchMath.h"
+#include "core/JobSystem.h"
+#include "scene/MeshCache.h"
+#include "scene/MeshClusters.h"
+#include "scene/ObjImporter.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.obj|file.llrmesh> [views]" << std::endl;
+        return 1;
+    }
+    std::string path = argv[1];
+    int views = argc > 2 ? std::atoi(argv[2]) : 256;
+
+    JobSystem jobs;
+    MeshData mesh;
+    if (path.size() > 8 && path.compare(path.size() - 8, 8, ".llrmesh") == 0) {
+        MeshCacheFile cache;
+        if (!cache.open(path)) return 1;
+        mesh = cache.toMeshData();
+    } else if (!importObj(path, mesh, &jobs)) {
+        return 1;
+    }
+    if (mesh.clusters.empty()) {
+        auto start = std::chrono::steady_clock::now();
+        buildClusters(mesh);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Clustering: " << ms << " ms" << std::endl;
+    }
+    std::cout << mesh.clusters.size() << " clusters, "
+              << (mesh.lods.empty() ? mesh.indices.size() : mesh.lods[0].indexCount) / 3 << " triangles" << std::endl;
+
+    MeshBounds bounds = mesh.computeBounds();
+    float center[3], extent = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        center[axis] = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+        extent = std::max(extent, bounds.max[axis] - bounds.min[axis]);
+    }
+
+    ClusterCuller culler(mesh.clusters.data(), mesh.clusters.size());
+    std::vector<uint32_t> visible;
+    std::vector<uint32_t> packed(mesh.indices.size());
+    float projection[16];
+    perspective(60.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.01f * extent, 100.0f * extent, projection);
+
+    for (int threaded = 0; threaded < 2; ++threaded) {
+        double cullMs = 0.0, compactMs = 0.0;
+        size_t trianglesTested = 0, trianglesVisible = 0, clustersTested = 0;
+        for (int v = 0; v < views; ++v) {
+            // Orbit, alternating between whole-object and close-up views
+            float angle = 6.2831853f * static_cast<float>(v) / static_cast<float>(views);
+            float distance = extent * (v % 2 ? 0.6f : 1.5f);
+            float eye[3] = { center[0] + distance * std::cos(angle), center[1] + extent * 0.25f,
+                             center[2] + distance * std::sin(angle) };
+            float view[16], viewProjection[16];
+            lookAt(eye, center, view);
+            multiply(projection, view, viewProjection);
+
+            ClusterCullStats stats;
+            culler.cull(makeClusterCullView(viewProjection, eye), visible, threaded ? &jobs : nullptr, &stats);
+            culler.compact(mesh.indices.data(), visible, packed.data(), threaded ? &jobs : nullptr, &stats);
+            cullMs += stats.cullMilliseconds;
+            compactMs += stats.compactMilliseconds;
+            clustersTested += stats.clustersTested;
+            trianglesTested += stats.trianglesTested;
+            trianglesVisible += stats.trianglesVisible;
+        }
+
+        std::cout << (threaded ? "Threaded (" : "Single (") << (threaded ? jobs.getThreadCount() : 1) << " threads): "
+                  << static_cast<double>(clustersTested) / (cullMs * 1e3) << " M clusters/s, cull "
+                  << cullMs / views << " ms, compact " << compactMs / views << " ms per view; triangles kept "
+                  << 100.0 * static_cast<double>(trianglesVisible) / static_cast<double>(trianglesTested) << "%" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+// Command recording scaling: culls and records the same scene of objects
+// into per-thread command lists with 1..N threads, then merges them as the
+// GL thread would before replay. No GL context is needed; only the CPU
+// side of frame building is measured.
+//
+// Usage: CommandRecordBench [max threads] [objects]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "core/JobSystem.h"
+#include "graphics/CommandList.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Object {
+    float position[3];
+    float radius;
+    uint32_t program;
+    uint32_t vertexArray;
+    uint32_t indexCount;
+};
+
+// Per-draw constants as a real draw would upload them
+struct DrawConstants {
+    float model[16];
+    float color[4];
+};
+
+static std::vector<Object> makeScene(size_t count) {
+    std::vector<Object> objects(count);
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    };
+    for (auto& object : objects) {
+        object.position[0] = next() * 200.0f - 100.0f;
+        object.position[1] = next() * 20.0f - 10.0f;
+        object.position[2] = next() * 200.0f - 100.0f;
+        object.radius = 0.5f + next() * 2.0f;
+        object.program = 1 + static_cast<uint32_t>(next() * 8.0f);
+        object.vertexArray = 1 + static_cast<uint32_t>(next() * 64.0f);
+        object.indexCount = 36 + static_cast<uint32_t>(next() * 3000.0f);
+    }
+    return objects;
+}
+
+// Cull against a fixed 90 degree view cone looking down -z, then record
+static void recordObjects(CommandList& list, const std::vector<Object>& objects, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const Object& object = objects[i];
+        float distance = std::sqrt(object.position[0] * object.position[0] + object.position[1] * object.position[1] +
+                                   object.position[2] * object.position[2]);
+        if (-object.position[2] + object.radius * 1.4142f < distance * 0.7071f) {
+            continue;
+        }
+
+        DrawConstants constants = {};
+        float angle = static_cast<float>(i) * 0.01f;
+        constants.model[0] = std::cos(angle);
+        constants.model[2] = -std::sin(angle);
+        constants.model[5] = 1.0f;
+        constants.model[8] = std::sin(angle);
+        constants.model[10] = std::cos(angle);
+        constants.model[12] = object.position[0];
+        constants.model[13] = object.position[1];
+        constants.model[14] = object.position[2];
+        constants.model[15] = 1.0f;
+        constants.color[0] = constants.color[1] = constants.color[2] = constants.color[3] = 1.0f;
+
+        DrawCommand command = {};
+        command.sortKey = makeSortKey(0, object.program, object.vertexArray, distance / 150.0f);
+        command.program = object.program;
+        command.vertexArray = object.vertexArray;
+        command.count = object.indexCount;
+        command.instanceCount = 1;
+        command.indexType = DrawCommand::IndexType::UInt32;
+        command.constants = list.storeConstants(&constants, sizeof(constants));
+        command.constantsSize = sizeof(constants);
+        list.draw(command);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t maxThreads = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : std::max(1u, std::thread::hardware_concurrency());
+    size_t objectCount = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 200000;
+    const int iterations = 10;
+    std::vector<Object> objects = makeScene(objectCount);
+
+    std::cout << objectCount << " objects" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "record ms" << std::setw(10) << "speedup"
+              << std::setw(12) << "merge ms" << std::setw(10) << "draws" << std::endl;
+
+    double baseRecord = 0.0;
+    for (size_t threads = 1; threads <= maxThreads; threads = (threads < maxThreads && threads * 2 > maxThreads) ? maxThreads : threads * 2) {
+        JobSystem jobs(threads);
+        std::vector<CommandList> lists(jobs.getThreadCount());
+        std::vector<const DrawCommand*> merged;
+
+        double record = 0.0, merge = 0.0;
+        for (int i = 0; i <= iterations; ++i) {
+            for (auto& list : lists) list.reset();
+            auto start = Clock::now();
+            recordCommandLists(jobs, lists, objects.size(), [&objects](CommandList& list, size_t begin, size_t end) {
+                recordObjects(list, objects, begin, end);
+            });
+            auto recorded = Clock::now();
+            mergeCommandLists(lists, merged);
+            auto done = Clock::now();
+            // First pass warms up the arenas and worker threads
+            if (i > 0) {
+                record += std::chrono::duration<double, std::milli>(recorded - start).count();
+                merge += std::chrono::duration<double, std::milli>(done - recorded).count();
+            }
+        }
+        record /= iterations;
+        merge /= iterations;
+        if (threads == 1) {
+            baseRecord = record;
+        }
+
+        std::cout << std::fixed << std::setprecision(2) << std::setw(8) << threads << std::setw(14) << record
+                  << std::setw(10) << baseRecord / record << std::setw(12) << merge << std::setw(10) << merged.size()
+                  << std::endl;
+
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Scaling benchmark for the job system: runs the same workloads with 1..N
+// threads and prints wall time and speedup relative to a single thread.
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "core/JobSystem.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Flat data-parallel loop, like a culling or transform update pass
+static double runParallelFor(JobSystem& jobs, std::vector<float>& data) {
+    auto start = Clock::now();
+    jobs.parallelFor(data.size(), [&data](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            float x = static_cast<float>(i) * 0.001f;
+            data[i] = std::sin(x) * std::cos(x * 0.5f) + std::sqrt(x);
+        }
+    });
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Jobs that spawn and wait on child jobs, exercising stealing and
+// waiting from inside a job
+static double runNested(JobSystem& jobs, std::vector<float>& data) {
+    auto start = Clock::now();
+    const size_t groups = 64;
+    const size_t groupSize = data.size() / groups;
+
+    JobCounter outer;
+    for (size_t g = 0; g < groups; ++g) {
+        jobs.run([&jobs, &data, g, groupSize]() {
+            jobs.parallelFor(groupSize, [&data, g, groupSize](size_t begin, size_t end) {
+                for (size_t i = g * groupSize + begin; i < g * groupSize + end; ++i) {
+                    data[i] = std::sqrt(data[i] * data[i] + 1.0f);
+                }
+            });
+        }, &outer);
+    }
+    jobs.wait(outer);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        maxThreads = static_cast<size_t>(std::atoi(argv[1]));
+    }
+
+    std::vector<float> data(1 << 24);
+    const int iterations = 5;
+
+    std::cout << std::setw(8) << "threads"
+              << std::setw(16) << "parallelFor ms" << std::setw(10) << "speedup"
+              << std::setw(16) << "nested ms" << std::setw(10) << "speedup" << std::endl;
+
+    double baseFlat = 0.0, baseNested = 0.0;
+    for (size_t threads = 1; threads <= maxThreads; threads = (threads < maxThreads && threads * 2 > maxThreads) ? maxThreads : threads * 2) {
+        JobSystem jobs(threads);
+
+        // Warm up page faults and worker threads
+        runParallelFor(jobs, data);
+
+        double flat = 0.0, nested = 0.0;
+        for (int i = 0; i < iterations; ++i) {
+            flat += runParallelFor(jobs, data);
+            nested += runNested(jobs, data);
+        }
+        flat /= iterations;
+        nested /= iterations;
+
+        if (threads == 1) {
+            baseFlat = flat;
+            baseNested = nested;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << threads
+                  << std::setw(16) << flat << std::setw(10) << baseFlat / flat
+                  << std::setw(16) << nested << std::setw(10) << baseNested / nested << std::endl;
+
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+
+    return 0;
+}
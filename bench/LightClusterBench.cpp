@@ -0,0 +1,66 @@
+// Clustered light binning: scatters point lights through a city-sized
+// volume and bins them into the cluster grid for a moving camera,
+// single-threaded and on all workers.
+//
+// Usage: LightClusterBench [lights] [views]
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "BenchMath.h"
+#include "core/JobSystem.h"
+#include "scene/LightClusters.h"
+
+int main(int argc, char** argv) {
+    size_t lightCount = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 4096;
+    int views = argc > 2 ? std::atoi(argv[2]) : 128;
+    if (lightCount > 0xFFFF) {
+        std::cerr << "At most 65535 lights" << std::endl;
+        return 1;
+    }
+
+    const float extent = 400.0f;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-extent * 0.5f, extent * 0.5f);
+    std::uniform_real_distribution<float> height(0.5f, 30.0f);
+    std::uniform_real_distribution<float> radius(2.0f, 12.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<PointLight> lights(lightCount);
+    for (PointLight& light : lights) {
+        light = { { position(rng), height(rng), position(rng) }, radius(rng), { unit(rng), unit(rng), unit(rng) }, 1.0f };
+    }
+
+    JobSystem jobs;
+    LightClusterGrid grid;
+    grid.setProjection(60.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, extent);
+    std::cout << lightCount << " lights, " << grid.getClusterCount() << " clusters" << std::endl;
+
+    for (int threaded = 0; threaded < 2; ++threaded) {
+        double binMs = 0.0;
+        size_t visible = 0, indices = 0, maxPerCluster = 0;
+        for (int v = 0; v < views; ++v) {
+            // Fly in a circle just above street level, looking along the path
+            float angle = 6.2831853f * static_cast<float>(v) / static_cast<float>(views);
+            float eye[3] = { extent * 0.3f * std::cos(angle), 4.0f, extent * 0.3f * std::sin(angle) };
+            float target[3] = { eye[0] - std::sin(angle), 3.5f, eye[2] + std::cos(angle) };
+            float view[16];
+            lookAt(eye, target, view);
+
+            LightClusterStats stats;
+            grid.build(lights.data(), lights.size(), view, threaded ? &jobs : nullptr, &stats);
+            binMs += stats.binMilliseconds;
+            visible += stats.lightsVisible;
+            indices += stats.indexCount;
+            maxPerCluster = std::max(maxPerCluster, stats.maxLightsPerCluster);
+        }
+
+        std::cout << (threaded ? "Threaded (" : "Single (") << (threaded ? jobs.getThreadCount() : 1) << " threads): bin "
+                  << binMs / views << " ms per view; " << visible / views << " lights visible, "
+                  << static_cast<double>(indices) / views / static_cast<double>(grid.getClusterCount())
+                  << " lights per cluster on average, " << maxPerCluster << " at most" << std::endl;
+    }
+    return 0;
+}
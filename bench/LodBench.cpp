@@ -0,0 +1,74 @@
+// Triangles drawn with and without LOD selection for a large scattered
+// scene: one mesh instanced on a square field around the camera, selected
+// per instance by projected screen-space error.
+//
+// Usage: LodBench <file.obj|file.llrmesh> [instances] [field size] [max pixel error]
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "core/JobSystem.h"
+#include "scene/MeshCache.h"
+#include "scene/MeshSimplifier.h"
+#include "scene/ObjImporter.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.obj|file.llrmesh> [instances] [field size] [max pixel error]" << std::endl;
+        return 1;
+    }
+    std::string path = argv[1];
+    int instances = argc > 2 ? std::atoi(argv[2]) : 10000;
+    float fieldSize = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 2000.0f;
+    float maxPixelError = argc > 4 ? static_cast<float>(std::atof(argv[4])) : 1.0f;
+
+    JobSystem jobs;
+    MeshData mesh;
+    if (path.size() > 8 && path.compare(path.size() - 8, 8, ".llrmesh") == 0) {
+        MeshCacheFile cache;
+        if (!cache.open(path)) return 1;
+        mesh = cache.toMeshData();
+    } else if (!importObj(path, mesh, &jobs)) {
+        return 1;
+    }
+
+    if (mesh.lods.size() <= 1) {
+        auto start = std::chrono::steady_clock::now();
+        generateLods(mesh);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "LOD generation: " << ms << " ms" << std::endl;
+    }
+    for (size_t i = 0; i < mesh.lods.size(); ++i) {
+        std::cout << "  LOD " << i << ": " << mesh.lods[i].indexCount / 3 << " triangles, error "
+                  << mesh.lods[i].error << std::endl;
+    }
+
+    // 60 degree vertical FOV at 1080p, camera at the field centre
+    const float fovY = 60.0f * 3.14159265f / 180.0f;
+    const int viewportHeight = 1080;
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> coordinate(-fieldSize * 0.5f, fieldSize * 0.5f);
+
+    uint64_t full = 0;
+    uint64_t rendered = 0;
+    std::vector<uint64_t> perLod(mesh.lods.size());
+    for (int i = 0; i < instances; ++i) {
+        float x = coordinate(random);
+        float z = coordinate(random);
+        float distance = std::sqrt(x * x + z * z);
+        int lod = selectLod(mesh.lods.data(), mesh.lods.size(), distance, fovY, viewportHeight, maxPixelError);
+        full += mesh.lods[0].indexCount / 3;
+        rendered += mesh.lods[lod].indexCount / 3;
+        ++perLod[lod];
+    }
+
+    std::cout << instances << " instances: " << rendered << " triangles with LOD vs " << full
+              << " without (" << 100.0 * static_cast<double>(rendered) / static_cast<double>(full) << "%)" << std::endl;
+    for (size_t i = 0; i < perLod.size(); ++i) {
+        std::cout << "  LOD " << i << ": " << perLod[i] << " instances" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Compares loading source OBJ files against their cooked .llrmesh versions:
+// wall time and peak resident memory. Each mode runs in its own process
+// so peak RSS is not shared between them.
+//
+// Usage: MeshLoadBench obj   <file.obj> [...]      (one thread)
+//        MeshLoadBench objmt <file.obj> [...]      (all cores)
+//        MeshLoadBench mmap  <file.llrmesh> [...]
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sys/resource.h>
+
+#include "core/JobSystem.h"
+#include "scene/MeshCache.h"
+#include "scene/ObjImporter.h"
+
+static double peakRssMegabytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes
+#else
+    return usage.ru_maxrss / 1024.0;             // kilobytes
+#endif
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (std::strcmp(argv[1], "obj") != 0 && std::strcmp(argv[1], "objmt") != 0 &&
+                     std::strcmp(argv[1], "mmap") != 0)) {
+        std::cerr << "Usage: " << argv[0] << " obj|objmt|mmap <files...>" << std::endl;
+        return 1;
+    }
+    bool cooked = std::strcmp(argv[1], "mmap") == 0;
+    bool threaded = std::strcmp(argv[1], "objmt") == 0;
+    JobSystem jobs(threaded ? 0 : 1);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t vertices = 0, indices = 0, bytes = 0;
+    uint64_t checksum = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        if (cooked) {
+            MeshCacheFile cache;
+            if (!cache.open(argv[i])) return 1;
+            // Touch every page, as an upload from the mapping would
+            const uint8_t* blob = reinterpret_cast<const uint8_t*>(cache.getVertices());
+            for (size_t b = 0; b < cache.getVertexCount() * sizeof(MeshVertex); b += 4096) checksum += blob[b];
+            vertices += cache.getVertexCount();
+            indices += cache.getIndexCount();
+        } else {
+            MeshData mesh;
+            if (!importObj(argv[i], mesh, &jobs)) return 1;
+            vertices += mesh.vertices.size();
+            indices += mesh.indices.size();
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (int i = 2; i < argc; ++i) {
+        MappedFile file;
+        if (file.open(argv[i])) bytes += file.size();
+    }
+
+    std::cout << argv[1] << ": " << seconds * 1000.0 << " ms, "
+              << bytes / (1024.0 * 1024.0) / seconds << " MB/s, peak RSS "
+              << peakRssMegabytes() << " MB, " << vertices << " vertices, " << indices / 3
+              << " triangles (checksum " << checksum << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,153 @@
+// Software occlusion culling on a synthetic city: a grid of box buildings
+// with small props scattered along the streets, viewed from street level.
+// The nearest in-frustum buildings are rasterized as occluders and every
+// object that survives frustum culling is tested against the pyramid.
+//
+// Usage: OcclusionBench [views] [blocks] [props]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "BenchMath.h"
+#include "core/JobSystem.h"
+#include "scene/MeshClusters.h"
+#include "scene/OcclusionCuller.h"
+
+namespace {
+
+constexpr float kBlockSize = 40.0f;
+constexpr float kStreetWidth = 12.0f;
+constexpr size_t kMaxOccluders = 64;
+
+// Unit cube, scaled and placed by each building's model matrix
+const float kCubePositions[8 * 3] = {
+    0, 0, 0,  1, 0, 0,  1, 1, 0,  0, 1, 0,
+    0, 0, 1,  1, 0, 1,  1, 1, 1,  0, 1, 1,
+};
+const uint32_t kCubeIndices[36] = {
+    0, 2, 1, 0, 3, 2,  4, 5, 6, 4, 6, 7,  0, 1, 5, 0, 5, 4,
+    3, 6, 2, 3, 7, 6,  0, 4, 7, 0, 7, 3,  1, 2, 6, 1, 6, 5,
+};
+
+bool insideFrustum(const ClusterCullView& view, const MeshBounds& bounds) {
+    float center[3], radius = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        center[axis] = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+        float half = (bounds.max[axis] - bounds.min[axis]) * 0.5f;
+        radius += half * half;
+    }
+    radius = std::sqrt(radius);
+    for (const auto& plane : view.planes) {
+        if (plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3] < -radius) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int views = argc > 1 ? std::atoi(argv[1]) : 64;
+    int blocks = argc > 2 ? std::atoi(argv[2]) : 32;
+    size_t propCount = argc > 3 ? static_cast<size_t>(std::atoll(argv[3])) : 20000;
+
+    // Buildings fill each block minus the street; props sit on the streets
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> height(8.0f, 60.0f);
+    std::vector<MeshBounds> objects;
+    size_t buildingCount = static_cast<size_t>(blocks) * blocks;
+    for (int z = 0; z < blocks; ++z) {
+        for (int x = 0; x < blocks; ++x) {
+            float x0 = static_cast<float>(x) * kBlockSize + kStreetWidth * 0.5f;
+            float z0 = static_cast<float>(z) * kBlockSize + kStreetWidth * 0.5f;
+            float size = kBlockSize - kStreetWidth;
+            objects.push_back({ { x0, 0.0f, z0 }, { x0 + size, height(rng), z0 + size } });
+        }
+    }
+    float cityExtent = static_cast<float>(blocks) * kBlockSize;
+    std::uniform_real_distribution<float> along(0.0f, cityExtent);
+    std::uniform_int_distribution<int> street(0, blocks);
+    std::uniform_real_distribution<float> propSize(0.5f, 2.5f);
+    for (size_t i = 0; i < propCount; ++i) {
+        float across = static_cast<float>(street(rng)) * kBlockSize + (along(rng) / cityExtent - 0.5f) * kStreetWidth * 0.8f;
+        float position[2] = { along(rng), across };
+        if (i % 2) std::swap(position[0], position[1]);
+        float size = propSize(rng);
+        objects.push_back({ { position[0], 0.0f, position[1] }, { position[0] + size, size * 1.5f, position[1] + size } });
+    }
+    std::cout << buildingCount << " buildings, " << propCount << " props" << std::endl;
+
+    JobSystem jobs;
+    OcclusionCuller culler;
+    float projection[16];
+    perspective(60.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.5f, cityExtent * 1.5f, projection);
+
+    std::vector<MeshBounds> candidates;
+    std::vector<uint8_t> visible;
+    std::vector<std::pair<float, size_t>> occluders;
+    for (int threaded = 0; threaded < 2; ++threaded) {
+        JobSystem* pool = threaded ? &jobs : nullptr;
+        size_t inFrustum = 0, drawn = 0, occluderTriangles = 0;
+        double rasterMs = 0.0, pyramidMs = 0.0, testMs = 0.0;
+        for (int v = 0; v < views; ++v) {
+            // Walk down a street, panning around
+            float t = static_cast<float>(v) / static_cast<float>(std::max(1, views));
+            int streetIndex = v % (blocks + 1);
+            float eye[3] = { static_cast<float>(streetIndex) * kBlockSize, 1.7f, cityExtent * (0.1f + 0.8f * t) };
+            float angle = 6.2831853f * t * 3.0f;
+            float target[3] = { eye[0] + std::sin(angle), 1.7f, eye[2] + std::cos(angle) };
+            float view[16], viewProjection[16];
+            lookAt(eye, target, view);
+            multiply(projection, view, viewProjection);
+            ClusterCullView frustum = makeClusterCullView(viewProjection, eye);
+
+            candidates.clear();
+            occluders.clear();
+            for (size_t i = 0; i < objects.size(); ++i) {
+                if (!insideFrustum(frustum, objects[i])) continue;
+                candidates.push_back(objects[i]);
+                if (i < buildingCount) {
+                    float dx = (objects[i].min[0] + objects[i].max[0]) * 0.5f - eye[0];
+                    float dz = (objects[i].min[2] + objects[i].max[2]) * 0.5f - eye[2];
+                    occluders.push_back({ dx * dx + dz * dz, i });
+                }
+            }
+            size_t occluderCount = std::min(occluders.size(), kMaxOccluders);
+            std::partial_sort(occluders.begin(), occluders.begin() + occluderCount, occluders.end());
+
+            culler.beginFrame(viewProjection);
+            for (size_t o = 0; o < occluderCount; ++o) {
+                const MeshBounds& b = objects[occluders[o].second];
+                const float model[16] = {
+                    b.max[0] - b.min[0], 0, 0, 0,
+                    0, b.max[1] - b.min[1], 0, 0,
+                    0, 0, b.max[2] - b.min[2], 0,
+                    b.min[0], b.min[1], b.min[2], 1,
+                };
+                culler.addOccluder(kCubePositions, sizeof(float) * 3, 8, kCubeIndices, 36, model);
+            }
+            culler.render(pool);
+            visible.resize(candidates.size());
+            culler.testBounds(candidates.data(), candidates.size(), visible.data(), pool);
+
+            const OcclusionStats& stats = culler.getStats();
+            inFrustum += candidates.size();
+            drawn += stats.objectsTested - stats.objectsOccluded;
+            occluderTriangles += stats.occluderTriangles;
+            rasterMs += stats.rasterMilliseconds;
+            pyramidMs += stats.pyramidMilliseconds;
+            testMs += stats.testMilliseconds;
+        }
+
+        std::cout << (threaded ? "Threaded (" : "Single (") << (threaded ? jobs.getThreadCount() : 1) << " threads): "
+                  << occluderTriangles / views << " occluder triangles, raster " << rasterMs / views << " ms, pyramid "
+                  << pyramidMs / views << " ms, test " << testMs / views << " ms per view; " << inFrustum / views
+                  << " objects in frustum, " << drawn / views << " drawn ("
+                  << 100.0 * (1.0 - static_cast<double>(drawn) / static_cast<double>(std::max<size_t>(1, inFrustum)))
+                  << "% occluded)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Block-compression encoder report: throughput (MPix/s), quality (PSNR) and
+// memory saved versus RGBA8, for each BC format, with and without mips.
+//
+// Usage: TextureCompressionBench [image files...]
+// With no arguments a synthetic 2048x2048 test image is used.
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+#include "core/JobSystem.h"
+#include "graphics/BlockCompression.h"
+
+static TextureData makeTestImage(int size) {
+    TextureData data;
+    TextureLevel level;
+    level.width = level.height = size;
+    level.pixels.resize(static_cast<size_t>(size) * size * 4);
+    uint32_t noise = 12345;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            noise = noise * 1664525u + 1013904223u;
+            uint8_t* pixel = &level.pixels[(static_cast<size_t>(y) * size + x) * 4];
+            pixel[0] = static_cast<uint8_t>(x * 255 / size);
+            pixel[1] = static_cast<uint8_t>(127 + 120 * std::sin(x * 0.02 + y * 0.013));
+            pixel[2] = static_cast<uint8_t>((y * 255 / size + (noise >> 28)) & 255);
+            pixel[3] = static_cast<uint8_t>(((x / 64 + y / 64) & 1) ? 255 : 32);
+        }
+    }
+    data.levels.push_back(std::move(level));
+    return data;
+}
+
+int main(int argc, char** argv) {
+    JobSystem jobs;
+
+    std::vector<TextureData> images;
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        TextureData data;
+        if (decodeImage(bytes.data(), bytes.size(), data)) {
+            images.push_back(std::move(data));
+        }
+    }
+    if (images.empty()) {
+        images.push_back(makeTestImage(2048));
+    }
+
+    struct Format { BlockFormat format; const char* name; int channels; };
+    const Format formats[] = {
+        { BlockFormat::BC1, "BC1", 3 }, { BlockFormat::BC3, "BC3", 4 },
+        { BlockFormat::BC4, "BC4", 1 }, { BlockFormat::BC5, "BC5", 2 }
+    };
+
+    std::cout << "threads: " << jobs.getThreadCount() << ", images: " << images.size() << std::endl;
+    std::cout << std::left << std::setw(6) << "format" << std::right
+              << std::setw(12) << "MPix/s" << std::setw(12) << "PSNR dB"
+              << std::setw(14) << "RGBA8 MB" << std::setw(14) << "BC MB" << std::setw(12) << "saved MB" << std::endl;
+
+    for (const Format& format : formats) {
+        double pixels = 0.0, seconds = 0.0, psnrSum = 0.0;
+        size_t rawBytes = 0, compressedBytes = 0;
+
+        for (TextureData image : images) {
+            image.srgb = false;
+            generateMipChain(image, MipFilter::Box, &jobs);
+
+            for (size_t level = 0; level < image.levels.size(); ++level) {
+                std::vector<uint8_t> blocks;
+                auto start = std::chrono::steady_clock::now();
+                compressLevel(image.levels[level], format.format, blocks, &jobs);
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                pixels += static_cast<double>(image.levels[level].width) * image.levels[level].height;
+                rawBytes += image.levels[level].pixels.size();
+                compressedBytes += blocks.size();
+
+                if (level == 0) {
+                    TextureLevel decoded;
+                    decompressLevel(format.format, blocks.data(), image.levels[0].width, image.levels[0].height, decoded);
+                    psnrSum += computePsnr(image.levels[0], decoded, format.channels);
+                }
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(6) << format.name << std::right
+                  << std::setw(12) << pixels / seconds / 1e6
+                  << std::setw(12) << psnrSum / images.size()
+                  << std::setw(14) << rawBytes / 1048576.0
+                  << std::setw(14) << compressedBytes / 1048576.0
+                  << std::setw(12) << (rawBytes - compressedBytes) / 1048576.0 << std::endl;
+    }
+    return 0;
+}
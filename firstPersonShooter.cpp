@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <cmath>
@@ -29,6 +30,11 @@ const float HEAD_BOB_SPEED = 10.0f;
 const float HEAD_BOB_AMOUNT = 0.5f;
 const float VERTICAL_FOV = 0.75f;  // Controls wall height
 
+// Movement is simulated in fixed steps, independent of the frame rate;
+// rendering interpolates between the last two steps
+const float SIM_STEP = 1.0f / 120.0f;
+const int MAX_STEPS_PER_FRAME = 8;  // Drop time after long stalls instead of catching up
+
 // Game map (# = wall, . = empty space)
 std::string map = 
     "################"
@@ -99,16 +105,22 @@ int main() {
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
     bool running = true;
-    auto tp1 = std::chrono::system_clock::now();
+    auto tp1 = std::chrono::steady_clock::now();
     auto tp2 = tp1;
+    float accumulator = 0.0f;
 
     float headBob = 0.0f;  // Add this with other player variables
 
+    // State at the previous simulation step, for interpolation
+    float previousX = playerX;
+    float previousY = playerY;
+    float previousBob = headBob;
+
     while (running) {
-        tp2 = std::chrono::system_clock::now();
+        tp2 = std::chrono::steady_clock::now();
         std::chrono::duration<float> elapsedTime = tp2 - tp1;
         tp1 = tp2;
-        float fElapsedTime = elapsedTime.count();
+        accumulator = std::min(accumulator + elapsedTime.count(), SIM_STEP * MAX_STEPS_PER_FRAME);
 
         // Reset input vector each frame
         input = Vector2(0, 0);
@@ -140,51 +152,66 @@ int main() {
             input = input.normalized();
         }
 
-        // Calculate acceleration
-        Vector2 wishDir;
-        if (input.length() > 0) {
-            // Convert input to world space (fixed orientation)
-            wishDir.x = input.x * cos(playerA - M_PI/2) - input.y * sin(playerA);
-            wishDir.y = input.x * sin(playerA - M_PI/2) + input.y * cos(playerA);
+        while (accumulator >= SIM_STEP) {
+            accumulator -= SIM_STEP;
+            const float fElapsedTime = SIM_STEP;
+            previousX = playerX;
+            previousY = playerY;
+            previousBob = headBob;
+
+            // Calculate acceleration
+            Vector2 wishDir;
+            if (input.length() > 0) {
+                // Convert input to world space (fixed orientation)
+                wishDir.x = input.x * cos(playerA - M_PI/2) - input.y * sin(playerA);
+                wishDir.y = input.x * sin(playerA - M_PI/2) + input.y * cos(playerA);
             
-            // Update head bob
-            headBob += fElapsedTime * HEAD_BOB_SPEED;
-        } else {
-            // Smoothly reset head bob
-            headBob = fmod(headBob, 2.0f * M_PI);
-            if (headBob > 0) {
-                headBob = std::max(0.0f, headBob - fElapsedTime * HEAD_BOB_SPEED);
+                // Update head bob
+                headBob += fElapsedTime * HEAD_BOB_SPEED;
+            } else {
+                // Smoothly reset head bob
+                headBob = fmod(headBob, 2.0f * M_PI);
+                if (headBob > 0) {
+                    headBob = std::max(0.0f, headBob - fElapsedTime * HEAD_BOB_SPEED);
+                }
             }
-        }
 
-        // Apply acceleration
-        velocity = velocity + wishDir * (ACCELERATION * fElapsedTime);
+            // Apply acceleration
+            velocity = velocity + wishDir * (ACCELERATION * fElapsedTime);
         
-        // Clamp to maximum speed
-        float speed = velocity.length();
-        if (speed > MAX_SPEED) {
-            velocity = velocity * (MAX_SPEED / speed);
-        }
+            // Clamp to maximum speed
+            float speed = velocity.length();
+            if (speed > MAX_SPEED) {
+                velocity = velocity * (MAX_SPEED / speed);
+            }
 
-        // Apply friction
-        speed = velocity.length();
-        if (speed > 0) {
-            float drop = speed * FRICTION * fElapsedTime;
-            velocity = velocity * (speed > drop ? (speed - drop) / speed : 0);
-        }
+            // Apply friction
+            speed = velocity.length();
+            if (speed > 0) {
+                float drop = speed * FRICTION * fElapsedTime;
+                velocity = velocity * (speed > drop ? (speed - drop) / speed : 0);
+            }
 
-        // Update position
-        float newX = playerX + velocity.x * fElapsedTime;
-        float newY = playerY + velocity.y * fElapsedTime;
+            // Update position
+            float newX = playerX + velocity.x * fElapsedTime;
+            float newY = playerY + velocity.y * fElapsedTime;
 
-        // Collision checking
-        if (map.at((int)playerY * MAP_WIDTH + (int)newX) != '#') {
-            playerX = newX;
-        }
-        if (map.at((int)newY * MAP_WIDTH + (int)playerX) != '#') {
-            playerY = newY;
+            // Collision checking
+            if (map.at((int)playerY * MAP_WIDTH + (int)newX) != '#') {
+                playerX = newX;
+            }
+            if (map.at((int)newY * MAP_WIDTH + (int)playerX) != '#') {
+                playerY = newY;
+            }
         }
 
+        // Render between the last two steps
+        const float alpha = accumulator / SIM_STEP;
+        const float viewX = previousX + (playerX - previousX) * alpha;
+        const float viewY = previousY + (playerY - previousY) * alpha;
+        // Blend the offset, not the phase, which wraps when the bob resets
+        const float bobOffset = (sin(previousBob) + (sin(headBob) - sin(previousBob)) * alpha) * HEAD_BOB_AMOUNT;
+
         // Clear screen
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
@@ -210,8 +237,8 @@ int main() {
             while (!hitWall && distanceToWall < DEPTH) {
                 distanceToWall += stepSize;
                 
-                int testX = (int)(playerX + rayX * distanceToWall);
-                int testY = (int)(playerY + rayY * distanceToWall);
+                int testX = (int)(viewX + rayX * distanceToWall);
+                int testY = (int)(viewY + rayY * distanceToWall);
                 
                 if (testX < 0 || testX >= MAP_WIDTH || testY < 0 || testY >= MAP_HEIGHT) {
                     hitWall = true;
@@ -223,8 +250,8 @@ int main() {
                     // Check for wall boundaries for shading
                     float blockMidX = testX + 0.5f;
                     float blockMidY = testY + 0.5f;
-                    float testPointX = playerX + rayX * distanceToWall;
-                    float testPointY = playerY + rayY * distanceToWall;
+                    float testPointX = viewX + rayX * distanceToWall;
+                    float testPointY = viewY + rayY * distanceToWall;
                     float testAngle = atan2f(testPointY - blockMidY, testPointX - blockMidX);
                     
                     if (abs(testPointX - (float)testX) < 0.01f || abs(testPointX - (testX + 1)) < 0.01f ||
@@ -241,7 +268,6 @@ int main() {
             int floor = SCREEN_HEIGHT - ceiling;
             
             // Add subtle head bob to ceiling and floor
-            float bobOffset = sin(headBob) * HEAD_BOB_AMOUNT;
             ceiling += (int)bobOffset;
             floor += (int)bobOffset;
 
@@ -290,8 +316,8 @@ int main() {
 
         // Draw player on minimap
         SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-        SDL_Rect playerRect = {(int)(playerX * MINIMAP_SCALE) - 2,
-                             (int)(playerY * MINIMAP_SCALE) - 2, 4, 4};
+        SDL_Rect playerRect = {(int)(viewX * MINIMAP_SCALE) - 2,
+                             (int)(viewY * MINIMAP_SCALE) - 2, 4, 4};
         SDL_RenderFillRect(renderer, &playerRect);
 
         // Present render
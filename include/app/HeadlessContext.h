@@ -0,0 +1,28 @@
+#pragma once
+
+// OpenGL 4.1 core context with no window, for benchmarking on machines
+// without a display. Uses EGL on Mesa's surfaceless platform when
+// available (llvmpipe works without any GPU), the default EGL display
+// otherwise. Rendering goes to a Framebuffer; there is no default
+// framebuffer to draw to.
+//
+// Only built where EGL was found (LLR_HAS_EGL); elsewhere the constructor
+// throws.
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // Loader for gladLoadGLLoader
+    static void* getProcAddress(const char* name);
+
+    static bool isSupported();
+
+private:
+    void* m_display;
+    void* m_context;
+    void* m_surface;   // 1x1 pbuffer when surfaceless contexts are missing
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <GLFW/glfw3.h>
+#include "core/SpscQueue.h"
+
+// One window event as recorded by the GLFW callbacks
+struct InputEvent {
+    enum class Type : uint8_t {
+        Key,
+        MouseButton,
+        MouseMove,
+        Scroll
+    };
+
+    Type type;
+    uint8_t action;                 // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+    uint16_t mods;
+    int32_t code;                   // Key or mouse button
+    float x, y;                     // Cursor position, or scroll offset
+    float deltaX, deltaY;           // Cursor motion since the previous move
+    int64_t timestampNanoseconds;   // InputQueue::now() when the event arrived
+};
+
+// Everything that arrived since the last drain, coalesced
+struct InputFrame {
+    float mouseDeltaX = 0.0f;
+    float mouseDeltaY = 0.0f;
+    float scrollX = 0.0f;
+    float scrollY = 0.0f;
+    float cursorX = 0.0f;           // Latest cursor position
+    float cursorY = 0.0f;
+    std::vector<InputEvent> buttons; // Key and mouse button events, in order
+    std::bitset<GLFW_KEY_LAST + 1> keysDown;
+
+    size_t eventCount = 0;
+    int64_t oldestTimestamp = 0;    // 0 when nothing arrived
+    int64_t newestTimestamp = 0;
+
+    bool isKeyDown(int key) const { return key >= 0 && key <= GLFW_KEY_LAST && keysDown[key]; }
+    // Key or mouse button pressed in this frame
+    bool wasPressed(InputEvent::Type type, int code) const;
+};
+
+// Timestamped events from the window's callbacks to whoever simulates.
+// The callbacks only append fixed-size records to a lock-free ring; the
+// consumer drains it once per tick, summing cursor motion and scrolling
+// and keeping key and button transitions in order. Mouse deltas are taken
+// on the producer side so they stay exact however the consumer batches.
+//
+// push() belongs to the thread that polls events, drain() to one consumer.
+class InputQueue {
+public:
+    explicit InputQueue(size_t capacity = 4096);
+
+    void pushKey(int key, int action, int mods);
+    void pushMouseButton(int button, int action, int mods);
+    void pushCursor(double x, double y);
+    void pushScroll(double x, double y);
+    // The next cursor position starts a new motion, e.g. after capturing
+    // the cursor, instead of producing a jump
+    void resetCursor();
+
+    void drain(InputFrame& frame);
+
+    // Events lost because the consumer fell a whole ring behind. Dropped
+    // key releases leave keys reported as held until pressed again.
+    uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Clock of the event timestamps
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    SpscQueue<InputEvent> m_queue;
+    std::atomic<uint64_t> m_dropped;
+
+    // Producer side
+    bool m_hasCursor;
+    double m_cursorX;
+    double m_cursorY;
+
+    // Consumer side
+    std::bitset<GLFW_KEY_LAST + 1> m_keysDown;
+    float m_lastCursorX;
+    float m_lastCursorY;
+
+    void push(const InputEvent& event);
+};
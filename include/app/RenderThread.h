@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+
+class Window;
+
+// Runs rendering on its own thread so event handling and simulation on the
+// main thread never delay GPU submission. The window's GL context moves to
+// the render thread for its lifetime: every GL object has to be created in
+// start and released in stop, both called on the render thread with the
+// context current. frame is called in a loop and each call is followed by
+// a buffer swap, so vsync paces the render thread, not the main thread.
+//
+// GLFW event polling and window management stay on the main thread.
+class RenderThread {
+public:
+    struct Callbacks {
+        std::function<void()> start;
+        std::function<void()> frame;
+        std::function<void()> stop;
+        // Optional, after each swap returns
+        std::function<void()> presented;
+    };
+
+    // The context must be current on the calling thread; it is released here
+    RenderThread(Window& window, Callbacks callbacks);
+    // Calls stop() and makes the context current on the calling thread again
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Finish the current frame, run the stop callback and join. Rethrows an
+    // exception that ended the render thread early.
+    void stop();
+
+    // False once the render thread ended, by stop() or by an exception
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+    uint64_t getFrameCount() const { return m_frames.load(std::memory_order_relaxed); }
+
+private:
+    Window& m_window;
+    Callbacks m_callbacks;
+    std::atomic<bool> m_stopRequested;
+    std::atomic<bool> m_running;
+    std::atomic<uint64_t> m_frames;
+    std::exception_ptr m_error;
+    std::thread m_thread;
+
+    void threadMain();
+};
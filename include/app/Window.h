@@ -1,36 +1,60 @@
 #pragma once
 #include <string>
-#include <functional>
 #include <GLFW/glfw3.h>
+#include "app/Input.h"
 
 class Window {
 public:
-    Window(int width, int height, const std::string& title);
+    enum class VSync {
+        Off,
+        On,
+        Adaptive    // Sync, but tear instead of waiting a whole refresh when late
+    };
+    
+    // createUploadContext adds a hidden window whose GL context shares
+    // objects with the main one, for use by a background upload thread
+    Window(int width, int height, const std::string& title, bool createUploadContext = false);
     ~Window();
     
     bool shouldClose() const;
+    void setShouldClose(bool close);
     void swapBuffers();
     void pollEvents();
+    // Sleep until an event arrives or the timeout passes, then process events
+    void waitEvents(double timeoutSeconds);
+    
+    // Adaptive needs EXT_swap_control_tear and falls back to On without
+    // it; returns the mode actually set. Applies to the context current
+    // on the calling thread, which must be this window's
+    VSync setVSync(VSync mode);
+    VSync getVSync() const { return m_vsync; }
+    
+    // Events recorded by the callbacks during pollEvents/waitEvents
+    InputQueue& getInput() { return m_input; }
     
-    void setKeyCallback(std::function<void(int, int, int, int)> callback);
-    void setMouseMoveCallback(std::function<void(double, double)> callback);
+    // Hide and lock the cursor for mouse look, with unaccelerated raw
+    // motion where the platform supports it
+    void setCursorCaptured(bool captured);
     
     int getWidth() const;
     int getHeight() const;
     float getContentScaleFactor() const; // For Retina displays
     
     GLFWwindow* getGLFWWindow() { return m_window; }
+    GLFWwindow* getUploadContext() { return m_uploadContext; }
     
 private:
     GLFWwindow* m_window;
+    GLFWwindow* m_uploadContext;
     int m_width;
     int m_height;
+    VSync m_vsync;
     
-    // Callbacks
-    std::function<void(int, int, int, int)> m_keyCallback;
-    std::function<void(double, double)> m_mouseMoveCallback;
+    InputQueue m_input;
     
     // GLFW callback wrappers
     static void keyCallbackWrapper(GLFWwindow* window, int key, int scancode, int action, int mods);
     static void mouseMoveCallbackWrapper(GLFWwindow* window, double xpos, double ypos);
+    static void mouseButtonCallbackWrapper(GLFWwindow* window, int button, int action, int mods);
+    static void scrollCallbackWrapper(GLFWwindow* window, double xoffset, double yoffset);
 }; 
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "core/MappedFile.h"
+#include "core/Task.h"
+
+// Packed asset archive (.llrpak). Layout:
+//
+//   ArchiveHeader
+//   ArchiveEntry[entryCount]    sorted by (nameHash, name)
+//   ArchiveChunk[chunkCount]
+//   name table                  entry names, not null-terminated
+//   chunk payloads              LZ4 blocks, or raw when compression
+//                               did not help
+//
+// Every asset is split into fixed-size chunks that compress and decompress
+// independently, so one large asset can be inflated on several workers.
+constexpr char kArchiveMagic[4] = { 'L', 'L', 'R', 'A' };
+constexpr uint32_t kArchiveVersion = 1;
+constexpr uint32_t kDefaultArchiveChunkSize = 256 * 1024;
+
+struct ArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t chunkCount;
+    uint32_t chunkSize;
+    uint32_t nameTableSize;
+    uint64_t fileSize;
+};
+
+struct ArchiveEntry {
+    uint64_t nameHash;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint64_t size;          // Uncompressed
+    uint32_t firstChunk;
+    uint32_t chunkCount;
+};
+
+struct ArchiveChunk {
+    uint64_t offset;
+    uint32_t storedSize;    // == rawSize means stored uncompressed
+    uint32_t rawSize;
+};
+
+static_assert(sizeof(ArchiveHeader) == 32, "ArchiveHeader layout changed; bump kArchiveVersion");
+static_assert(sizeof(ArchiveEntry) == 32, "ArchiveEntry layout changed; bump kArchiveVersion");
+static_assert(sizeof(ArchiveChunk) == 16, "ArchiveChunk layout changed; bump kArchiveVersion");
+
+struct ArchiveInput {
+    std::string name;       // Lookup key, '/' separated, relative to the asset root
+    std::string path;       // File on disk
+};
+
+struct ArchiveWriteStats {
+    uint64_t rawBytes = 0;
+    uint64_t storedBytes = 0;
+    size_t fileCount = 0;
+};
+
+// Offline side: compress inputs (chunks in parallel) and write the archive
+bool writeAssetArchive(const std::string& outputPath, const std::vector<ArchiveInput>& inputs,
+                       JobSystem* jobs = nullptr, uint32_t chunkSize = kDefaultArchiveChunkSize,
+                       ArchiveWriteStats* stats = nullptr);
+
+// Runtime side: the whole archive is one mapping; lookups are a binary
+// search over the table of contents and reads only touch the chunks of
+// the requested asset.
+class AssetArchive {
+public:
+    // Rejects archives whose table of contents points outside the file
+    bool open(const std::string& path);
+
+    bool contains(std::string_view name) const { return find(name) != nullptr; }
+    const ArchiveEntry* find(std::string_view name) const;
+    std::string_view getName(const ArchiveEntry& entry) const;
+
+    size_t getEntryCount() const { return m_header ? m_header->entryCount : 0; }
+    const ArchiveEntry& getEntry(size_t index) const { return m_entries[index]; }
+
+    // Decompress an asset; chunks are spread across the job system
+    bool read(std::string_view name, std::vector<uint8_t>& out, JobSystem* jobs = nullptr) const;
+
+private:
+    MappedFile m_file;
+    const ArchiveHeader* m_header = nullptr;
+    const ArchiveEntry* m_entries = nullptr;
+    const ArchiveChunk* m_chunks = nullptr;
+    const char* m_names = nullptr;
+
+    // Bounds-checks the table of contents so read() can trust it
+    bool validateTables(uint64_t payloadStart) const;
+    bool readChunk(const ArchiveChunk& chunk, uint8_t* out) const;
+};
+
+// Coroutine form: resumes on a worker and inflates there
+Task<std::vector<uint8_t>> readAsset(JobSystem& jobs, const AssetArchive& archive, std::string name);
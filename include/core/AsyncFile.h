@@ -0,0 +1,9 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/Task.h"
+
+// Read a whole file on a job system worker. Throws std::runtime_error
+// (through the awaiting coroutine) if the file cannot be read.
+Task<std::vector<uint8_t>> readFile(JobSystem& jobs, std::string path);
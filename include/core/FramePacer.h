@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+struct FramePacerSettings {
+    double stepSeconds = 1.0 / 60.0;    // Fixed simulation step
+    // Steps run in one frame at most; after a long stall the excess time is
+    // discarded instead of being simulated in a burst that stalls again
+    int maxStepsPerFrame = 5;
+
+    double targetFps = 0.0;             // Frame-rate limit, 0 = off
+    // The limiter sleeps until this close to the deadline and spins the
+    // rest, since sleeps overshoot by up to a scheduler tick
+    double spinMilliseconds = 2.0;
+
+    size_t historyFrames = 1024;        // Frame times kept for the stats
+};
+
+struct FrameTimeStats {
+    size_t frames = 0;
+    double averageMilliseconds = 0.0;
+    double minMilliseconds = 0.0;
+    double p50Milliseconds = 0.0;
+    double p95Milliseconds = 0.0;
+    double p99Milliseconds = 0.0;
+    double maxMilliseconds = 0.0;
+};
+
+// Average and percentiles of a set of durations
+FrameTimeStats summarizeFrameTimes(std::vector<float> milliseconds);
+
+// Decouples simulation from rendering. Each frame beginFrame() measures the
+// time since the previous frame on the steady clock, adds it to an
+// accumulator and returns how many fixed steps the simulation should take;
+// the renderer then blends the last two simulated states by getAlpha().
+// endFrame() holds the frame to the target rate, if one is set.
+//
+// Frame times are measured start to start, so they include swap and
+// limiter waits and describe the cadence the user sees.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FramePacer(FramePacerSettings settings = {});
+
+    // Returns the number of simulation steps to run before rendering
+    int beginFrame();
+    // Call after presenting; waits out the rest of the frame under a limit
+    void endFrame();
+
+    double getStepSeconds() const { return m_settings.stepSeconds; }
+    // How far the frame is between the last two simulated states, [0, 1)
+    float getAlpha() const;
+    // Until the accumulator holds another step, for loops that sleep
+    // between steps
+    double getSecondsUntilNextStep() const;
+    // Time lost to the maxStepsPerFrame clamp
+    double getDroppedSeconds() const { return m_droppedSeconds; }
+
+    // Percentiles over the last historyFrames frames
+    FrameTimeStats getStats() const;
+
+    void setTargetFps(double fps);
+
+private:
+    FramePacerSettings m_settings;
+    Clock::time_point m_lastFrame;
+    Clock::time_point m_deadline;
+    bool m_started;
+    double m_accumulator;
+    double m_droppedSeconds;
+
+    std::vector<float> m_history;   // Ring of frame times in ms
+    size_t m_historyNext;
+
+    void waitUntil(Clock::time_point deadline) const;
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// 64-bit FNV-1a. Not cryptographic; used for content keys and tables.
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = kFnvOffsetBasis) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+inline uint64_t hashString(std::string_view text, uint64_t seed = kFnvOffsetBasis) {
+    return hashBytes(text.data(), text.size(), seed);
+}
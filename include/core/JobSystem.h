@@ -0,0 +1,154 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Dependency counter for a group of jobs. Incremented when a job is queued
+// against it and decremented when that job finishes; wait() returns once it
+// reaches zero. The first exception a job throws is kept here until wait()
+// rethrows it.
+struct JobCounter {
+    std::atomic<int> pending{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;   // Written by the job that set failed
+
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Work-stealing job system. The thread that constructs it becomes worker 0
+// and owns a deque like every background worker; jobs submitted from a
+// worker go onto that worker's own Chase-Lev deque (LIFO for the owner),
+// idle workers steal from the other end (FIFO). Threads that are not
+// workers submit through a shared injection queue. One thread may be a
+// worker of several systems.
+//
+// A job that throws does not take its worker down: the exception is
+// caught and rethrown by wait() on the job's counter, once every job on
+// that counter has finished. Jobs without a counter hand theirs to the
+// next wait() on this system.
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+
+    // threadCount 0 = one thread per hardware core, including the caller
+    explicit JobSystem(size_t threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void run(JobFunction job, JobCounter* counter = nullptr);
+
+    // Execute other jobs until counter reaches zero. Safe to call from
+    // inside a job: the waiting thread keeps the pool busy instead of
+    // blocking, so nested waits cannot deadlock. Rethrows the first
+    // exception of a job on counter, then resets it for reuse.
+    void wait(JobCounter& counter);
+
+    // Run fn(begin, end) over [0, count) in chunks and wait for completion.
+    // minChunk 0 picks a chunk size that gives each thread several chunks
+    // for load balancing. The first exception from any chunk is rethrown
+    // after all of them have finished.
+    template<typename Fn>
+    void parallelFor(size_t count, Fn&& fn, size_t minChunk = 0);
+
+    // Total threads that execute jobs, including the owning thread
+    size_t getThreadCount() const { return m_workers.size(); }
+
+    // Index of the calling thread in [0, getThreadCount()), or -1 when the
+    // calling thread is not a worker of this system
+    int getCurrentThreadIndex() const;
+
+private:
+    struct Job {
+        JobFunction function;
+        JobCounter* counter;
+    };
+
+    // Fixed-capacity Chase-Lev deque (Le et al., "Correct and Efficient
+    // Work-Stealing for Weak Memory Models", 2013)
+    class WorkStealingDeque {
+    public:
+        explicit WorkStealingDeque(size_t capacity = 4096);
+
+        bool push(Job* job);   // Owner only; false when full
+        Job* pop();            // Owner only
+        Job* steal();          // Any thread
+
+    private:
+        std::atomic<int64_t> m_top;
+        std::atomic<int64_t> m_bottom;
+        std::unique_ptr<std::atomic<Job*>[]> m_buffer;
+        int64_t m_mask;
+    };
+
+    struct Worker {
+        WorkStealingDeque deque;
+        std::thread thread;
+    };
+
+    const uint64_t m_id;    // Never reused, unlike the address
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_injectMutex;
+    std::deque<Job*> m_injected;
+
+    // Sleeping for idle workers
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<int64_t> m_queuedJobs;
+    std::atomic<bool> m_running;
+
+    // First exception from a job without a counter
+    std::mutex m_errorMutex;
+    std::exception_ptr m_error;
+
+    void workerLoop(size_t index);
+    Job* findJob(int threadIndex, uint32_t& rngState);
+    void execute(Job* job);
+    void notifyWorkers();
+    void rethrowError(JobCounter& counter);
+};
+
+template<typename Fn>
+void JobSystem::parallelFor(size_t count, Fn&& fn, size_t minChunk) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t chunkSize = std::max<size_t>(count / (getThreadCount() * 4), 1);
+    chunkSize = std::max(chunkSize, minChunk);
+
+    if (chunkSize >= count) {
+        fn(size_t(0), count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = chunkSize; begin < count; begin += chunkSize) {
+        size_t end = std::min(count, begin + chunkSize);
+        run([&fn, begin, end]() { fn(begin, end); }, &counter);
+    }
+
+    // The calling thread does the first chunk instead of idling
+    try {
+        fn(size_t(0), chunkSize);
+    } catch (...) {
+        // The queued chunks reference fn and counter; let them finish
+        try {
+            wait(counter);
+        } catch (...) {
+        }
+        throw;
+    }
+    wait(counter);
+}
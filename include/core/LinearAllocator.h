@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Bump allocator for short-lived, per-frame data. Not thread-safe by design:
+// give each thread its own instance and reset() it once the frame that used
+// the memory is finished. Nothing is freed individually.
+class LinearAllocator {
+public:
+    LinearAllocator(size_t blockSize = 64 * 1024, size_t alignment = 16);
+    ~LinearAllocator();
+
+    LinearAllocator(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+    LinearAllocator(LinearAllocator&& other) noexcept;
+    LinearAllocator& operator=(LinearAllocator&& other) noexcept;
+
+    // alignment must be a power of two; 0 uses the allocator's default
+    void* alloc(size_t size, size_t alignment = 0);
+
+    template<typename T>
+    T* allocArray(size_t count) {
+        return static_cast<T*>(alloc(sizeof(T) * count, alignof(T)));
+    }
+
+    // Rewind to the start; keeps the blocks around for the next frame
+    void reset();
+
+    size_t getBytesUsed() const;
+    size_t getBytesReserved() const;
+
+private:
+    struct Block {
+        char* memory;
+        size_t size;
+        size_t used;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_current;
+    size_t m_blockSize;
+    size_t m_alignment;
+
+    Block createBlock(size_t minSize);
+    void release();
+};
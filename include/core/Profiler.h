@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scoped CPU profiling. Every thread records into its own fixed-size event
+// buffer (single writer, published with an atomic count), so markers never
+// take a lock. Nothing is recorded outside a capture: a marker then costs
+// one relaxed atomic load. Build with LLR_ENABLE_PROFILER=0 to compile the
+// markers out entirely.
+//
+// Captures are exported as Chrome trace_event JSON, which chrome://tracing
+// and Perfetto open directly. GPU spans from GpuProfiler land on their own
+// track in the same capture.
+class Profiler {
+public:
+    // Event names must outlive the capture; string literals are expected
+    struct Event {
+        const char* name;
+        int64_t startNanoseconds;   // Since the profiler epoch
+        int64_t endNanoseconds;
+    };
+
+    // Events per thread and capture; later ones are counted as dropped
+    static constexpr size_t kEventsPerThread = 1 << 16;
+
+    static void beginCapture();
+    static void endCapture();
+    static bool isCapturing() { return s_capturing.load(std::memory_order_relaxed); }
+
+    // Label the calling thread in exported traces
+    static void setThreadName(const std::string& name);
+
+    static void record(const char* name, int64_t startNanoseconds, int64_t endNanoseconds);
+    // Spans measured elsewhere (GPU), already on the profiler clock
+    static void recordGpu(const char* name, int64_t startNanoseconds, int64_t endNanoseconds);
+
+    static int64_t now();
+
+    // Write the last capture; returns false if the file cannot be written
+    static bool writeChromeTrace(const std::string& path);
+
+    // Events dropped in the last capture because a buffer was full
+    static size_t getDroppedCount();
+
+private:
+    static std::atomic<bool> s_capturing;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : m_name(name), m_start(Profiler::isCapturing() ? Profiler::now() : -1) {}
+    ~ProfileScope() {
+        if (m_start >= 0) Profiler::record(m_name, m_start, Profiler::now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_start;
+};
+
+#ifndef LLR_ENABLE_PROFILER
+#define LLR_ENABLE_PROFILER 1
+#endif
+
+#define LLR_PROFILE_CONCAT_INNER(a, b) a##b
+#define LLR_PROFILE_CONCAT(a, b) LLR_PROFILE_CONCAT_INNER(a, b)
+
+#if LLR_ENABLE_PROFILER
+#define LLR_PROFILE_SCOPE(name) ProfileScope LLR_PROFILE_CONCAT(llrProfileScope, __LINE__)(name)
+#define LLR_PROFILE_FUNCTION() LLR_PROFILE_SCOPE(__func__)
+#else
+#define LLR_PROFILE_SCOPE(name) ((void)0)
+#define LLR_PROFILE_FUNCTION() ((void)0)
+#endif
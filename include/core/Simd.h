@@ -0,0 +1,110 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define LLR_SIMD_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LLR_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Four-wide float vector over SSE2 or NEON with a scalar fallback. Kept
+// deliberately small: just what the CPU-side graphics kernels need.
+struct Float4 {
+#if defined(LLR_SIMD_SSE)
+    __m128 v;
+    Float4() : v(_mm_setzero_ps()) {}
+    Float4(__m128 value) : v(value) {}
+    explicit Float4(float s) : v(_mm_set1_ps(s)) {}
+    Float4(float x, float y, float z, float w) : v(_mm_setr_ps(x, y, z, w)) {}
+
+    static Float4 load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+    friend Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+    friend Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+    friend Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+    friend Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+    friend Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+
+    friend Float4 cmpGe(Float4 a, Float4 b) { return _mm_cmpge_ps(a.v, b.v); }
+    friend Float4 select(Float4 mask, Float4 a, Float4 b) {
+        return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+    }
+    friend int moveMask(Float4 mask) { return _mm_movemask_ps(mask.v); }
+#elif defined(LLR_SIMD_NEON)
+    float32x4_t v;
+    Float4() : v(vdupq_n_f32(0.0f)) {}
+    Float4(float32x4_t value) : v(value) {}
+    explicit Float4(float s) : v(vdupq_n_f32(s)) {}
+    Float4(float x, float y, float z, float w) {
+        const float values[4] = { x, y, z, w };
+        v = vld1q_f32(values);
+    }
+
+    static Float4 load(const float* p) { return vld1q_f32(p); }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return vaddq_f32(a.v, b.v); }
+    friend Float4 operator-(Float4 a, Float4 b) { return vsubq_f32(a.v, b.v); }
+    friend Float4 operator*(Float4 a, Float4 b) { return vmulq_f32(a.v, b.v); }
+    friend Float4 min(Float4 a, Float4 b) { return vminq_f32(a.v, b.v); }
+    friend Float4 max(Float4 a, Float4 b) { return vmaxq_f32(a.v, b.v); }
+#if defined(__aarch64__)
+    friend Float4 sqrt(Float4 a) { return vsqrtq_f32(a.v); }
+#else
+    friend Float4 sqrt(Float4 a) {
+        float values[4];
+        vst1q_f32(values, a.v);
+        for (float& value : values) value = std::sqrt(value);
+        return vld1q_f32(values);
+    }
+#endif
+
+    friend Float4 cmpGe(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v)); }
+    friend Float4 select(Float4 mask, Float4 a, Float4 b) {
+        return vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v);
+    }
+    friend int moveMask(Float4 mask) {
+        uint32_t lanes[4];
+        vst1q_u32(lanes, vreinterpretq_u32_f32(mask.v));
+        return static_cast<int>((lanes[0] >> 31) | ((lanes[1] >> 31) << 1) | ((lanes[2] >> 31) << 2) | ((lanes[3] >> 31) << 3));
+    }
+#else
+    float v[4];
+    Float4() : v{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+    explicit Float4(float s) : v{ s, s, s, s } {}
+    Float4(float x, float y, float z, float w) : v{ x, y, z, w } {}
+
+    static Float4 load(const float* p) { return Float4(p[0], p[1], p[2], p[3]); }
+    void store(float* p) const { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return Float4(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]); }
+    friend Float4 operator-(Float4 a, Float4 b) { return Float4(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]); }
+    friend Float4 operator*(Float4 a, Float4 b) { return Float4(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]); }
+    friend Float4 min(Float4 a, Float4 b) { return Float4(a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1], a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]); }
+    friend Float4 max(Float4 a, Float4 b) { return Float4(a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]); }
+    friend Float4 sqrt(Float4 a) { return Float4(std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])); }
+
+    // Scalar masks are 1.0 / 0.0 per lane
+    friend Float4 cmpGe(Float4 a, Float4 b) {
+        return Float4(a.v[0] >= b.v[0] ? 1.0f : 0.0f, a.v[1] >= b.v[1] ? 1.0f : 0.0f, a.v[2] >= b.v[2] ? 1.0f : 0.0f, a.v[3] >= b.v[3] ? 1.0f : 0.0f);
+    }
+    friend Float4 select(Float4 mask, Float4 a, Float4 b) {
+        return Float4(mask.v[0] != 0.0f ? a.v[0] : b.v[0], mask.v[1] != 0.0f ? a.v[1] : b.v[1], mask.v[2] != 0.0f ? a.v[2] : b.v[2], mask.v[3] != 0.0f ? a.v[3] : b.v[3]);
+    }
+    friend int moveMask(Float4 mask) {
+        return (mask.v[0] != 0.0f) | ((mask.v[1] != 0.0f) << 1) | ((mask.v[2] != 0.0f) << 2) | ((mask.v[3] != 0.0f) << 3);
+    }
+#endif
+
+    Float4& operator+=(Float4 other) { *this = *this + other; return *this; }
+
+    // Masks come from cmpGe() and are only meant for select() and moveMask()
+
+    // a * b + c
+    friend Float4 madd(Float4 a, Float4 b, Float4 c) { return a * b + c; }
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+// Bounded lock-free queue for exactly one producer and one consumer thread.
+// Each side owns one index and keeps a cached copy of the other, so the
+// shared cache lines are only touched when the cached view runs out.
+template<typename T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity = 1024) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        if (size < 2) {
+            throw std::invalid_argument("SpscQueue needs a capacity of at least two");
+        }
+        m_buffer = std::make_unique<T[]>(size);
+        m_mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer only; false when the queue is full
+    bool tryPush(const T& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+        m_buffer[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only; false when the queue is empty
+    bool tryPop(T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        value = m_buffer[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t getCapacity() const { return m_mask + 1; }
+
+private:
+    std::unique_ptr<T[]> m_buffer;
+    size_t m_mask = 0;
+
+    // Consumer side
+    alignas(64) std::atomic<size_t> m_head{ 0 };
+    size_t m_cachedTail = 0;
+
+    // Producer side
+    alignas(64) std::atomic<size_t> m_tail{ 0 };
+    size_t m_cachedHead = 0;
+};
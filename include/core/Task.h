@@ -0,0 +1,195 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include "core/JobSystem.h"
+
+// Lazily started coroutine returning T. A Task does nothing until it is
+// co_awaited (or handed to spawn()); when it finishes it resumes whoever
+// awaited it on the same thread via symmetric transfer, so chains of
+// awaits do not grow the stack.
+//
+// Which thread a coroutine runs on is controlled explicitly by awaiting an
+// executor, e.g. for an asset load:
+//
+//     Task<void> loadTexture(JobSystem& jobs, GLExecutor& gl, std::string path) {
+//         auto bytes = co_await readFile(jobs, path);   // worker thread
+//         auto image = decode(bytes);                    // still on the worker
+//         co_await gl.schedule();                        // main/GL thread
+//         upload(image);
+//     }
+template<typename T = void>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    template<typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+    T takeResult() {
+        if (exception) std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+
+    void takeResult() {
+        if (exception) std::rethrow_exception(exception);
+    }
+};
+
+} // namespace detail
+
+template<typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle handle) : m_handle(handle) {}
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (m_handle) m_handle.destroy();
+    }
+
+    bool isReady() const { return !m_handle || m_handle.done(); }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+            bool await_ready() noexcept { return !handle || handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() { return handle.promise().takeResult(); }
+        };
+        return Awaiter{ m_handle };
+    }
+
+private:
+    Handle m_handle;
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+class TaskGroup;
+
+// Start a task without waiting for it. The task runs on the calling thread
+// until its first executor switch. Exceptions are counted on the group (if
+// any) rather than propagated.
+template<typename T>
+void spawn(Task<T> task, TaskGroup* group = nullptr);
+
+// Tracks a set of spawned tasks so the frame loop can poll for completion
+// instead of blocking on it.
+class TaskGroup {
+public:
+    bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+    int getPending() const { return m_pending.load(std::memory_order_acquire); }
+    int getFailed() const { return m_failed.load(std::memory_order_acquire); }
+
+private:
+    template<typename T>
+    friend void spawn(Task<T> task, TaskGroup* group);
+
+    std::atomic<int> m_pending{0};
+    std::atomic<int> m_failed{0};
+};
+
+namespace detail {
+
+// Self-destroying coroutine used as the root of a spawned task chain
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+template<typename T>
+void spawn(Task<T> task, TaskGroup* group) {
+    if (group) {
+        group->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [](Task<T> task, TaskGroup* group) -> detail::DetachedTask {
+        try {
+            co_await std::move(task);
+        } catch (...) {
+            if (group) group->m_failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (group) group->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    }(std::move(task), group);
+}
+
+// co_await resumeOn(jobs) continues the coroutine inside a job on a worker
+inline auto resumeOn(JobSystem& jobs) {
+    struct Awaiter {
+        JobSystem& jobs;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            jobs.run([handle]() { handle.resume(); });
+        }
+        void await_resume() noexcept {}
+    };
+    return Awaiter{ jobs };
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Latest-value handoff between one producer and one consumer thread. The
+// producer fills its private buffer and publishes it by swapping it with
+// the shared middle slot; the consumer swaps the middle slot into its own
+// private buffer when something new was published. Neither side ever
+// waits for the other: a producer running ahead overwrites snapshots the
+// consumer never saw, and a consumer running ahead keeps the last one.
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T& initial) : m_buffers{ initial, initial, initial } {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer thread only. Buffers are recycled, so the contents are
+    // those of an older snapshot, not the last published one.
+    T& getWriteBuffer() { return m_buffers[m_write]; }
+
+    void publish() {
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_write | kFresh), std::memory_order_acq_rel);
+        m_write = previous & kIndexMask;
+    }
+
+    // Consumer thread only. Returns true if a snapshot was published since
+    // the last call; getReadBuffer() is the newest either way.
+    bool acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & kFresh)) {
+            return false;
+        }
+        uint8_t previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = previous & kIndexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const { return m_buffers[m_read]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 3;
+    static constexpr uint8_t kFresh = 4;
+
+    T m_buffers[3]{};
+    alignas(64) uint8_t m_write = 0;
+    alignas(64) std::atomic<uint8_t> m_middle{ 1 };
+    alignas(64) uint8_t m_read = 2;
+};
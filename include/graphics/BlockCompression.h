@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "graphics/TextureData.h"
+
+class JobSystem;
+
+// 4x4 block-compressed formats supported by the CPU encoder
+enum class BlockFormat : uint32_t {
+    BC1 = 1,  // RGB, 4 bpp
+    BC3 = 3,  // RGBA (BC1 colour + BC4 alpha), 8 bpp
+    BC4 = 4,  // R, 4 bpp
+    BC5 = 5   // RG (two BC4 blocks), 8 bpp
+};
+
+size_t getBlockBytes(BlockFormat format);
+size_t getCompressedSize(BlockFormat format, int width, int height);
+
+// Encode one RGBA8 level. Block rows are spread across the job system
+// when one is given. Edge blocks replicate the last row/column.
+void compressLevel(const TextureLevel& level, BlockFormat format, std::vector<uint8_t>& out,
+                   JobSystem* jobs = nullptr);
+
+// Decode back to RGBA8, for quality measurement and CPU fallbacks
+void decompressLevel(BlockFormat format, const uint8_t* data, int width, int height, TextureLevel& out);
+
+// Peak signal-to-noise ratio in dB over the first channelCount channels
+double computePsnr(const TextureLevel& reference, const TextureLevel& test, int channelCount);
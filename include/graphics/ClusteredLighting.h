@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <glad/glad.h>
+#include "scene/LightClusters.h"
+
+class ShaderProgram;
+
+// GPU side of clustered forward lighting. Lights, cluster cells and light
+// indices live in three buffer textures (GL 3.1+, so no SSBOs are needed
+// on 4.1) that are respecified every frame. Fragment shaders paste
+// getShaderSource() after their #version line and call
+// evaluateClusteredLights(), which walks only the lights of the fragment's
+// cluster.
+class ClusteredLighting {
+public:
+    ClusteredLighting();
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    // Upload this frame's lights and the grid built from them
+    void upload(const LightClusterGrid& grid, const PointLight* lights, size_t lightCount);
+
+    // Bind the buffer textures to units firstUnit..firstUnit+2 and set the
+    // lookup uniforms; shader must be bound
+    void bind(ShaderProgram& shader, int viewportWidth, int viewportHeight, int firstUnit = 0) const;
+
+    // GLSL 4.10 declarations and evaluateClusteredLights(worldPosition,
+    // normal, albedo, viewDepth), where viewDepth is the positive distance
+    // along the view axis
+    static const char* getShaderSource();
+
+private:
+    enum { Lights, Cells, Indices, BufferCount };
+
+    GLuint m_buffers[BufferCount];
+    GLuint m_textures[BufferCount];
+    int m_tilesX;
+    int m_tilesY;
+    int m_slices;
+    float m_depthScale;
+    float m_depthBias;
+};
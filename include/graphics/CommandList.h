@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "core/LinearAllocator.h"
+
+class JobSystem;
+
+// Compact, API-agnostic draw description. Worker threads fill these without
+// touching GL; only CommandQueue::execute() turns them into GL calls.
+struct DrawCommand {
+    enum class Primitive : uint8_t { Triangles, Lines, Points };
+    enum class IndexType : uint8_t { None, UInt16, UInt32 };
+
+    uint64_t sortKey;
+    uint32_t program;        // GL program name
+    uint32_t vertexArray;    // GL VAO name
+    uint32_t first;          // First vertex, or first index for indexed draws
+    uint32_t count;
+    uint32_t instanceCount;
+    int32_t baseVertex;
+    Primitive primitive;
+    IndexType indexType;
+
+    // Per-draw constants, copied into a uniform stream buffer at replay time
+    // and bound to uniform block binding CommandQueue::kDrawConstantsBinding
+    const void* constants;
+    uint32_t constantsSize;
+};
+
+// Sort keys put opaque draws first, then group by program and VAO to cut
+// state changes, and finally order by depth (front-to-back for opaque).
+// For translucent layers pass an inverted depth to get back-to-front.
+inline uint64_t makeSortKey(uint8_t layer, uint32_t program, uint32_t vertexArray, float depth01) {
+    if (depth01 < 0.0f) depth01 = 0.0f;
+    if (depth01 > 1.0f) depth01 = 1.0f;
+    uint64_t depthBits = static_cast<uint64_t>(depth01 * 0xFFFFFF);
+    return (static_cast<uint64_t>(layer) << 56) |
+           (static_cast<uint64_t>(program & 0xFFFF) << 40) |
+           (static_cast<uint64_t>(vertexArray & 0xFFFF) << 24) |
+           depthBits;
+}
+
+// Per-thread command recording buffer. Commands and their constant payloads
+// live in the list's own arena, so recording never takes a lock.
+class CommandList {
+public:
+    explicit CommandList(size_t arenaBlockSize = 256 * 1024);
+
+    CommandList(CommandList&&) = default;
+    CommandList& operator=(CommandList&&) = default;
+
+    void draw(const DrawCommand& command);
+
+    // Copy per-draw constants into the arena; use the result as
+    // DrawCommand::constants
+    const void* storeConstants(const void* data, size_t size);
+
+    // Sort by key; called on the recording thread once it is done
+    void sort();
+    void reset();
+
+    const std::vector<DrawCommand*>& getCommands() const { return m_commands; }
+    size_t size() const { return m_commands.size(); }
+
+private:
+    LinearAllocator m_arena;
+    std::vector<DrawCommand*> m_commands;
+};
+
+// The GL-free half of CommandQueue, usable without a context (benchmarks,
+// tools). Records [0, itemCount) in job-system chunks, each into the list
+// of the thread that runs it (lists.size() == jobs.getThreadCount()), then
+// sorts every list. Call from the thread that owns the JobSystem.
+using CommandRecordFunction = std::function<void(CommandList& list, size_t begin, size_t end)>;
+void recordCommandLists(JobSystem& jobs, std::vector<CommandList>& lists, size_t itemCount,
+                        const CommandRecordFunction& recordFunction);
+
+// K-way merge of sorted lists into one key-ordered sequence
+void mergeCommandLists(const std::vector<CommandList>& lists, std::vector<const DrawCommand*>& merged);
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "graphics/CommandList.h"
+
+class StreamBuffer;
+class JobSystem;
+
+// Collects one CommandList per recording thread and replays them on the
+// thread that owns the GL context in a single merged, key-sorted order.
+class CommandQueue {
+public:
+    static constexpr unsigned kDrawConstantsBinding = 0;
+
+    struct Stats {
+        size_t draws = 0;
+        size_t programChanges = 0;
+        size_t vertexArrayChanges = 0;
+        size_t constantBytes = 0;
+    };
+
+    // One list per job system thread
+    explicit CommandQueue(JobSystem& jobs);
+
+    size_t getWorkerCount() const { return m_lists.size(); }
+    CommandList& getList(size_t worker) { return m_lists[worker]; }
+
+    // Split [0, itemCount) into job-system chunks; each chunk is recorded
+    // into the list of the thread that runs it, and every list is sorted
+    // before the call returns. Call from the thread that owns the JobSystem.
+    using RecordFunction = CommandRecordFunction;
+    void record(size_t itemCount, const RecordFunction& recordFunction);
+
+    // GL thread only. Merges the sorted lists and issues the draws.
+    // constantBuffer must be a GL_UNIFORM_BUFFER stream buffer if any
+    // command carries constants; all of them are written with one map, so
+    // its region must hold the queue's constants at UBO offset alignment.
+    Stats execute(StreamBuffer* constantBuffer = nullptr);
+
+    // Clear all lists for the next frame
+    void reset();
+
+private:
+    JobSystem& m_jobs;
+    std::vector<CommandList> m_lists;
+    std::vector<const DrawCommand*> m_merged;
+    std::vector<size_t> m_constantOffsets;   // Per merged command, in the frame's constant block
+};
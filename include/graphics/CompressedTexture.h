@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <glad/glad.h>
+#include "core/MappedFile.h"
+#include "core/Task.h"
+#include "graphics/BlockCompression.h"
+
+class GLExecutor;
+
+// Cooked block-compressed texture file (.llrtex):
+//
+//   CompressedTextureHeader
+//   CompressedTextureLevel[levelCount]
+//   level blobs, each on a 16-byte boundary, ready for glCompressedTexImage2D
+constexpr char kCompressedTextureMagic[4] = { 'L', 'L', 'R', 'T' };
+constexpr uint32_t kCompressedTextureVersion = 1;
+
+struct CompressedTextureHeader {
+    char magic[4];
+    uint32_t version;
+    BlockFormat format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint32_t srgb;
+    uint32_t reserved;
+    uint64_t cacheKey;
+};
+
+struct CompressedTextureLevel {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;
+    uint64_t size;
+};
+
+static_assert(sizeof(CompressedTextureHeader) == 40, "CompressedTextureHeader layout changed; bump the version");
+static_assert(sizeof(CompressedTextureLevel) == 24, "CompressedTextureLevel layout changed; bump the version");
+
+struct CompressedTextureOptions {
+    BlockFormat format = BlockFormat::BC1;
+    bool srgb = true;
+    MipFilter filter = MipFilter::Box;
+};
+
+// Key over the source bytes, the options and the format version, so any
+// change to one of them produces a new cache entry
+uint64_t computeTextureCacheKey(const uint8_t* source, size_t size, const CompressedTextureOptions& options);
+
+// Decode, build mips and encode every level, then write a .llrtex file.
+// Concurrent cooks of the same output are safe: each writes its own
+// temporary file and renames it into place.
+bool cookCompressedTexture(const uint8_t* source, size_t size, const CompressedTextureOptions& options,
+                           const std::string& outputPath, JobSystem* jobs = nullptr);
+
+// Memory-mapped .llrtex
+class CompressedTextureFile {
+public:
+    bool open(const std::string& path);
+
+    const CompressedTextureHeader& getHeader() const { return *m_header; }
+    const CompressedTextureLevel& getLevel(int level) const { return m_levels[level]; }
+    const uint8_t* getLevelData(int level) const { return m_file.data() + m_levels[level].offset; }
+
+private:
+    MappedFile m_file;
+    const CompressedTextureHeader* m_header = nullptr;
+    const CompressedTextureLevel* m_levels = nullptr;
+};
+
+class CompressedTexture {
+public:
+    // Uploads levels [firstLevel, levelCount) straight from the mapping;
+    // firstLevel becomes level 0 of the texture object. Without S3TC
+    // support BC1/BC3 levels are decoded and uploaded as RGBA8 instead.
+    explicit CompressedTexture(const CompressedTextureFile& file, int firstLevel = 0);
+    ~CompressedTexture();
+
+    CompressedTexture(const CompressedTexture&) = delete;
+    CompressedTexture& operator=(const CompressedTexture&) = delete;
+
+    void bind(int unit = 0) const;
+
+    GLuint getId() const { return m_id; }
+    size_t getByteSize() const { return m_byteSize; }
+    // What the same texture would occupy as RGBA8, for VRAM accounting
+    size_t getUncompressedByteSize() const { return m_uncompressedByteSize; }
+
+private:
+    GLuint m_id;
+    size_t m_byteSize;
+    size_t m_uncompressedByteSize;
+};
+
+GLenum getBlockFormatGLInternalFormat(BlockFormat format, bool srgb);
+
+// Load through the on-disk cache: on a hit the cooked file is mapped and
+// uploaded directly; on a miss it is cooked on the workers first.
+Task<std::unique_ptr<CompressedTexture>> loadCompressedTexture(JobSystem& jobs, GLExecutor& gl, std::string path,
+                                                               std::string cacheDirectory,
+                                                               CompressedTextureOptions options = {});
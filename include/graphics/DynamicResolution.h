@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class GpuProfiler;
+
+struct DynamicResolutionSettings {
+    double targetMilliseconds = 16.0;   // GPU time per frame to stay under
+    float minScale = 0.5f;              // Of the output size, per axis
+    float maxScale = 1.0f;
+    // Hysteresis: scale down above the target, up only below this fraction
+    // of it; in between the scale holds
+    double upscaleThreshold = 0.85;
+    double smoothing = 0.25;            // Weight of each new sample
+    // Samples ignored after a change. GPU times arrive a few frames late,
+    // so the first ones after a change still measure the old scale.
+    int settleSamples = 8;
+    float maxIncrease = 1.1f;           // Largest step up per decision
+    float maxDecrease = 0.75f;          // Largest step down per decision
+    bool logDecisions = true;           // Print each change to stdout
+};
+
+struct DynamicResolutionStats {
+    uint64_t samples = 0;
+    uint64_t changes = 0;
+    float minScale = 1.0f;              // Lowest scale used so far
+    double averageScale = 0.0;          // Over the samples
+};
+
+// Picks the render scale from measured GPU frame time. GPU cost is taken
+// to grow with the pixel count, so a decision aims the smoothed frame time
+// at the middle of the hysteresis band by scaling each axis by the square
+// root of the ratio. Steps are limited and followed by a settling period,
+// and tiny corrections are skipped, so the scale does not oscillate.
+//
+// Feed it once per frame from the GL thread after GpuProfiler::endFrame().
+class DynamicResolution {
+public:
+    explicit DynamicResolution(DynamicResolutionSettings settings = {});
+
+    // Consumes the profiler's latest frame time, if a new one arrived.
+    // Returns true when the scale changed.
+    bool update(const GpuProfiler& gpuProfiler);
+
+    // Of the output size, per axis
+    float getScale() const { return m_scale; }
+
+    double getSmoothedMilliseconds() const { return m_smoothedMilliseconds; }
+    DynamicResolutionStats getStats() const;
+
+private:
+    DynamicResolutionSettings m_settings;
+    float m_scale;
+    double m_smoothedMilliseconds;
+    uint64_t m_lastCollectedFrame;
+    int m_settling;             // Samples left to ignore
+    bool m_seeded;              // Smoothed time holds a sample at the current scale
+    DynamicResolutionStats m_stats;
+    double m_scaleSum;
+
+    bool addSample(double milliseconds);
+};
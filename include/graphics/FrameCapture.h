@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include "core/JobSystem.h"
+
+// Pixels of one captured frame, rows top-down, RGBA8. rgba is empty (and
+// the size 0) when the readback failed.
+struct CapturedFrame {
+    uint64_t frameIndex = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgba;
+
+    bool isValid() const { return !rgba.empty(); }
+};
+
+struct FrameCaptureStats {
+    uint64_t captured = 0;
+    uint64_t dropped = 0;        // Every slot was still in flight
+    uint64_t delivered = 0;      // Handed to a consumer
+    uint64_t failed = 0;         // Buffer could not be mapped; consumer got an empty frame
+};
+
+// Asynchronous framebuffer readback. capture() issues glReadPixels into
+// one slot of a pixel-buffer-object ring and fences it, which returns
+// immediately; update() polls the fences without waiting, maps finished
+// slots, copies them out (flipping to top-down rows) and runs the consumer
+// on a worker. With enough slots to cover the GPU latency, continuous
+// capture never stalls the pipeline; when every slot is still busy the
+// frame is dropped rather than waited for.
+//
+// Every accepted frame reaches its consumer, failed readbacks included,
+// so consumers that count or order frames never wait on a lost one.
+// Consumers run concurrently and may finish out of order; those that
+// stream need to reorder by frameIndex. capture(), update() and flush()
+// are GL thread only.
+class FrameCapture {
+public:
+    using Consumer = std::function<void(CapturedFrame&)>;
+
+    FrameCapture(JobSystem& jobs, int width, int height, int slotCount = 3);
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Read the color attachment of framebuffer (0 = default) at the
+    // capture size. Returns false if the frame was dropped.
+    bool capture(GLuint framebuffer, uint64_t frameIndex, Consumer consumer);
+
+    // Once per frame: hand completed readbacks to workers
+    void update();
+
+    // Wait for every readback and consumer, e.g. before exit
+    void flush();
+
+    // Consumer that encodes <prefix><frame>.png with stb_image_write
+    static Consumer writePng(std::string prefix);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    const FrameCaptureStats& getStats() const { return m_stats; }
+
+private:
+    struct Slot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        uint64_t frameIndex = 0;
+        uint64_t sequence = 0;
+        Consumer consumer;
+    };
+
+    JobSystem& m_jobs;
+    JobCounter m_consumers;
+    int m_width;
+    int m_height;
+    size_t m_frameBytes;
+    std::vector<Slot> m_slots;
+    uint64_t m_sequence;
+    FrameCaptureStats m_stats;
+
+    // Recycled pixel storage; workers return frames here
+    std::mutex m_poolMutex;
+    std::vector<std::unique_ptr<CapturedFrame>> m_pool;
+
+    void deliver(Slot& slot);
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <glad/glad.h>
+
+// Offscreen render target: an RGBA8 color texture plus a 24-bit depth
+// renderbuffer. Used as the back buffer in headless mode and anywhere a
+// scene is rendered at a resolution other than the window's.
+class Framebuffer {
+public:
+    // Throws std::runtime_error if the driver reports it incomplete
+    Framebuffer(int width, int height);
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    // Bind for drawing and set the viewport to cover it
+    void bind() const;
+    static void bindDefault(int width, int height);
+
+    GLuint getId() const { return m_id; }
+    GLuint getColorTexture() const { return m_colorTexture; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+private:
+    GLuint m_id;
+    GLuint m_colorTexture;
+    GLuint m_depthBuffer;
+    int m_width;
+    int m_height;
+};
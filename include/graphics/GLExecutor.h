@@ -0,0 +1,36 @@
+#pragma once
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// Queue of work that must run on the thread owning the GL context. Other
+// threads post() to it (or co_await schedule() from a Task); the frame loop
+// drains it with runPending(), bounded by a time budget so uploads never
+// stretch a frame.
+class GLExecutor {
+public:
+    void post(std::function<void()> work);
+
+    // co_await executor.schedule() continues the coroutine on the GL thread
+    auto schedule() {
+        struct Awaiter {
+            GLExecutor& executor;
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                executor.post([handle]() { handle.resume(); });
+            }
+            void await_resume() noexcept {}
+        };
+        return Awaiter{ *this };
+    }
+
+    // GL thread only. Returns the number of work items run.
+    size_t runPending(double budgetMilliseconds = 2.0);
+
+    size_t getQueuedCount();
+
+private:
+    std::mutex m_mutex;
+    std::deque<std::function<void()>> m_queue;
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include "core/Profiler.h"
+
+// GPU spans measured with glQueryCounter(GL_TIMESTAMP) pairs, which nest
+// (GL_TIME_ELAPSED queries cannot). Each frame's queries are read back
+// latencyFrames frames later, and only once they are available, so the
+// CPU never waits on the GPU; a frame still in flight when its slot comes
+// round again is dropped. Results go to Profiler's GPU track, shifted onto
+// the CPU clock. Use from the GL thread only.
+class GpuProfiler {
+public:
+    explicit GpuProfiler(int latencyFrames = 4, size_t maxScopesPerFrame = 256);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // Collects the oldest frame, then opens a "GPU Frame" scope
+    void beginFrame();
+    void endFrame();
+
+    // Scopes past maxScopesPerFrame are ignored
+    void push(const char* name);
+    void pop();
+
+    // When disabled no queries are issued
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+
+    // GPU duration of the most recently collected frame
+    double getLastFrameMilliseconds() const { return m_lastFrameMilliseconds; }
+    // Frames collected so far; a change means a new getLastFrameMilliseconds()
+    uint64_t getCollectedFrameCount() const { return m_collectedFrames; }
+    size_t getDroppedFrameCount() const { return m_droppedFrames; }
+
+private:
+    struct Scope {
+        const char* name;
+        uint32_t startQuery;
+        uint32_t endQuery;
+    };
+
+    struct Frame {
+        std::vector<GLuint> queries;
+        std::vector<Scope> scopes;
+        uint32_t queryCount = 0;
+        int64_t clockOffset = 0;   // CPU minus GPU nanoseconds
+        bool pending = false;
+    };
+
+    std::vector<Frame> m_frames;
+    size_t m_maxScopes;
+    int m_current;
+    bool m_enabled;
+    bool m_inFrame;
+    std::vector<int> m_stack;      // Scope indices; -1 for ignored scopes
+    double m_lastFrameMilliseconds;
+    uint64_t m_collectedFrames;
+    size_t m_droppedFrames;
+
+    void collect(Frame& frame);
+};
+
+class GpuProfileScope {
+public:
+    GpuProfileScope(GpuProfiler& profiler, const char* name) : m_profiler(profiler) { m_profiler.push(name); }
+    ~GpuProfileScope() { m_profiler.pop(); }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    GpuProfiler& m_profiler;
+};
+
+#if LLR_ENABLE_PROFILER
+#define LLR_PROFILE_GPU(profiler, name) GpuProfileScope LLR_PROFILE_CONCAT(llrGpuProfileScope, __LINE__)(profiler, name)
+#else
+#define LLR_PROFILE_GPU(profiler, name) ((void)0)
+#endif
@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <glad/glad.h>
+
+enum class GpuResourceType : uint8_t {
+    Buffer,
+    Texture,
+    VertexArray,
+    Program,
+    Count
+};
+
+// Index into the manager's slots plus the generation the slot had when the
+// handle was made. Destroying a resource bumps the generation, so stale
+// copies of the handle resolve to 0 instead of to whatever reuses the slot.
+template<GpuResourceType Type>
+struct GpuHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;        // 0 = null handle
+
+    explicit operator bool() const { return generation != 0; }
+    bool operator==(const GpuHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const GpuHandle& other) const { return !(*this == other); }
+};
+
+using BufferHandle = GpuHandle<GpuResourceType::Buffer>;
+using TextureHandle = GpuHandle<GpuResourceType::Texture>;
+using VertexArrayHandle = GpuHandle<GpuResourceType::VertexArray>;
+using ProgramHandle = GpuHandle<GpuResourceType::Program>;
+
+struct GpuResourceStats {
+    static constexpr size_t kTypeCount = static_cast<size_t>(GpuResourceType::Count);
+
+    size_t liveCount[kTypeCount] = {};
+    size_t liveBytes[kTypeCount] = {};
+    size_t pendingCount = 0;        // Destroyed, waiting for their frame to retire
+    size_t pendingBytes = 0;
+    uint64_t deletedCount = 0;      // GL objects actually deleted so far
+
+    size_t getLiveCount(GpuResourceType type) const { return liveCount[static_cast<size_t>(type)]; }
+    size_t getLiveBytes(GpuResourceType type) const { return liveBytes[static_cast<size_t>(type)]; }
+};
+
+// Owns GL objects behind generational handles and tracks their memory.
+// destroy() invalidates the handle at once but only queues the GL object:
+// endFrame() fences each frame, and objects destroyed during a frame are
+// deleted, batched per type, once that frame's fence has signalled. The
+// GPU may still be reading a resource from commands already submitted, so
+// deleting it right away can stall or force the driver to defer anyway.
+//
+// GL thread only. Byte counts are what the manager allocated or was told;
+// drivers add padding and mip tails of their own.
+class GpuResourceManager {
+public:
+    GpuResourceManager() = default;
+    // Waits for outstanding frames and deletes everything, live or not
+    ~GpuResourceManager();
+
+    GpuResourceManager(const GpuResourceManager&) = delete;
+    GpuResourceManager& operator=(const GpuResourceManager&) = delete;
+
+    // Buffers are created through GL_COPY_WRITE_BUFFER so no VAO or other
+    // binding is disturbed; they can be bound to any target afterwards
+    BufferHandle createBuffer(size_t bytes, const void* data, GLenum usage);
+    // Reallocate storage and update the byte count
+    void setBufferData(BufferHandle handle, size_t bytes, const void* data, GLenum usage);
+
+    // Uncompressed formats only; adopt anything else with its size
+    TextureHandle createTexture2D(int width, int height, int levelCount, GLenum internalFormat);
+    VertexArrayHandle createVertexArray();
+
+    // Take ownership of an object created elsewhere
+    BufferHandle adoptBuffer(GLuint id, size_t bytes);
+    TextureHandle adoptTexture(GLuint id, size_t bytes);
+    ProgramHandle adoptProgram(GLuint id);
+
+    // 0 for null or stale handles
+    template<GpuResourceType Type>
+    GLuint get(GpuHandle<Type> handle) const {
+        const Slot* slot = findSlot(Type, handle.index, handle.generation);
+        return slot ? slot->id : 0;
+    }
+
+    template<GpuResourceType Type>
+    bool isAlive(GpuHandle<Type> handle) const {
+        return findSlot(Type, handle.index, handle.generation) != nullptr;
+    }
+
+    // Stale or null handles are ignored
+    template<GpuResourceType Type>
+    void destroy(GpuHandle<Type> handle) {
+        destroySlot(Type, handle.index, handle.generation);
+    }
+
+    // After the frame's last GL command (typically after the swap): fence
+    // it and delete whatever earlier frames retired. Never blocks.
+    void endFrame();
+
+    // Wait for every frame in flight and delete all pending objects, e.g.
+    // before tearing down a context
+    void flush();
+
+    GpuResourceStats getStats() const;
+
+    // Bytes createTexture2D accounts for; 0 for formats it cannot create
+    static size_t getTextureBytes(int width, int height, int levelCount, GLenum internalFormat);
+
+private:
+    struct Slot {
+        GLuint id = 0;
+        uint32_t generation = 1;
+        size_t bytes = 0;
+        bool live = false;
+    };
+
+    struct Pool {
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeList;
+        size_t liveCount = 0;
+        size_t liveBytes = 0;
+    };
+
+    struct PendingDelete {
+        GpuResourceType type;
+        GLuint id;
+        size_t bytes;
+        uint64_t frame;
+    };
+
+    struct FrameFence {
+        GLsync fence;
+        uint64_t frame;
+    };
+
+    Pool m_pools[GpuResourceStats::kTypeCount];
+    std::deque<PendingDelete> m_pending;
+    std::deque<FrameFence> m_fences;
+    uint64_t m_frame = 1;           // Frame being recorded
+    uint64_t m_retiredFrame = 0;    // Newest frame the GPU has finished
+    size_t m_pendingBytes = 0;
+    uint64_t m_deletedCount = 0;
+
+    const Slot* findSlot(GpuResourceType type, uint32_t index, uint32_t generation) const;
+    Slot* findSlot(GpuResourceType type, uint32_t index, uint32_t generation);
+    uint32_t allocateSlot(GpuResourceType type, GLuint id, size_t bytes);
+    void destroySlot(GpuResourceType type, uint32_t index, uint32_t generation);
+    void deleteRetired();
+    static void deleteObjects(GpuResourceType type, std::vector<GLuint>& ids);
+};
@@ -0,0 +1,170 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+#include <glad/glad.h>
+#include "graphics/GpuResourceManager.h"
+
+class GpuProfiler;
+
+struct RenderGraphTextureDesc {
+    int width = 0;
+    int height = 0;
+    GLenum internalFormat = GL_RGBA8;
+
+    bool operator<(const RenderGraphTextureDesc& other) const {
+        if (width != other.width) return width < other.width;
+        if (height != other.height) return height < other.height;
+        return internalFormat < other.internalFormat;
+    }
+    bool operator==(const RenderGraphTextureDesc& other) const {
+        return width == other.width && height == other.height && internalFormat == other.internalFormat;
+    }
+};
+
+// Texture declared in the current frame's graph
+struct RenderGraphTexture {
+    uint32_t index = UINT32_MAX;
+
+    bool isValid() const { return index != UINT32_MAX; }
+};
+
+// What a pass does with an attachment's previous contents
+enum class RenderGraphLoad {
+    Keep,       // Draw on top; depends on the pass that wrote it before
+    Clear,      // Color 0, depth 1
+    DontCare    // Every pixel is overwritten
+};
+
+struct RenderGraphStats {
+    size_t passCount = 0;
+    size_t culledPassCount = 0;
+    size_t transientTextureCount = 0;
+    size_t physicalTextureCount = 0;    // Distinct GL textures behind the transients
+    size_t transientBytes = 0;          // Had every transient its own texture
+    size_t physicalBytes = 0;
+    size_t getBytesSavedByAliasing() const { return transientBytes - physicalBytes; }
+    double compileMilliseconds = 0.0;
+};
+
+// Per-frame graph of render passes. Passes declare the textures they read
+// and write; compile() drops passes whose output nothing uses, orders the
+// rest by their dependencies and places transient textures on pooled GL
+// textures, reusing one texture for several transients whose lifetimes do
+// not overlap. execute() then binds each pass's attachments, sets the
+// viewport to their size and runs it; a pass may narrow the viewport.
+//
+// A transient starts every frame with undefined contents: its first writer
+// should Clear or DontCare. Passes without attachments bind their own
+// target (e.g. the default framebuffer) and must be marked as side effects
+// to survive culling. Pooled textures left unused for a few frames are
+// released through the resource manager.
+//
+// Build, compile and execute on the GL thread; reset() starts a new frame.
+class RenderGraph {
+public:
+    class PassContext {
+    public:
+        // GL texture behind a graph texture this frame
+        GLuint getTexture(RenderGraphTexture texture) const;
+        const RenderGraphTextureDesc& getDesc(RenderGraphTexture texture) const;
+
+    private:
+        friend class RenderGraph;
+        explicit PassContext(const RenderGraph& graph) : m_graph(graph) {}
+        const RenderGraph& m_graph;
+    };
+
+    using ExecuteFunction = std::function<void(const PassContext&)>;
+
+    class PassBuilder {
+    public:
+        PassBuilder& read(RenderGraphTexture texture);
+        PassBuilder& writeColor(RenderGraphTexture texture, RenderGraphLoad load = RenderGraphLoad::Keep);
+        PassBuilder& writeDepth(RenderGraphTexture texture, RenderGraphLoad load = RenderGraphLoad::Keep);
+        // Never culled
+        PassBuilder& setSideEffect();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+        RenderGraph& m_graph;
+        uint32_t m_pass;
+    };
+
+    explicit RenderGraph(GpuResourceManager& resources);
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // Drop this frame's passes and textures; the texture pool stays
+    void reset();
+
+    // Names must outlive the frame; string literals are expected
+    RenderGraphTexture createTexture(const char* name, const RenderGraphTextureDesc& desc);
+    // External texture; never aliased, and writing it keeps a pass alive
+    RenderGraphTexture importTexture(const char* name, GLuint texture, const RenderGraphTextureDesc& desc);
+    PassBuilder addPass(const char* name, ExecuteFunction execute);
+
+    // Throws std::runtime_error on a dependency cycle
+    void compile();
+    // Compiles first if needed. GPU scopes per pass when a profiler is given.
+    void execute(GpuProfiler* gpuProfiler = nullptr);
+
+    const RenderGraphStats& getStats() const { return m_stats; }
+    // Live passes in execution order, after compile()
+    std::vector<const char*> getExecutionOrder() const;
+
+private:
+    struct Access {
+        uint32_t texture;
+        RenderGraphLoad load;
+    };
+
+    struct Pass {
+        const char* name;
+        ExecuteFunction execute;
+        std::vector<uint32_t> reads;
+        std::vector<Access> colorWrites;
+        bool hasDepth = false;
+        Access depthWrite{};
+        bool sideEffect = false;
+    };
+
+    struct Texture {
+        const char* name;
+        RenderGraphTextureDesc desc;
+        GLuint imported = 0;        // 0 for transients
+        int physical = -1;          // Index into m_pool this frame
+        int firstUse = -1;          // Positions in m_order
+        int lastUse = -1;
+    };
+
+    struct PooledTexture {
+        RenderGraphTextureDesc desc;
+        TextureHandle handle;
+        size_t bytes = 0;
+        uint64_t lastUsedFrame = 0;
+        int busyUntil = -1;         // Last position in m_order using it this frame
+    };
+
+    GpuResourceManager& m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<Texture> m_textures;
+    std::vector<uint32_t> m_order;  // Live passes, execution order
+    std::vector<PooledTexture> m_pool;
+    std::map<std::vector<GLuint>, GLuint> m_framebuffers;   // Attachments -> FBO
+    uint64_t m_frame;
+    bool m_compiled;
+    RenderGraphStats m_stats;
+
+    GLuint getGLTexture(uint32_t texture) const;
+    void cull(std::vector<bool>& live) const;
+    void sortPasses(const std::vector<bool>& live);
+    void allocateTextures();
+    void releaseUnusedTextures();
+    GLuint getFramebuffer(const Pass& pass);
+};
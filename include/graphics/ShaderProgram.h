@@ -4,10 +4,14 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "graphics/GpuResourceManager.h"
 
 class ShaderProgram {
 public:
     ShaderProgram();
+    // Linked programs are owned by the manager: they show up in its stats
+    // and are deleted through its fenced queue
+    explicit ShaderProgram(GpuResourceManager& resources);
     ~ShaderProgram();
     
     bool compile(const std::string& vertexSource, const std::string& fragmentSource);
@@ -25,12 +29,17 @@ public:
     void setUniform(const std::string& name, const glm::mat4& value);
     
     GLuint getId() const { return m_id; }
+    // Null unless constructed with a GpuResourceManager
+    ProgramHandle getHandle() const { return m_handle; }
     
 private:
     GLuint m_id;
+    GpuResourceManager* m_resources;
+    ProgramHandle m_handle;
     std::unordered_map<std::string, GLint> m_uniformLocations;
     
     GLint getUniformLocation(const std::string& name);
     bool compileShader(GLuint& shader, GLenum type, const std::string& source);
     std::string loadShaderFile(const std::string& path);
+    void destroyProgram();
 }; 
\ No newline at end of file
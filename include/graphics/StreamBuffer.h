@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+
+// Ring of N frame regions inside one GL buffer object, used for data that is
+// rewritten every frame (particles, UI vertices, per-draw constants).
+// Each region is fenced when the frame ends; the CPU only waits if it laps
+// the GPU, so writes never trigger implicit driver synchronization.
+class StreamBuffer {
+public:
+    enum class Mode {
+        Fenced,   // glMapBufferRange unsynchronized + per-region glFenceSync
+        Orphaned  // glBufferData(nullptr) respecification at the first write after the ring wraps
+    };
+
+    struct Allocation {
+        void* data;       // Write-only pointer, valid until unmap()
+        GLintptr offset;  // Byte offset inside the buffer, for draws/binds
+        GLsizeiptr size;
+    };
+
+    StreamBuffer(GLenum target, size_t regionSize, int regionCount = 3, Mode mode = Mode::Fenced);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Reserve and map size bytes in the current frame region. Only one
+    // allocation may be mapped at a time. Alignment 0 is the target's
+    // default: GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT for uniform buffers, so
+    // the offset can go straight to glBindBufferRange, 16 otherwise. A
+    // size of 0 maps nothing and returns a null, empty allocation.
+    Allocation map(size_t size, size_t alignment = 0);
+    void unmap();
+
+    // Copy helper for the common map/memcpy/unmap case
+    Allocation write(const void* data, size_t size, size_t alignment = 0);
+
+    // Fence the current region and move on to the next one. Call once per
+    // frame after the draws that consume this frame's data were issued.
+    void endFrame();
+
+    void bind() const;
+    void bindRange(GLenum target, GLuint index, const Allocation& allocation) const;
+
+    GLuint getId() const { return m_id; }
+    GLenum getTarget() const { return m_target; }
+    size_t getRegionSize() const { return m_regionSize; }
+    size_t getRegionUsed() const { return m_regionUsed; }
+    Mode getMode() const { return m_mode; }
+
+    // Number of times map() had to block on a region fence
+    size_t getStallCount() const { return m_stallCount; }
+
+private:
+    GLuint m_id;
+    GLenum m_target;
+    Mode m_mode;
+    size_t m_regionSize;
+    int m_regionCount;
+    int m_region;
+    size_t m_regionUsed;
+    size_t m_defaultAlignment;
+    bool m_mapped;
+    bool m_orphanPending;       // Orphaned mode: wrapped since the last orphan
+    size_t m_stallCount;
+
+    std::vector<GLsync> m_fences;
+
+    void waitForRegion(int region);
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <glad/glad.h>
+#include "core/Task.h"
+#include "graphics/TextureData.h"
+
+class GLExecutor;
+
+// Immutable-format 2D RGBA8 texture. Storage for all levels is allocated up
+// front (glTexStorage2D where the context has it, level-by-level
+// glTexImage2D on 4.1) and filled with uploadLevel().
+class Texture {
+public:
+    Texture(int width, int height, int levelCount, bool srgb);
+    // Allocates and uploads every level of data
+    explicit Texture(const TextureData& data);
+    ~Texture();
+
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    void uploadLevel(int level, const TextureLevel& data);
+
+    void bind(int unit = 0) const;
+
+    GLuint getId() const { return m_id; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getLevelCount() const { return m_levelCount; }
+
+private:
+    GLuint m_id;
+    int m_width;
+    int m_height;
+    int m_levelCount;
+};
+
+struct TextureLoadOptions {
+    bool srgb = true;
+    MipFilter filter = MipFilter::Box;
+    bool generateMips = true;
+};
+
+// Read and decode on a worker, build mips on the workers, then upload one
+// level per GL executor slot so large textures never stall a frame.
+// Throws std::runtime_error through the awaiting coroutine on failure.
+Task<std::unique_ptr<Texture>> loadTexture(JobSystem& jobs, GLExecutor& gl, std::string path,
+                                           TextureLoadOptions options = {});
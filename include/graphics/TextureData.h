@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// One RGBA8 mip level
+struct TextureLevel {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+// CPU-side texture: level 0 is the source image, followed by its mips
+struct TextureData {
+    std::vector<TextureLevel> levels;
+    bool srgb = true;
+
+    int getWidth() const { return levels.empty() ? 0 : levels[0].width; }
+    int getHeight() const { return levels.empty() ? 0 : levels[0].height; }
+};
+
+enum class MipFilter {
+    Box,     // 2x2 average; fast
+    Kaiser   // 6-tap Kaiser-windowed sinc; sharper, less aliasing
+};
+
+// Decode any stb_image format into a single RGBA8 level. Thread-safe.
+bool decodeImage(const uint8_t* data, size_t size, TextureData& texture);
+
+// Replace levels 1..N with a full mip chain built from level 0. Filtering
+// happens in linear light when texture.srgb is set. Rows of each level are
+// split across the job system when one is given.
+void generateMipChain(TextureData& texture, MipFilter filter = MipFilter::Box, JobSystem* jobs = nullptr);
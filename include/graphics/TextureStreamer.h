@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/JobSystem.h"
+#include "graphics/CompressedTexture.h"
+
+struct TextureStreamerSettings {
+    size_t budgetBytes = 256ull * 1024 * 1024;
+    // Upload limits per update(), covering both streamed-in levels and the
+    // re-upload an eviction does. The first upload of a frame always goes
+    // through so a single large level cannot starve forever.
+    size_t maxUploadBytesPerFrame = 8ull * 1024 * 1024;
+    double maxUploadMillisecondsPerFrame = 2.0;
+    int maxLoadsInFlight = 8;
+    // Levels at or below this size are always resident
+    int tailSize = 64;
+    // Textures not requested for this many frames fall back to the tail
+    uint32_t idleFrames = 120;
+    float lodBias = 0.0f;
+};
+
+struct TextureStreamerStats {
+    size_t residentBytes = 0;
+    size_t wantedBytes = 0;        // What the requested mips would need, before budgeting
+    int loadsInFlight = 0;         // Worker jobs still running, cancelled ones included
+    int uploadsThisFrame = 0;
+    size_t uploadedBytesThisFrame = 0;
+    uint64_t cancelledLoads = 0;
+    uint64_t evictions = 0;
+};
+
+using StreamedTextureHandle = uint32_t;
+constexpr StreamedTextureHandle kInvalidStreamedTexture = 0xFFFFFFFFu;
+
+// Streams cooked .llrtex textures at the mip level they are actually seen
+// at. The culling pass reports how large each texture appears on screen;
+// update() turns that into a target level per texture, trims targets of
+// the least recently needed textures until the total fits the budget,
+// pages the missing levels in on workers and uploads them within the
+// per-frame limits.
+//
+// A texture object only ever holds its resident levels, so lowering
+// residency really frees memory on 4.1 where there is no sparse storage.
+// Changing residency recreates the object from the mapping, so
+// getTextureId() may change between frames.
+//
+// All methods are GL thread only.
+class TextureStreamer {
+public:
+    explicit TextureStreamer(JobSystem& jobs, TextureStreamerSettings settings = {});
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Maps the file and uploads the tail levels immediately
+    StreamedTextureHandle add(const std::string& cookedPath);
+    void remove(StreamedTextureHandle handle);
+
+    // Report that the texture covers screenSize pixels along its larger
+    // axis this frame. Several requests per frame keep the largest.
+    void request(StreamedTextureHandle handle, float screenSize);
+
+    // Projected size in pixels of an object of worldSize at distance
+    static float computeScreenSize(float worldSize, float distance, float fovY, int viewportHeight);
+
+    // Once per frame: retarget, evict, issue loads and upload finished ones
+    void update();
+
+    void bind(StreamedTextureHandle handle, int unit = 0) const;
+    GLuint getTextureId(StreamedTextureHandle handle) const;
+    int getResidentLevel(StreamedTextureHandle handle) const;
+    int getTargetLevel(StreamedTextureHandle handle) const;
+
+    void setBudget(size_t bytes) { m_settings.budgetBytes = bytes; }
+    const TextureStreamerSettings& getSettings() const { return m_settings; }
+    const TextureStreamerStats& getStats() const { return m_stats; }
+
+private:
+    // Shared with the worker paging a load in
+    struct Load {
+        std::shared_ptr<const CompressedTextureFile> file;
+        int level = 0;
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> finished{false};    // Job returned, paged in or not
+    };
+
+    struct Entry {
+        std::shared_ptr<const CompressedTextureFile> file;
+        std::unique_ptr<CompressedTexture> texture;
+        int levelCount = 0;
+        int tailLevel = 0;
+        int residentLevel = 0;
+        int targetLevel = 0;
+        float requestedSize = 0.0f;    // Accumulated since the last update()
+        float lastSize = 0.0f;
+        uint32_t lastRequestFrame = 0;
+        std::shared_ptr<Load> load;
+        bool alive = false;
+    };
+
+    JobSystem& m_jobs;
+    TextureStreamerSettings m_settings;
+    TextureStreamerStats m_stats;
+    std::vector<Entry> m_entries;
+    std::vector<StreamedTextureHandle> m_freeHandles;
+    JobCounter m_loadCounter;
+    std::vector<std::shared_ptr<Load>> m_cancelledLoads;   // Jobs still running
+    std::chrono::steady_clock::time_point m_uploadStart;
+    uint32_t m_frame = 0;
+
+    size_t getBytesFrom(const Entry& entry, int level) const;
+    int computeWantedLevel(const Entry& entry) const;
+    void retarget();
+    void fitBudget();
+    void issueLoads();
+    void uploadReady();
+    bool canUpload(size_t bytes) const;
+    void retireCancelledLoads();
+    void setResidentLevel(Entry& entry, int level);
+    void cancelLoad(Entry& entry);
+};
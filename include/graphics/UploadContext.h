@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+
+class Window;
+struct GLFWwindow;
+
+// Handle for one piece of work done on the upload thread. The consumer
+// polls isComplete() from the render thread; once it returns true the
+// object is fully written and can be bound (bind it again after completion
+// so the render context observes the new contents).
+//
+// Release the last reference on a thread with a context of the share group
+// current: a ticket that never completed deletes its fence then. The object
+// itself belongs to whoever took it with getObject().
+class UploadTicket {
+public:
+    UploadTicket() = default;
+    ~UploadTicket();
+
+    UploadTicket(const UploadTicket&) = delete;
+    UploadTicket& operator=(const UploadTicket&) = delete;
+
+    bool isComplete();
+    GLuint getObject() const { return m_object; }
+    bool hasFailed() const { return m_failed.load(std::memory_order_acquire); }
+
+private:
+    friend class UploadContext;
+
+    std::atomic<bool> m_submitted{false};
+    std::atomic<bool> m_failed{false};
+    GLsync m_fence = nullptr;
+    GLuint m_object = 0;
+};
+
+// Dedicated thread that owns the window's hidden shared GL context and
+// performs buffer/texture creation and uploads off the render thread. Each
+// work item is followed by a fence, so the render thread never waits on
+// uploads implicitly.
+class UploadContext {
+public:
+    // Window must have been created with createUploadContext = true
+    explicit UploadContext(Window& window);
+    ~UploadContext();
+
+    UploadContext(const UploadContext&) = delete;
+    UploadContext& operator=(const UploadContext&) = delete;
+
+    // Run work on the upload thread; its return value becomes the ticket's
+    // object name. Work that throws fails the ticket and must not leave
+    // objects behind; the helpers below delete theirs.
+    std::shared_ptr<UploadTicket> submit(std::function<GLuint()> work);
+
+    std::shared_ptr<UploadTicket> createBuffer(GLenum target, std::vector<uint8_t> data, GLenum usage = GL_STATIC_DRAW);
+    // Uploads from memory the caller keeps alive until the ticket completes,
+    // e.g. a file mapping, without copying it first
+    std::shared_ptr<UploadTicket> createBuffer(GLenum target, const void* data, size_t size,
+                                               GLenum usage = GL_STATIC_DRAW);
+
+    // Allocates all mip levels when generateMipmaps is set
+    std::shared_ptr<UploadTicket> createTexture2D(int width, int height, GLenum internalFormat,
+                                                  GLenum format, GLenum type,
+                                                  std::vector<uint8_t> pixels, bool generateMipmaps = true);
+
+    // glTexSubImage2D into an existing texture
+    std::shared_ptr<UploadTicket> updateTexture2D(GLuint texture, int level, int x, int y,
+                                                  int width, int height, GLenum format, GLenum type,
+                                                  std::vector<uint8_t> pixels);
+
+    size_t getPendingCount();
+
+private:
+    struct Work {
+        std::function<GLuint()> function;
+        std::shared_ptr<UploadTicket> ticket;
+    };
+
+    GLFWwindow* m_context;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Work> m_queue;
+    bool m_running;
+
+    void threadLoop();
+};
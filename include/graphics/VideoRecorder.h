@@ -0,0 +1,88 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+#include "core/JobSystem.h"
+#include "graphics/FrameCapture.h"
+
+struct VideoRecorderSettings {
+    // File path, or "|command" to pipe the stream into a local process
+    // (e.g. "|ffmpeg -i - -c:v libx264 out.mp4")
+    std::string output;
+    int fpsNumerator = 60;
+    int fpsDenominator = 1;
+
+    // Frames read back or converted but not yet written
+    int maxQueuedFrames = 8;
+    enum class Backpressure {
+        Drop,   // Skip the frame; the stream gets shorter, render never waits
+        Block   // Stall the GL thread until the writer catches up
+    } backpressure = Backpressure::Drop;
+};
+
+struct VideoRecorderStats {
+    uint64_t recorded = 0;          // Accepted for readback
+    uint64_t droppedQueueFull = 0;
+    uint64_t droppedReadback = 0;   // Every readback slot was busy
+    uint64_t failedReadback = 0;    // Accepted, but the pixels could not be read
+    uint64_t written = 0;
+    uint64_t bytesWritten = 0;
+    double convertMilliseconds = 0.0;
+    double blockedMilliseconds = 0.0;
+};
+
+// Records the framebuffer as a YUV4MPEG2 (4:2:0, full range) stream.
+// Frames come off a FrameCapture readback ring, are converted to planar
+// YUV on workers and written in order by a dedicated writer thread, so
+// the GL thread only pays for queuing the readback. The queue between the
+// GL thread and the writer is bounded; what happens when it is full is the
+// Backpressure setting.
+class VideoRecorder {
+public:
+    // Throws std::runtime_error if the output cannot be opened
+    VideoRecorder(JobSystem& jobs, int width, int height, VideoRecorderSettings settings);
+    ~VideoRecorder();
+
+    VideoRecorder(const VideoRecorder&) = delete;
+    VideoRecorder& operator=(const VideoRecorder&) = delete;
+
+    // Once per frame on the GL thread, after the frame was drawn
+    void recordFrame(GLuint framebuffer);
+
+    // Drain everything queued and close the output
+    void finish();
+
+    // Snapshot; writer-side counters are read under the queue lock
+    VideoRecorderStats getStats();
+
+    // Full-range BT.601 RGBA to I420; odd sizes replicate the last
+    // row/column into the chroma average
+    static void convertToI420(const CapturedFrame& frame, uint8_t* out, JobSystem* jobs = nullptr);
+    static size_t getI420Size(int width, int height);
+
+private:
+    JobSystem& m_jobs;
+    VideoRecorderSettings m_settings;
+    FrameCapture m_capture;
+    FILE* m_output;
+    bool m_pipe;
+    uint64_t m_nextSequence;
+
+    std::mutex m_mutex;
+    std::condition_variable m_queueChanged;
+    std::map<uint64_t, std::vector<uint8_t>> m_converted;   // By sequence
+    std::vector<std::vector<uint8_t>> m_pool;
+    int m_queued;                                           // Accepted, not yet written
+    bool m_stopping;
+    VideoRecorderStats m_stats;
+    std::thread m_writer;
+
+    void writerLoop();
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// Point light as uploaded to the GPU: two RGBA32F texels
+struct PointLight {
+    float position[3];   // World space
+    float radius;        // Influence ends here
+    float color[3];
+    float intensity;
+};
+
+static_assert(sizeof(PointLight) == 32, "PointLight is uploaded as two vec4s");
+
+// Light list of one cluster: a range of LightClusterGrid::getIndices()
+struct LightClusterCell {
+    uint32_t offset;
+    uint32_t count;
+};
+
+struct LightClusterSettings {
+    int tilesX = 16;
+    int tilesY = 9;
+    int slices = 24;                  // Exponential in view depth
+    size_t maxLightIndices = 1 << 20; // Further references are dropped
+};
+
+struct LightClusterStats {
+    size_t lightsTested = 0;
+    size_t lightsVisible = 0;         // Touching at least one cluster
+    size_t indexCount = 0;
+    size_t maxLightsPerCluster = 0;
+    bool overflowed = false;          // Hit maxLightIndices
+    double binMilliseconds = 0.0;
+};
+
+// Clustered forward lighting, CPU side. The view frustum is split into
+// tilesX x tilesY screen tiles and exponential depth slices; every frame
+// lights are moved to view space and tested against the cluster boxes four
+// at a time, one depth slice per job. Each cluster ends up with a
+// contiguous list of light indices that a fragment looks up from its
+// screen position and view depth (see ClusteredLighting for the GPU side).
+class LightClusterGrid {
+public:
+    explicit LightClusterGrid(const LightClusterSettings& settings = {});
+
+    // Symmetric GL perspective; rebuilds the cluster boxes
+    void setProjection(float fovY, float aspect, float nearZ, float farZ);
+
+    // view is column-major (glm layout); light indices must fit in 16 bits
+    void build(const PointLight* lights, size_t count, const float* view, JobSystem* jobs = nullptr,
+               LightClusterStats* stats = nullptr);
+
+    // Cell of (tileX, tileY, slice) is at (slice * tilesY + tileY) * tilesX + tileX
+    const std::vector<LightClusterCell>& getCells() const { return m_cells; }
+    const std::vector<uint16_t>& getIndices() const { return m_indices; }
+
+    int getTilesX() const { return m_settings.tilesX; }
+    int getTilesY() const { return m_settings.tilesY; }
+    int getSlices() const { return m_settings.slices; }
+    size_t getClusterCount() const { return m_cells.size(); }
+
+    // slice = floor(log(viewDepth) * scale + bias)
+    float getDepthScale() const { return m_depthScale; }
+    float getDepthBias() const { return m_depthBias; }
+
+private:
+    LightClusterSettings m_settings;
+    float m_depthScale;
+    float m_depthBias;
+
+    // View-space cluster boxes, structure-of-arrays by cell index
+    std::vector<float> m_minX, m_minY, m_minZ, m_maxX, m_maxY, m_maxZ;
+    // Lights in view space
+    std::vector<float> m_lightX, m_lightY, m_lightZ, m_lightRadius;
+    // Per-slice results before they are merged into m_indices
+    std::vector<std::vector<uint16_t>> m_sliceIndices;
+
+    std::vector<LightClusterCell> m_cells;
+    std::vector<uint16_t> m_indices;
+
+    void binSlice(int slice, size_t lightCount);
+};
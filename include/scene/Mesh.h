@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include "scene/MeshData.h"
+
+class MeshCacheFile;
+
+// GPU mesh: VAO + interleaved vertex buffer + 32-bit index buffer in the
+// MeshVertex layout. Levels of detail are ranges of the one index buffer.
+class Mesh {
+public:
+    Mesh(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+         const MeshLod* lods = nullptr, size_t lodCount = 0);
+    explicit Mesh(const MeshData& data);
+    // Uploads straight from the file mapping
+    explicit Mesh(const MeshCacheFile& cache);
+    // Takes ownership of buffers filled elsewhere, e.g. on the upload
+    // context; only the vertex array, which contexts do not share, is
+    // created here
+    Mesh(GLuint vertexBuffer, size_t vertexCount, GLuint indexBuffer, size_t indexCount,
+         const MeshLod* lods = nullptr, size_t lodCount = 0);
+    ~Mesh();
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // Full detail
+    void draw() const { drawLod(0); }
+    void drawLod(int lod) const;
+    // Draw with this mesh's vertices and an external index buffer, e.g.
+    // culled cluster indices in a stream buffer
+    void drawIndices(GLuint indexBuffer, size_t byteOffset, size_t indexCount) const;
+
+    int selectLod(float distance, float fovY, int viewportHeight, float maxPixelError = 1.0f) const {
+        return ::selectLod(m_lods.data(), m_lods.size(), distance, fovY, viewportHeight, maxPixelError);
+    }
+    int getLodCount() const { return static_cast<int>(m_lods.size()); }
+    const MeshLod& getLod(int lod) const { return m_lods[lod]; }
+
+    GLuint getVertexArray() const { return m_vao; }
+    size_t getIndexCount() const { return m_indexCount; }
+    size_t getVertexCount() const { return m_vertexCount; }
+
+private:
+    GLuint m_vao;
+    GLuint m_vbo;
+    GLuint m_ibo;
+    size_t m_vertexCount;
+    size_t m_indexCount;
+    std::vector<MeshLod> m_lods;
+
+    void setLods(const MeshLod* lods, size_t lodCount);
+    void upload(const MeshVertex* vertices, const uint32_t* indices);
+    void createVertexArray();
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "core/MappedFile.h"
+#include "scene/MeshData.h"
+
+// Cooked mesh file (.llrmesh). Layout, all little-endian:
+//
+//   MeshFileHeader
+//   MeshFileSection[sectionCount]
+//   section blobs, each starting on a kMeshSectionAlignment boundary
+//
+// Vertex and index blobs are stored exactly as the GPU buffers expect them
+// (MeshVertex interleaved, uint32 indices), so a mapped file can be handed
+// to glBufferData without parsing or copying.
+constexpr char kMeshFileMagic[4] = { 'L', 'L', 'R', 'M' };
+constexpr uint32_t kMeshFileVersion = 1;
+constexpr uint64_t kMeshSectionAlignment = 64;
+
+enum class MeshSectionType : uint32_t {
+    Vertices = 1,
+    Indices = 2,
+    Bounds = 3,
+    Lods = 4,       // Optional; absent means a single level
+    Clusters = 5    // Optional
+};
+
+struct MeshFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sectionCount;
+    uint32_t vertexStride;   // Must equal sizeof(MeshVertex)
+    uint64_t fileSize;
+};
+
+struct MeshFileSection {
+    MeshSectionType type;
+    uint32_t elementSize;
+    uint64_t elementCount;
+    uint64_t offset;         // From start of file
+    uint64_t size;           // In bytes
+};
+
+static_assert(sizeof(MeshFileHeader) == 24, "MeshFileHeader layout changed; bump kMeshFileVersion");
+static_assert(sizeof(MeshFileSection) == 32, "MeshFileSection layout changed; bump kMeshFileVersion");
+
+// Offline side: write mesh in the cooked format
+bool writeMeshCache(const std::string& path, const MeshData& mesh);
+
+// Runtime side: maps a cooked file and exposes its blobs in place
+class MeshCacheFile {
+public:
+    // Rejects files whose sections or indices point out of range
+    bool open(const std::string& path);
+    void close();
+
+    const MeshVertex* getVertices() const { return m_vertices; }
+    size_t getVertexCount() const { return m_vertexCount; }
+    const uint32_t* getIndices() const { return m_indices; }
+    size_t getIndexCount() const { return m_indexCount; }
+    const MeshBounds& getBounds() const { return m_bounds; }
+    const MeshLod* getLods() const { return m_lods; }
+    size_t getLodCount() const { return m_lodCount; }
+    const MeshCluster* getClusters() const { return m_clusters; }
+    size_t getClusterCount() const { return m_clusterCount; }
+
+    // Copy out into a MeshData (for tools that edit the mesh)
+    MeshData toMeshData() const;
+
+private:
+    MappedFile m_file;
+    const MeshVertex* m_vertices = nullptr;
+    size_t m_vertexCount = 0;
+    const uint32_t* m_indices = nullptr;
+    size_t m_indexCount = 0;
+    MeshBounds m_bounds = {};
+    const MeshLod* m_lods = nullptr;
+    size_t m_lodCount = 0;
+    const MeshCluster* m_clusters = nullptr;
+    size_t m_clusterCount = 0;
+};
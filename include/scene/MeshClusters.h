@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "scene/MeshData.h"
+
+class JobSystem;
+
+constexpr size_t kClusterMaxVertices = 64;
+constexpr size_t kClusterMaxTriangles = 124;
+
+// Split level 0 into clusters of spatially adjacent triangles. The level 0
+// index range is reordered in place so every cluster is a contiguous
+// subrange of it; other levels are left alone.
+void buildClusters(MeshData& mesh);
+
+// Object-space view for cluster culling: normalized frustum planes
+// (inside when dot(plane.xyz, p) + plane.w >= 0) and the eye position
+struct ClusterCullView {
+    float planes[6][4];
+    float eye[3];
+};
+
+// modelViewProjection is column-major (glm layout) with GL clip space;
+// eye is the camera position in the mesh's object space
+ClusterCullView makeClusterCullView(const float* modelViewProjection, const float* eye);
+
+struct ClusterCullStats {
+    size_t clustersTested = 0;
+    size_t clustersVisible = 0;
+    size_t trianglesTested = 0;
+    size_t trianglesVisible = 0;
+    double cullMilliseconds = 0.0;
+    double compactMilliseconds = 0.0;
+};
+
+// Per-frame cluster culling for one mesh. Bounds are kept as
+// structure-of-arrays so four clusters are tested per SIMD step; the
+// frustum and normal-cone tests run across the job system and the
+// surviving index ranges are then packed contiguously, ready for one
+// glDrawElements from a stream buffer.
+class ClusterCuller {
+public:
+    ClusterCuller(const MeshCluster* clusters, size_t clusterCount);
+
+    // Fills visible with the indices of surviving clusters, in order
+    void cull(const ClusterCullView& view, std::vector<uint32_t>& visible, JobSystem* jobs = nullptr,
+              ClusterCullStats* stats = nullptr);
+
+    // Total index count of the visible clusters
+    size_t getIndexCount(const std::vector<uint32_t>& visible) const;
+
+    // Copy the visible clusters' indices to out (getIndexCount() entries)
+    void compact(const uint32_t* indices, const std::vector<uint32_t>& visible, uint32_t* out,
+                 JobSystem* jobs = nullptr, ClusterCullStats* stats = nullptr) const;
+
+    size_t getClusterCount() const { return m_ranges.size(); }
+
+private:
+    // Padded to a multiple of four; padding lanes are never reported
+    std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+    std::vector<float> m_axisX, m_axisY, m_axisZ, m_cutoff;
+    std::vector<uint8_t> m_visible;
+    struct Range {
+        uint32_t offset;
+        uint32_t count;
+    };
+    std::vector<Range> m_ranges;
+};
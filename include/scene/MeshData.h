@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Interleaved vertex layout used by every mesh on the GPU:
+// location 0 = position, 1 = normal, 2 = texcoord
+struct MeshVertex {
+    float position[3];
+    float normal[3];
+    float uv[2];
+};
+
+struct MeshBounds {
+    float min[3];
+    float max[3];
+};
+
+// One level of detail: a range of the shared index buffer. All levels
+// index the same vertex buffer; error is the geometric deviation from
+// the full-detail surface in object-space units.
+struct MeshLod {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    float error;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(MeshLod) == 16, "MeshLod is stored in mesh caches");
+
+// Cluster (meshlet) of up to kClusterMaxTriangles triangles of level 0,
+// with culling bounds in object space. The cone rejects the cluster when
+// dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius,
+// i.e. every triangle in it faces away from the eye.
+struct MeshCluster {
+    float center[3];
+    float radius;
+    float coneAxis[3];
+    float coneCutoff;      // > 1 when the cone is too wide to ever cull
+    uint32_t indexOffset;
+    uint32_t indexCount;
+};
+
+static_assert(sizeof(MeshCluster) == 40, "MeshCluster is stored in mesh caches");
+
+// CPU-side mesh in the GPU layout, as produced by importers and cookers.
+// Without lods the whole index buffer is the only level. Clusters, when
+// present, partition level 0's index range.
+struct MeshData {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshLod> lods;
+    std::vector<MeshCluster> clusters;
+
+    MeshBounds computeBounds() const;
+};
+
+// Coarsest level whose error projects to at most maxPixelError pixels at
+// the given view distance
+int selectLod(const MeshLod* lods, size_t lodCount, float distance, float fovY, int viewportHeight,
+              float maxPixelError = 1.0f);
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "scene/MeshData.h"
+
+class JobSystem;
+
+struct LodSettings {
+    int maxLevels = 8;          // Including full detail
+    float reduction = 0.5f;     // Triangle ratio between consecutive levels
+    size_t minTriangles = 64;   // No level below this many triangles
+    float maxError = 0.02f;     // Per level, relative to the bounds diagonal
+};
+
+// Quadric error metric edge-collapse simplifier. Vertices only collapse
+// onto existing vertices, so the result indexes the same vertex buffer.
+// Open borders and UV/normal seams are kept: vertices on them can only
+// slide along them. Stops at targetIndexCount or once the next collapse
+// would exceed maxError. Returns the error of the result in object-space
+// units.
+float simplifyMesh(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+                   size_t targetIndexCount, float maxError, std::vector<uint32_t>& out);
+
+// Rebuild mesh.lods as a chain simplified from level 0. Each level is
+// appended to mesh.indices; errors accumulate down the chain so they stay
+// conservative for selectLod().
+void generateLods(MeshData& mesh, const LodSettings& settings = {});
+
+// One job per mesh
+void generateLods(std::vector<MeshData>& meshes, const LodSettings& settings, JobSystem* jobs);
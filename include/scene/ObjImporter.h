@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+#include "scene/MeshData.h"
+
+class JobSystem;
+
+// Wavefront OBJ importer producing the GPU mesh layout. Faces are
+// triangulated as fans and identical v/vt/vn corners are shared.
+//
+// The file is memory-mapped and split at line boundaries; with a job system
+// the chunks are tokenized, resolved and deduplicated on all workers.
+// Vertex order is deterministic only when every corner uses matching
+// v/vt/vn indices, otherwise it follows first-come deduplication order.
+bool importObj(const std::string& path, MeshData& mesh, JobSystem* jobs = nullptr);
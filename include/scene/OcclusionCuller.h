@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "scene/MeshData.h"
+
+class JobSystem;
+
+struct OcclusionStats {
+    size_t occluderTriangles = 0;
+    size_t objectsTested = 0;
+    size_t objectsOccluded = 0;
+    double rasterMilliseconds = 0.0;    // Transform, binning and raster
+    double pyramidMilliseconds = 0.0;
+    double testMilliseconds = 0.0;
+};
+
+// Software hierarchical-Z occlusion culling. Each frame a few large
+// occluder meshes are rasterized into a small depth buffer (four pixels per
+// SIMD step, one screen tile per job), a max-Z pyramid is built on top, and
+// world-space bounds are then tested against the pyramid level where they
+// cover at most a few texels. Run it before recording draws so hidden
+// objects never reach the command queue.
+//
+// Depth is NDC z mapped to [0, 1], 1 = far plane. The test is
+// conservative: anything crossing the near plane or off screen is
+// reported visible, and triangles crossing the near plane are skipped as
+// occluders rather than clipped.
+class OcclusionCuller {
+public:
+    // width must be a multiple of four (one SIMD step)
+    explicit OcclusionCuller(int width = 256, int height = 128);
+
+    // viewProjection is column-major (glm layout), GL clip space
+    void beginFrame(const float* viewProjection);
+
+    // Queue an occluder for this frame. positions is read with the given
+    // byte stride; model (column-major) may be null for world-space data.
+    void addOccluder(const float* positions, size_t stride, size_t vertexCount, const uint32_t* indices,
+                     size_t indexCount, const float* model = nullptr);
+    void addOccluder(const MeshData& mesh, const float* model = nullptr);
+
+    // Rasterize the queued occluders and build the pyramid
+    void render(JobSystem* jobs = nullptr);
+
+    bool isOccluded(const MeshBounds& worldBounds) const;
+
+    // visible[i] = !isOccluded(bounds[i]), spread across the job system
+    void testBounds(const MeshBounds* bounds, size_t count, uint8_t* visible, JobSystem* jobs = nullptr);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    // Level 0 is the rasterized depth buffer
+    const float* getDepth(int level = 0) const { return m_levels[level].data(); }
+    int getLevelCount() const { return static_cast<int>(m_levels.size()); }
+    const OcclusionStats& getStats() const { return m_stats; }
+
+private:
+    // Screen-space triangle ready for rasterization
+    struct Triangle {
+        float x[3], y[3], z[3];
+    };
+
+    int m_width;
+    int m_height;
+    int m_tilesX;
+    int m_tilesY;
+    float m_viewProjection[16];
+    std::vector<Triangle> m_triangles;
+    std::vector<std::vector<uint32_t>> m_bins;
+    std::vector<std::vector<float>> m_levels;
+    OcclusionStats m_stats;
+
+    void rasterizeTile(int tile);
+    void buildPyramid(JobSystem* jobs);
+};
@@ -0,0 +1,136 @@
+#include "app/HeadlessContext.h"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef LLR_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace {
+
+bool hasExtension(const char* extensions, const char* name) {
+    if (!extensions) {
+        return false;
+    }
+    size_t length = std::strlen(name);
+    for (const char* p = std::strstr(extensions, name); p; p = std::strstr(p + length, name)) {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+EGLDisplay openDisplay() {
+    // Surfaceless needs neither X11 nor a DRM device
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless") &&
+        hasExtension(clientExtensions, "EGL_EXT_platform_base")) {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY) {
+                return display;
+            }
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+} // namespace
+
+HeadlessContext::HeadlessContext() : m_display(nullptr), m_context(nullptr), m_surface(nullptr) {
+    EGLDisplay display = openDisplay();
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        throw std::runtime_error("Failed to initialize EGL display");
+    }
+    m_display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        eglTerminate(display);
+        throw std::runtime_error("EGL display does not support desktop OpenGL");
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        eglTerminate(display);
+        throw std::runtime_error("No EGL config with desktop OpenGL support");
+    }
+
+    // Same version and profile as the windowed path
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 1,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT) {
+        eglTerminate(display);
+        throw std::runtime_error("Failed to create an OpenGL 4.1 core EGL context");
+    }
+    m_context = context;
+
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (!hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+        m_surface = surface;
+    }
+    if (!eglMakeCurrent(display, surface, surface, context)) {
+        if (surface != EGL_NO_SURFACE) {
+            eglDestroySurface(display, surface);
+        }
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        throw std::runtime_error("Failed to make the EGL context current");
+    }
+
+    std::cout << "EGL " << major << "." << minor << " headless context, "
+              << eglQueryString(display, EGL_VENDOR) << std::endl;
+}
+
+HeadlessContext::~HeadlessContext() {
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_surface) {
+        eglDestroySurface(m_display, m_surface);
+    }
+    eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+}
+
+void* HeadlessContext::getProcAddress(const char* name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+bool HeadlessContext::isSupported() {
+    return true;
+}
+
+#else
+
+HeadlessContext::HeadlessContext() : m_display(nullptr), m_context(nullptr), m_surface(nullptr) {
+    throw std::runtime_error("Headless mode needs EGL; rebuild with LLR_HEADLESS=ON");
+}
+
+HeadlessContext::~HeadlessContext() = default;
+
+void* HeadlessContext::getProcAddress(const char*) {
+    return nullptr;
+}
+
+bool HeadlessContext::isSupported() {
+    return false;
+}
+
+#endif
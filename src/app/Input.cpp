@@ -0,0 +1,113 @@
+#include "app/Input.h"
+
+bool InputFrame::wasPressed(InputEvent::Type type, int code) const {
+    for (const InputEvent& event : buttons) {
+        if (event.type == type && event.code == code && event.action == GLFW_PRESS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+InputQueue::InputQueue(size_t capacity)
+    : m_queue(capacity), m_dropped(0), m_hasCursor(false), m_cursorX(0.0), m_cursorY(0.0),
+      m_lastCursorX(0.0f), m_lastCursorY(0.0f) {}
+
+void InputQueue::push(const InputEvent& event) {
+    if (!m_queue.tryPush(event)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void InputQueue::pushKey(int key, int action, int mods) {
+    InputEvent event{};
+    event.type = InputEvent::Type::Key;
+    event.action = static_cast<uint8_t>(action);
+    event.mods = static_cast<uint16_t>(mods);
+    event.code = key;
+    event.timestampNanoseconds = now();
+    push(event);
+}
+
+void InputQueue::pushMouseButton(int button, int action, int mods) {
+    InputEvent event{};
+    event.type = InputEvent::Type::MouseButton;
+    event.action = static_cast<uint8_t>(action);
+    event.mods = static_cast<uint16_t>(mods);
+    event.code = button;
+    event.timestampNanoseconds = now();
+    push(event);
+}
+
+void InputQueue::pushCursor(double x, double y) {
+    InputEvent event{};
+    event.type = InputEvent::Type::MouseMove;
+    event.x = static_cast<float>(x);
+    event.y = static_cast<float>(y);
+    // Deltas in double before narrowing: with a captured cursor the
+    // position grows without bound and would lose small steps in float
+    if (m_hasCursor) {
+        event.deltaX = static_cast<float>(x - m_cursorX);
+        event.deltaY = static_cast<float>(y - m_cursorY);
+    }
+    m_hasCursor = true;
+    m_cursorX = x;
+    m_cursorY = y;
+    event.timestampNanoseconds = now();
+    push(event);
+}
+
+void InputQueue::pushScroll(double x, double y) {
+    InputEvent event{};
+    event.type = InputEvent::Type::Scroll;
+    event.x = static_cast<float>(x);
+    event.y = static_cast<float>(y);
+    event.timestampNanoseconds = now();
+    push(event);
+}
+
+void InputQueue::resetCursor() {
+    m_hasCursor = false;
+}
+
+void InputQueue::drain(InputFrame& frame) {
+    frame.mouseDeltaX = frame.mouseDeltaY = 0.0f;
+    frame.scrollX = frame.scrollY = 0.0f;
+    frame.buttons.clear();
+    frame.eventCount = 0;
+    frame.oldestTimestamp = frame.newestTimestamp = 0;
+
+    InputEvent event;
+    while (m_queue.tryPop(event)) {
+        if (frame.eventCount++ == 0) {
+            frame.oldestTimestamp = event.timestampNanoseconds;
+        }
+        frame.newestTimestamp = event.timestampNanoseconds;
+
+        switch (event.type) {
+        case InputEvent::Type::Key:
+            if (event.code >= 0 && event.code <= GLFW_KEY_LAST) {
+                m_keysDown[event.code] = event.action != GLFW_RELEASE;
+            }
+            frame.buttons.push_back(event);
+            break;
+        case InputEvent::Type::MouseButton:
+            frame.buttons.push_back(event);
+            break;
+        case InputEvent::Type::MouseMove:
+            frame.mouseDeltaX += event.deltaX;
+            frame.mouseDeltaY += event.deltaY;
+            m_lastCursorX = event.x;
+            m_lastCursorY = event.y;
+            break;
+        case InputEvent::Type::Scroll:
+            frame.scrollX += event.x;
+            frame.scrollY += event.y;
+            break;
+        }
+    }
+
+    frame.cursorX = m_lastCursorX;
+    frame.cursorY = m_lastCursorY;
+    frame.keysDown = m_keysDown;
+}
@@ -0,0 +1,72 @@
+#include "app/RenderThread.h"
+#include "app/Window.h"
+#include "core/Profiler.h"
+
+RenderThread::RenderThread(Window& window, Callbacks callbacks)
+    : m_window(window), m_callbacks(std::move(callbacks)), m_stopRequested(false), m_running(true), m_frames(0) {
+    // A context can be current on one thread at a time
+    glfwMakeContextCurrent(nullptr);
+    m_thread = std::thread(&RenderThread::threadMain, this);
+}
+
+RenderThread::~RenderThread() {
+    try {
+        stop();
+    } catch (...) {
+        // Destructors must not throw; call stop() first to see the error
+    }
+}
+
+void RenderThread::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    m_stopRequested.store(true, std::memory_order_release);
+    m_thread.join();
+    glfwMakeContextCurrent(m_window.getGLFWWindow());
+
+    if (m_error) {
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void RenderThread::threadMain() {
+    Profiler::setThreadName("Render");
+    glfwMakeContextCurrent(m_window.getGLFWWindow());
+
+    bool started = false;
+    try {
+        if (m_callbacks.start) {
+            m_callbacks.start();
+        }
+        started = true;
+        while (!m_stopRequested.load(std::memory_order_acquire)) {
+            m_callbacks.frame();
+            {
+                LLR_PROFILE_SCOPE("Swap");
+                m_window.swapBuffers();
+            }
+            if (m_callbacks.presented) {
+                m_callbacks.presented();
+            }
+            m_frames.fetch_add(1, std::memory_order_relaxed);
+        }
+    } catch (...) {
+        m_error = std::current_exception();
+    }
+
+    // Resources made in start are released even after a failed frame
+    if (started && m_callbacks.stop) {
+        try {
+            m_callbacks.stop();
+        } catch (...) {
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+    glfwMakeContextCurrent(nullptr);
+    m_running.store(false, std::memory_order_release);
+}
@@ -10,8 +10,8 @@ static void errorCallback(int error, const char* description) {
     std::cerr << "GLFW Error " << error << ": " << description << std::endl;
 }
 
-Window::Window(int width, int height, const std::string& title) 
-    : m_width(width), m_height(height) {
+Window::Window(int width, int height, const std::string& title, bool createUploadContext) 
+    : m_uploadContext(nullptr), m_width(width), m_height(height), m_vsync(VSync::On) {
     
     // Initialize GLFW if not already done
     if (!s_glfwInitialized) {
@@ -35,11 +35,24 @@ Window::Window(int width, int height, const std::string& title)
         throw std::runtime_error("Failed to create GLFW window");
     }
     
+    // Hidden shared context for background uploads. GLFW only allows
+    // window creation on the main thread, so it is made here and made
+    // current later on the upload thread.
+    if (createUploadContext) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        m_uploadContext = glfwCreateWindow(1, 1, "", nullptr, m_window);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if (!m_uploadContext) {
+            glfwDestroyWindow(m_window);
+            throw std::runtime_error("Failed to create shared upload context");
+        }
+    }
+    
     // Make OpenGL context current
     glfwMakeContextCurrent(m_window);
     
     // Enable VSync
-    glfwSwapInterval(1);
+    setVSync(VSync::On);
     
     // Set user pointer for callbacks
     glfwSetWindowUserPointer(m_window, this);
@@ -47,6 +60,8 @@ Window::Window(int width, int height, const std::string& title)
     // Set callbacks
     glfwSetKeyCallback(m_window, keyCallbackWrapper);
     glfwSetCursorPosCallback(m_window, mouseMoveCallbackWrapper);
+    glfwSetMouseButtonCallback(m_window, mouseButtonCallbackWrapper);
+    glfwSetScrollCallback(m_window, scrollCallbackWrapper);
     
     // Update actual framebuffer size (important for Retina displays)
     int fbWidth, fbHeight;
@@ -56,6 +71,9 @@ Window::Window(int width, int height, const std::string& title)
 }
 
 Window::~Window() {
+    if (m_uploadContext) {
+        glfwDestroyWindow(m_uploadContext);
+    }
     if (m_window) {
         glfwDestroyWindow(m_window);
     }
@@ -73,12 +91,38 @@ void Window::pollEvents() {
     glfwPollEvents();
 }
 
-void Window::setKeyCallback(std::function<void(int, int, int, int)> callback) {
-    m_keyCallback = std::move(callback);
+void Window::waitEvents(double timeoutSeconds) {
+    // GLFW rejects timeouts that are not positive
+    if (timeoutSeconds > 0.0) {
+        glfwWaitEventsTimeout(timeoutSeconds);
+    } else {
+        glfwPollEvents();
+    }
+}
+
+Window::VSync Window::setVSync(VSync mode) {
+    if (mode == VSync::Adaptive && !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        std::cerr << "Adaptive vsync is not supported, using regular vsync" << std::endl;
+        mode = VSync::On;
+    }
+    
+    glfwSwapInterval(mode == VSync::Off ? 0 : mode == VSync::On ? 1 : -1);
+    m_vsync = mode;
+    return mode;
+}
+
+void Window::setShouldClose(bool close) {
+    glfwSetWindowShouldClose(m_window, close ? GLFW_TRUE : GLFW_FALSE);
 }
 
-void Window::setMouseMoveCallback(std::function<void(double, double)> callback) {
-    m_mouseMoveCallback = std::move(callback);
+void Window::setCursorCaptured(bool captured) {
+    glfwSetInputMode(m_window, GLFW_CURSOR, captured ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+    if (glfwRawMouseMotionSupported()) {
+        glfwSetInputMode(m_window, GLFW_RAW_MOUSE_MOTION, captured ? GLFW_TRUE : GLFW_FALSE);
+    }
+    // GLFW moves the cursor when the mode changes; that is not motion
+    m_input.resetCursor();
 }
 
 int Window::getWidth() const {
@@ -96,16 +140,30 @@ float Window::getContentScaleFactor() const {
 }
 
 // Static callback wrappers
-void Window::keyCallbackWrapper(GLFWwindow* window, int key, int scancode, int action, int mods) {
+void Window::keyCallbackWrapper(GLFWwindow* window, int key, int /*scancode*/, int action, int mods) {
     Window* windowObj = static_cast<Window*>(glfwGetWindowUserPointer(window));
-    if (windowObj && windowObj->m_keyCallback) {
-        windowObj->m_keyCallback(key, scancode, action, mods);
+    if (windowObj) {
+        windowObj->m_input.pushKey(key, action, mods);
     }
 }
 
 void Window::mouseMoveCallbackWrapper(GLFWwindow* window, double xpos, double ypos) {
     Window* windowObj = static_cast<Window*>(glfwGetWindowUserPointer(window));
-    if (windowObj && windowObj->m_mouseMoveCallback) {
-        windowObj->m_mouseMoveCallback(xpos, ypos);
+    if (windowObj) {
+        windowObj->m_input.pushCursor(xpos, ypos);
+    }
+}
+
+void Window::mouseButtonCallbackWrapper(GLFWwindow* window, int button, int action, int mods) {
+    Window* windowObj = static_cast<Window*>(glfwGetWindowUserPointer(window));
+    if (windowObj) {
+        windowObj->m_input.pushMouseButton(button, action, mods);
+    }
+}
+
+void Window::scrollCallbackWrapper(GLFWwindow* window, double xoffset, double yoffset) {
+    Window* windowObj = static_cast<Window*>(glfwGetWindowUserPointer(window));
+    if (windowObj) {
+        windowObj->m_input.pushScroll(xoffset, yoffset);
     }
 } 
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "core/AssetArchive.h"
+#include "core/Hash.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <lz4.h>
+
+namespace {
+
+bool entryLess(uint64_t hashA, std::string_view nameA, uint64_t hashB, std::string_view nameB) {
+    return hashA != hashB ? hashA < hashB : nameA < nameB;
+}
+
+bool readWholeFile(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    out.resize(static_cast<size_t>(size));
+    return size == 0 || file.read(reinterpret_cast<char*>(out.data()), size).good();
+}
+
+} // namespace
+
+bool writeAssetArchive(const std::string& outputPath, const std::vector<ArchiveInput>& inputs,
+                       JobSystem* jobs, uint32_t chunkSize, ArchiveWriteStats* stats) {
+    // Sort by lookup order up front so the table of contents is already
+    // in binary-search order
+    std::vector<size_t> order(inputs.size());
+    std::vector<uint64_t> hashes(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        order[i] = i;
+        hashes[i] = hashString(inputs[i].name);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return entryLess(hashes[a], inputs[a].name, hashes[b], inputs[b].name);
+    });
+
+    struct PendingChunk {
+        size_t input;
+        size_t offset;
+        uint32_t rawSize;
+        std::vector<uint8_t> stored;
+    };
+
+    std::vector<std::vector<uint8_t>> contents(inputs.size());
+    std::vector<ArchiveEntry> entries(inputs.size());
+    std::vector<PendingChunk> chunks;
+    std::string names;
+
+    for (size_t sorted = 0; sorted < order.size(); ++sorted) {
+        size_t i = order[sorted];
+        if (sorted > 0 && inputs[order[sorted - 1]].name == inputs[i].name) {
+            std::cerr << "Duplicate asset name in archive: " << inputs[i].name << std::endl;
+            return false;
+        }
+        if (!readWholeFile(inputs[i].path, contents[i])) {
+            std::cerr << "Failed to read asset: " << inputs[i].path << std::endl;
+            return false;
+        }
+
+        ArchiveEntry& entry = entries[sorted];
+        entry.nameHash = hashes[i];
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint32_t>(inputs[i].name.size());
+        entry.size = contents[i].size();
+        entry.firstChunk = static_cast<uint32_t>(chunks.size());
+        names += inputs[i].name;
+
+        for (size_t offset = 0; offset < contents[i].size(); offset += chunkSize) {
+            uint32_t rawSize = static_cast<uint32_t>(std::min<size_t>(chunkSize, contents[i].size() - offset));
+            chunks.push_back({ i, offset, rawSize, {} });
+        }
+        entry.chunkCount = static_cast<uint32_t>(chunks.size()) - entry.firstChunk;
+    }
+
+    // Compress every chunk independently
+    auto compressChunks = [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            PendingChunk& chunk = chunks[c];
+            const char* source = reinterpret_cast<const char*>(contents[chunk.input].data() + chunk.offset);
+            chunk.stored.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(chunk.rawSize))));
+            int compressed = LZ4_compress_default(source, reinterpret_cast<char*>(chunk.stored.data()),
+                                                  static_cast<int>(chunk.rawSize), static_cast<int>(chunk.stored.size()));
+            if (compressed <= 0 || static_cast<uint32_t>(compressed) >= chunk.rawSize) {
+                // Incompressible (already-compressed images etc.): store raw
+                chunk.stored.assign(source, source + chunk.rawSize);
+            } else {
+                chunk.stored.resize(static_cast<size_t>(compressed));
+            }
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(chunks.size(), compressChunks, 1);
+    } else {
+        compressChunks(0, chunks.size());
+    }
+
+    ArchiveHeader header = {};
+    std::memcpy(header.magic, kArchiveMagic, sizeof(header.magic));
+    header.version = kArchiveVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.chunkCount = static_cast<uint32_t>(chunks.size());
+    header.chunkSize = chunkSize;
+    header.nameTableSize = static_cast<uint32_t>(names.size());
+
+    std::vector<ArchiveChunk> chunkTable(chunks.size());
+    uint64_t offset = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * entries.size() +
+                      sizeof(ArchiveChunk) * chunks.size() + names.size();
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        chunkTable[c].offset = offset;
+        chunkTable[c].storedSize = static_cast<uint32_t>(chunks[c].stored.size());
+        chunkTable[c].rawSize = chunks[c].rawSize;
+        offset += chunks[c].stored.size();
+    }
+    header.fileSize = offset;
+
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create archive: " << outputPath << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(sizeof(ArchiveEntry) * entries.size()));
+    file.write(reinterpret_cast<const char*>(chunkTable.data()), static_cast<std::streamsize>(sizeof(ArchiveChunk) * chunkTable.size()));
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
+    for (const auto& chunk : chunks) {
+        file.write(reinterpret_cast<const char*>(chunk.stored.data()), static_cast<std::streamsize>(chunk.stored.size()));
+    }
+    if (!file.good()) {
+        std::cerr << "Failed to write archive: " << outputPath << std::endl;
+        return false;
+    }
+
+    if (stats) {
+        stats->fileCount = entries.size();
+        stats->storedBytes = header.fileSize;
+        stats->rawBytes = 0;
+        for (const auto& entry : entries) stats->rawBytes += entry.size;
+    }
+    return true;
+}
+
+bool AssetArchive::open(const std::string& path) {
+    // Opening unmaps any previous archive, even when it fails
+    m_header = nullptr;
+    m_entries = nullptr;
+    m_chunks = nullptr;
+    m_names = nullptr;
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const uint8_t* base = m_file.data();
+    size_t size = m_file.size();
+    m_header = reinterpret_cast<const ArchiveHeader*>(base);
+
+    bool valid = size >= sizeof(ArchiveHeader) &&
+                 std::memcmp(m_header->magic, kArchiveMagic, sizeof(m_header->magic)) == 0 &&
+                 m_header->version == kArchiveVersion &&
+                 m_header->fileSize == size;
+    uint64_t tablesEnd = sizeof(ArchiveHeader);
+    if (valid) {
+        tablesEnd += sizeof(ArchiveEntry) * static_cast<uint64_t>(m_header->entryCount) +
+                     sizeof(ArchiveChunk) * static_cast<uint64_t>(m_header->chunkCount) + m_header->nameTableSize;
+        valid = tablesEnd <= size;
+    }
+    if (valid) {
+        m_entries = reinterpret_cast<const ArchiveEntry*>(base + sizeof(ArchiveHeader));
+        m_chunks = reinterpret_cast<const ArchiveChunk*>(m_entries + m_header->entryCount);
+        m_names = reinterpret_cast<const char*>(m_chunks + m_header->chunkCount);
+        valid = validateTables(tablesEnd);
+    }
+    if (!valid) {
+        std::cerr << "Asset archive is invalid or from another version: " << path << std::endl;
+        m_file.close();
+        m_header = nullptr;
+        m_entries = nullptr;
+        m_chunks = nullptr;
+        m_names = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool AssetArchive::validateTables(uint64_t payloadStart) const {
+    const uint64_t fileSize = m_header->fileSize;
+    const uint32_t chunkSize = m_header->chunkSize;
+
+    // Every payload must lie after the tables and inside the file, and can
+    // never grow when stored compressed
+    for (uint32_t c = 0; c < m_header->chunkCount; ++c) {
+        const ArchiveChunk& chunk = m_chunks[c];
+        if (chunk.offset < payloadStart || chunk.offset > fileSize || chunk.storedSize > fileSize - chunk.offset ||
+            chunk.rawSize == 0 || chunk.rawSize > chunkSize || chunk.storedSize > chunk.rawSize) {
+            return false;
+        }
+    }
+
+    // read() inflates chunk i of an entry at i * chunkSize, so every chunk
+    // but the last must be full and together they must add up to the size
+    for (uint32_t e = 0; e < m_header->entryCount; ++e) {
+        const ArchiveEntry& entry = m_entries[e];
+        if (static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > m_header->nameTableSize ||
+            static_cast<uint64_t>(entry.firstChunk) + entry.chunkCount > m_header->chunkCount) {
+            return false;
+        }
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < entry.chunkCount; ++i) {
+            uint32_t rawSize = m_chunks[entry.firstChunk + i].rawSize;
+            if (i + 1 < entry.chunkCount && rawSize != chunkSize) {
+                return false;
+            }
+            total += rawSize;
+        }
+        if (total != entry.size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view AssetArchive::getName(const ArchiveEntry& entry) const {
+    return std::string_view(m_names + entry.nameOffset, entry.nameLength);
+}
+
+const ArchiveEntry* AssetArchive::find(std::string_view name) const {
+    if (!m_header) {
+        return nullptr;
+    }
+
+    uint64_t hash = hashString(name);
+    const ArchiveEntry* begin = m_entries;
+    const ArchiveEntry* end = m_entries + m_header->entryCount;
+    const ArchiveEntry* it = std::lower_bound(begin, end, hash, [&](const ArchiveEntry& entry, uint64_t value) {
+        return entryLess(entry.nameHash, getName(entry), value, name);
+    });
+
+    if (it != end && it->nameHash == hash && getName(*it) == name) {
+        return it;
+    }
+    return nullptr;
+}
+
+bool AssetArchive::readChunk(const ArchiveChunk& chunk, uint8_t* out) const {
+    const char* stored = reinterpret_cast<const char*>(m_file.data() + chunk.offset);
+    if (chunk.storedSize == chunk.rawSize) {
+        std::memcpy(out, stored, chunk.rawSize);
+        return true;
+    }
+    int result = LZ4_decompress_safe(stored, reinterpret_cast<char*>(out),
+                                     static_cast<int>(chunk.storedSize), static_cast<int>(chunk.rawSize));
+    return result == static_cast<int>(chunk.rawSize);
+}
+
+bool AssetArchive::read(std::string_view name, std::vector<uint8_t>& out, JobSystem* jobs) const {
+    const ArchiveEntry* entry = find(name);
+    if (!entry) {
+        std::cerr << "Asset not found in archive: " << name << std::endl;
+        return false;
+    }
+
+    out.resize(entry->size);
+    std::atomic<bool> failed{false};
+    auto inflate = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const ArchiveChunk& chunk = m_chunks[entry->firstChunk + i];
+            if (!readChunk(chunk, out.data() + i * static_cast<size_t>(m_header->chunkSize))) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    if (jobs && entry->chunkCount > 1) {
+        jobs->parallelFor(entry->chunkCount, inflate, 1);
+    } else {
+        inflate(0, entry->chunkCount);
+    }
+
+    if (failed.load()) {
+        std::cerr << "Corrupt chunk in archive asset: " << name << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Task<std::vector<uint8_t>> readAsset(JobSystem& jobs, const AssetArchive& archive, std::string name) {
+    co_await resumeOn(jobs);
+
+    std::vector<uint8_t> data;
+    if (!archive.read(name, data, &jobs)) {
+        throw std::runtime_error("Failed to read asset: " + name);
+    }
+    co_return data;
+}
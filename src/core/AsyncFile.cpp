@@ -0,0 +1,26 @@
+#include "core/AsyncFile.h"
+#include <cstdio>
+#include <stdexcept>
+
+Task<std::vector<uint8_t>> readFile(JobSystem& jobs, std::string path) {
+    co_await resumeOn(jobs);
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+
+    std::vector<uint8_t> data(size > 0 ? static_cast<size_t>(size) : 0);
+    size_t read = data.empty() ? 0 : std::fread(data.data(), 1, data.size(), file);
+    std::fclose(file);
+
+    if (read != data.size()) {
+        throw std::runtime_error("Failed to read file: " + path);
+    }
+
+    co_return data;
+}
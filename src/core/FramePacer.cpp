@@ -0,0 +1,122 @@
+#include "core/FramePacer.h"
+#include "core/Profiler.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+FramePacer::FramePacer(FramePacerSettings settings)
+    : m_settings(settings), m_started(false), m_accumulator(0.0), m_droppedSeconds(0.0), m_historyNext(0) {
+    if (m_settings.stepSeconds <= 0.0 || m_settings.maxStepsPerFrame < 1) {
+        throw std::invalid_argument("FramePacer needs a positive step and at least one step per frame");
+    }
+    m_history.reserve(m_settings.historyFrames);
+}
+
+int FramePacer::beginFrame() {
+    Clock::time_point now = Clock::now();
+    if (!m_started) {
+        // The first frame renders the initial state without stepping
+        m_started = true;
+        m_lastFrame = now;
+        m_deadline = now;
+        return 0;
+    }
+
+    double elapsed = std::chrono::duration<double>(now - m_lastFrame).count();
+    m_lastFrame = now;
+
+    if (m_settings.historyFrames > 0) {
+        float ms = static_cast<float>(elapsed * 1000.0);
+        if (m_history.size() < m_settings.historyFrames) {
+            m_history.push_back(ms);
+        } else {
+            m_history[m_historyNext] = ms;
+        }
+        m_historyNext = (m_historyNext + 1) % m_settings.historyFrames;
+    }
+
+    m_accumulator += elapsed;
+    int steps = static_cast<int>(m_accumulator / m_settings.stepSeconds);
+    if (steps > m_settings.maxStepsPerFrame) {
+        double excess = (steps - m_settings.maxStepsPerFrame) * m_settings.stepSeconds;
+        m_accumulator -= excess;
+        m_droppedSeconds += excess;
+        steps = m_settings.maxStepsPerFrame;
+    }
+    m_accumulator -= steps * m_settings.stepSeconds;
+    return steps;
+}
+
+void FramePacer::endFrame() {
+    if (m_settings.targetFps <= 0.0 || !m_started) {
+        return;
+    }
+
+    // Deadlines advance by whole periods so rounding never accumulates
+    // into drift; a frame that ran over starts a new schedule instead of
+    // rushing the following frames to catch up
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_settings.targetFps));
+    m_deadline += period;
+    Clock::time_point now = Clock::now();
+    if (m_deadline <= now) {
+        m_deadline = now;
+        return;
+    }
+    LLR_PROFILE_SCOPE("Frame limiter");
+    waitUntil(m_deadline);
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) const {
+    auto spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(m_settings.spinMilliseconds));
+    while (true) {
+        Clock::duration remaining = deadline - Clock::now();
+        if (remaining <= spin) {
+            break;
+        }
+        std::this_thread::sleep_for(remaining - spin);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+float FramePacer::getAlpha() const {
+    return static_cast<float>(std::min(m_accumulator / m_settings.stepSeconds, 1.0));
+}
+
+double FramePacer::getSecondsUntilNextStep() const {
+    double sinceFrame = std::chrono::duration<double>(Clock::now() - m_lastFrame).count();
+    return std::max(0.0, m_settings.stepSeconds - m_accumulator - sinceFrame);
+}
+
+FrameTimeStats FramePacer::getStats() const {
+    return summarizeFrameTimes(m_history);
+}
+
+FrameTimeStats summarizeFrameTimes(std::vector<float> sorted) {
+    FrameTimeStats stats;
+    if (sorted.empty()) {
+        return stats;
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) {
+        return static_cast<double>(sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))]);
+    };
+    double total = 0.0;
+    for (float ms : sorted) total += ms;
+
+    stats.frames = sorted.size();
+    stats.averageMilliseconds = total / static_cast<double>(sorted.size());
+    stats.minMilliseconds = sorted.front();
+    stats.p50Milliseconds = percentile(0.5);
+    stats.p95Milliseconds = percentile(0.95);
+    stats.p99Milliseconds = percentile(0.99);
+    stats.maxMilliseconds = sorted.back();
+    return stats;
+}
+
+void FramePacer::setTargetFps(double fps) {
+    m_settings.targetFps = std::max(0.0, fps);
+    m_deadline = Clock::now();
+}
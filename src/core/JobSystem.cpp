@@ -0,0 +1,282 @@
+#include "core/JobSystem.h"
+
+namespace {
+
+// Per-thread worker identity, one entry per job system the thread works for
+struct WorkerMembership {
+    uint64_t systemId;
+    int threadIndex;
+};
+
+thread_local std::vector<WorkerMembership> t_memberships;
+std::atomic<uint64_t> g_nextSystemId{1};
+
+} // namespace
+
+// WorkStealingDeque
+
+JobSystem::WorkStealingDeque::WorkStealingDeque(size_t capacity)
+    : m_top(0), m_bottom(0) {
+    // Round up to a power of two so indices wrap with a mask
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_buffer = std::make_unique<std::atomic<Job*>[]>(size);
+    m_mask = static_cast<int64_t>(size) - 1;
+}
+
+bool JobSystem::WorkStealingDeque::push(Job* job) {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top > m_mask) {
+        return false;
+    }
+
+    m_buffer[bottom & m_mask].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+JobSystem::Job* JobSystem::WorkStealingDeque::pop() {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // Empty
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // Last element: race against thieves for it
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+JobSystem::Job* JobSystem::WorkStealingDeque::steal() {
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+        return nullptr;
+    }
+
+    Job* job = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        // Lost the race to another thief or the owner
+        return nullptr;
+    }
+    return job;
+}
+
+// JobSystem
+
+JobSystem::JobSystem(size_t threadCount)
+    : m_id(g_nextSystemId.fetch_add(1, std::memory_order_relaxed)), m_queuedJobs(0), m_running(true) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
+    // The constructing thread is worker 0
+    t_memberships.push_back({ m_id, 0 });
+
+    for (size_t i = 1; i < threadCount; ++i) {
+        m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_running.store(false);
+    }
+    m_sleepCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // Drop anything that was never run
+    for (auto& worker : m_workers) {
+        while (Job* job = worker->deque.pop()) {
+            delete job;
+        }
+    }
+    for (Job* job : m_injected) {
+        delete job;
+    }
+
+    // Only the destroying thread's entry can be dropped here; an entry left
+    // on another thread never matches since ids are not reused
+    std::erase_if(t_memberships, [this](const WorkerMembership& membership) {
+        return membership.systemId == m_id;
+    });
+}
+
+int JobSystem::getCurrentThreadIndex() const {
+    for (const WorkerMembership& membership : t_memberships) {
+        if (membership.systemId == m_id) {
+            return membership.threadIndex;
+        }
+    }
+    return -1;
+}
+
+void JobSystem::run(JobFunction function, JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job* job = new Job{ std::move(function), counter };
+    int index = getCurrentThreadIndex();
+
+    if (index >= 0) {
+        if (!m_workers[index]->deque.push(job)) {
+            // Deque full: run inline rather than grow it
+            execute(job);
+            return;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        m_injected.push_back(job);
+    }
+
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+    notifyWorkers();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    int index = getCurrentThreadIndex();
+    uint32_t rngState = static_cast<uint32_t>(index + 1) * 2654435761u;
+
+    int idleSpins = 0;
+    while (!counter.isDone()) {
+        if (Job* job = findJob(index, rngState)) {
+            execute(job);
+            idleSpins = 0;
+        } else if (++idleSpins > 64) {
+            // The remaining jobs are running elsewhere; don't burn the core
+            std::this_thread::yield();
+        }
+    }
+    rethrowError(counter);
+}
+
+void JobSystem::rethrowError(JobCounter& counter) {
+    std::exception_ptr error;
+    if (counter.failed.load(std::memory_order_acquire)) {
+        error = std::move(counter.error);
+        counter.error = nullptr;
+        counter.failed.store(false, std::memory_order_relaxed);
+    } else {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        error = std::move(m_error);
+        m_error = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::workerLoop(size_t index) {
+    t_memberships.push_back({ m_id, static_cast<int>(index) });
+    uint32_t rngState = static_cast<uint32_t>(index + 1) * 2654435761u;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        if (Job* job = findJob(static_cast<int>(index), rngState)) {
+            execute(job);
+            continue;
+        }
+
+        // Nothing to do: sleep until new work is announced
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this]() {
+            return !m_running.load(std::memory_order_acquire) ||
+                   m_queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+JobSystem::Job* JobSystem::findJob(int threadIndex, uint32_t& rngState) {
+    Job* job = nullptr;
+
+    // Own deque first (hot in cache), newest job first
+    if (threadIndex >= 0) {
+        job = m_workers[threadIndex]->deque.pop();
+    }
+
+    if (!job) {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        if (!m_injected.empty()) {
+            job = m_injected.front();
+            m_injected.pop_front();
+        }
+    }
+
+    if (!job) {
+        // Steal starting from a random victim to spread contention
+        size_t workerCount = m_workers.size();
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        size_t start = rngState % workerCount;
+        for (size_t i = 0; i < workerCount && !job; ++i) {
+            size_t victim = (start + i) % workerCount;
+            if (static_cast<int>(victim) != threadIndex) {
+                job = m_workers[victim]->deque.steal();
+            }
+        }
+    }
+
+    if (job) {
+        m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+void JobSystem::execute(Job* job) {
+    try {
+        job->function();
+    } catch (...) {
+        // Keep the first; the counter's waiter rethrows it after the
+        // decrement below publishes it
+        if (job->counter) {
+            if (!job->counter->failed.exchange(true, std::memory_order_relaxed)) {
+                job->counter->error = std::current_exception();
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+    if (job->counter) {
+        job->counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    delete job;
+}
+
+void JobSystem::notifyWorkers() {
+    // Taking the lock orders this against a worker that is about to sleep
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+}
@@ -0,0 +1,123 @@
+#include "core/LinearAllocator.h"
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#endif
+
+LinearAllocator::LinearAllocator(size_t blockSize, size_t alignment)
+    : m_current(0), m_blockSize(blockSize), m_alignment(alignment) {
+    m_blocks.push_back(createBlock(blockSize));
+}
+
+LinearAllocator::~LinearAllocator() {
+    release();
+}
+
+LinearAllocator::LinearAllocator(LinearAllocator&& other) noexcept
+    : m_blocks(std::move(other.m_blocks)), m_current(other.m_current),
+      m_blockSize(other.m_blockSize), m_alignment(other.m_alignment) {
+    other.m_blocks.clear();
+    other.m_current = 0;
+}
+
+LinearAllocator& LinearAllocator::operator=(LinearAllocator&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_blocks = std::move(other.m_blocks);
+        m_current = other.m_current;
+        m_blockSize = other.m_blockSize;
+        m_alignment = other.m_alignment;
+        other.m_blocks.clear();
+        other.m_current = 0;
+    }
+    return *this;
+}
+
+void* LinearAllocator::alloc(size_t size, size_t alignment) {
+    if (alignment == 0) {
+        alignment = m_alignment;
+    }
+
+    // Try the current block, then any later ones kept from previous frames
+    while (m_current < m_blocks.size()) {
+        Block& block = m_blocks[m_current];
+        // Align the address, not the offset: blocks are only aligned to
+        // m_alignment, which may be less than what this request needs
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.memory);
+        size_t offset = ((base + block.used + alignment - 1) & ~(alignment - 1)) - base;
+        if (offset + size <= block.size) {
+            block.used = offset + size;
+            return block.memory + offset;
+        }
+        ++m_current;
+        if (m_current < m_blocks.size()) {
+            m_blocks[m_current].used = 0;
+        }
+    }
+
+    // Out of space: add a block big enough for this request
+    Block block = createBlock(std::max(m_blockSize, size + alignment));
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.memory);
+    size_t offset = ((base + alignment - 1) & ~(alignment - 1)) - base;
+    block.used = offset + size;
+    m_blocks.push_back(block);
+    m_current = m_blocks.size() - 1;
+    return block.memory + offset;
+}
+
+void LinearAllocator::reset() {
+    for (auto& block : m_blocks) {
+        block.used = 0;
+    }
+    m_current = 0;
+}
+
+size_t LinearAllocator::getBytesUsed() const {
+    size_t total = 0;
+    for (size_t i = 0; i <= m_current && i < m_blocks.size(); ++i) {
+        total += m_blocks[i].used;
+    }
+    return total;
+}
+
+size_t LinearAllocator::getBytesReserved() const {
+    size_t total = 0;
+    for (const auto& block : m_blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+LinearAllocator::Block LinearAllocator::createBlock(size_t minSize) {
+    Block block;
+    // aligned_alloc requires the size to be a multiple of the alignment
+    block.size = (minSize + m_alignment - 1) & ~(m_alignment - 1);
+    block.used = 0;
+
+    #ifdef __APPLE__
+    void* memory = nullptr;
+    if (posix_memalign(&memory, m_alignment, block.size) != 0) {
+        throw std::runtime_error("Failed to allocate aligned memory");
+    }
+    block.memory = static_cast<char*>(memory);
+    #else
+    block.memory = static_cast<char*>(std::aligned_alloc(m_alignment, block.size));
+    if (!block.memory) {
+        throw std::runtime_error("Failed to allocate aligned memory");
+    }
+    #endif
+    return block;
+}
+
+void LinearAllocator::release() {
+    for (auto& block : m_blocks) {
+        std::free(block.memory);
+    }
+    m_blocks.clear();
+    m_current = 0;
+}
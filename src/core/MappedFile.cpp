@@ -0,0 +1,68 @@
+#include "core/MappedFile.h"
+#include <iostream>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        std::cerr << "Failed to stat file or file is empty: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file referenced; the descriptor is not needed
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << path << std::endl;
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(mapping);
+    m_size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+void MappedFile::prefetch() const {
+    if (m_data) {
+        madvise(const_cast<uint8_t*>(m_data), m_size, MADV_SEQUENTIAL);
+        madvise(const_cast<uint8_t*>(m_data), m_size, MADV_WILLNEED);
+    }
+}
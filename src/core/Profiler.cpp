@@ -0,0 +1,171 @@
+#include "core/Profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Events of one thread. Only the owning thread writes; readers take the
+// slots below count, which is published with release semantics after each
+// event is complete.
+struct ThreadBuffer {
+    std::unique_ptr<Profiler::Event[]> events{ new Profiler::Event[Profiler::kEventsPerThread] };
+    std::atomic<size_t> count{ 0 };
+    std::atomic<size_t> dropped{ 0 };
+    std::atomic<uint32_t> generation{ 0 };
+    std::string name;
+    int id = 0;
+
+    void append(const Profiler::Event& event, uint32_t currentGeneration) {
+        // First event of a new capture: the owner clears its own buffer
+        if (generation.load(std::memory_order_relaxed) != currentGeneration) {
+            count.store(0, std::memory_order_relaxed);
+            dropped.store(0, std::memory_order_relaxed);
+            generation.store(currentGeneration, std::memory_order_release);
+        }
+        size_t index = count.load(std::memory_order_relaxed);
+        if (index >= Profiler::kEventsPerThread) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events[index] = event;
+        count.store(index + 1, std::memory_order_release);
+    }
+};
+
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+std::atomic<uint32_t> g_generation{ 0 };
+
+// Buffers are never freed, so a thread may exit mid-capture
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+ThreadBuffer* g_gpuBuffer = nullptr;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer* registerBuffer(const std::string& name) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->id = static_cast<int>(g_buffers.size()) + 1;
+    buffer->name = name.empty() ? "Thread " + std::to_string(buffer->id) : name;
+    g_buffers.push_back(std::move(buffer));
+    return g_buffers.back().get();
+}
+
+ThreadBuffer* getThreadBuffer() {
+    if (!t_buffer) {
+        t_buffer = registerBuffer("");
+    }
+    return t_buffer;
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+            out << escaped;
+        } else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+std::atomic<bool> Profiler::s_capturing{ false };
+
+void Profiler::beginCapture() {
+    g_generation.fetch_add(1, std::memory_order_relaxed);
+    s_capturing.store(true, std::memory_order_release);
+}
+
+void Profiler::endCapture() {
+    s_capturing.store(false, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    if (t_buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        t_buffer->name = name;
+    } else {
+        t_buffer = registerBuffer(name);
+    }
+}
+
+void Profiler::record(const char* name, int64_t startNanoseconds, int64_t endNanoseconds) {
+    getThreadBuffer()->append({ name, startNanoseconds, endNanoseconds }, g_generation.load(std::memory_order_relaxed));
+}
+
+void Profiler::recordGpu(const char* name, int64_t startNanoseconds, int64_t endNanoseconds) {
+    if (!isCapturing()) {
+        return;
+    }
+    if (!g_gpuBuffer) {
+        g_gpuBuffer = registerBuffer("GPU");
+    }
+    g_gpuBuffer->append({ name, startNanoseconds, endNanoseconds }, g_generation.load(std::memory_order_relaxed));
+}
+
+int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    uint32_t generation = g_generation.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+
+    // Timestamps are microseconds; keep the nanosecond fraction
+    out << std::fixed;
+    out.precision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : g_buffers) {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":";
+        writeEscaped(out, buffer->name.c_str());
+        out << "}}";
+        first = false;
+
+        if (buffer->generation.load(std::memory_order_acquire) != generation) {
+            continue;
+        }
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        const char* category = buffer.get() == g_gpuBuffer ? "gpu" : "cpu";
+        for (size_t i = 0; i < count; ++i) {
+            const Event& event = buffer->events[i];
+            out << ",\n{\"name\":";
+            writeEscaped(out, event.name);
+            out << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"ts\":" << static_cast<double>(event.startNanoseconds) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.endNanoseconds - event.startNanoseconds) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+size_t Profiler::getDroppedCount() {
+    uint32_t generation = g_generation.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    size_t dropped = 0;
+    for (const auto& buffer : g_buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) == generation) {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return dropped;
+}
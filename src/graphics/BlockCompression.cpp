@@ -0,0 +1,382 @@
+#include "graphics/BlockCompression.h"
+#include "core/JobSystem.h"
+#include "core/Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// 16 pixels of one block in structure-of-arrays form, so SIMD code can
+// process four pixels per register
+struct BlockPixels {
+    alignas(16) float channel[4][16];
+};
+
+void loadBlock(const TextureLevel& level, int blockX, int blockY, BlockPixels& block) {
+    for (int y = 0; y < 4; ++y) {
+        int sy = std::min(blockY * 4 + y, level.height - 1);
+        for (int x = 0; x < 4; ++x) {
+            int sx = std::min(blockX * 4 + x, level.width - 1);
+            const uint8_t* pixel = &level.pixels[(static_cast<size_t>(sy) * level.width + sx) * 4];
+            for (int c = 0; c < 4; ++c) {
+                block.channel[c][y * 4 + x] = pixel[c];
+            }
+        }
+    }
+}
+
+// Quantize t in [0, steps] for 16 pixels given per-channel projection
+// onto the segment start + t * direction
+void projectIndices(const BlockPixels& block, int channelCount, const int* channels,
+                    const float* start, const float* direction, float steps, int* out) {
+    float lengthSquared = 0.0f;
+    for (int i = 0; i < channelCount; ++i) {
+        lengthSquared += direction[i] * direction[i];
+    }
+    float scale = lengthSquared > 0.0f ? steps / lengthSquared : 0.0f;
+
+    const Float4 zero(0.0f), top(steps), half(0.5f);
+    for (int p = 0; p < 16; p += 4) {
+        Float4 dot;
+        for (int i = 0; i < channelCount; ++i) {
+            Float4 value = Float4::load(&block.channel[channels[i]][p]);
+            dot = madd(value - Float4(start[i]), Float4(direction[i]), dot);
+        }
+        Float4 t = min(max(dot * Float4(scale), zero), top) + half;
+        alignas(16) float result[4];
+        t.store(result);
+        for (int k = 0; k < 4; ++k) {
+            out[p + k] = static_cast<int>(result[k]);
+        }
+    }
+}
+
+// BC1
+
+uint16_t packRgb565(const float* color) {
+    int r = std::clamp(static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+    int g = std::clamp(static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+    int b = std::clamp(static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpackRgb565(uint16_t packed, float* color) {
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = static_cast<float>((r << 3) | (r >> 2));
+    color[1] = static_cast<float>((g << 2) | (g >> 4));
+    color[2] = static_cast<float>((b << 3) | (b >> 2));
+}
+
+// Position along c0->c1 (0..3) to BC1 4-colour palette index
+const int kBc1Order[4] = { 0, 2, 3, 1 };
+
+struct Bc1Candidate {
+    uint16_t color0;
+    uint16_t color1;
+    uint32_t indices;
+    float error;
+};
+
+Bc1Candidate evaluateBc1(const BlockPixels& block, uint16_t color0, uint16_t color1) {
+    if (color0 < color1) std::swap(color0, color1);
+
+    Bc1Candidate candidate = { color0, color1, 0, 0.0f };
+    float c0[3], c1[3];
+    unpackRgb565(color0, c0);
+    unpackRgb565(color1, c1);
+
+    int positions[16] = {};
+    if (color0 != color1) {
+        static const int rgb[3] = { 0, 1, 2 };
+        float direction[3] = { c1[0] - c0[0], c1[1] - c0[1], c1[2] - c0[2] };
+        projectIndices(block, 3, rgb, c0, direction, 3.0f, positions);
+    }
+
+    for (int p = 0; p < 16; ++p) {
+        float t = positions[p] / 3.0f;
+        for (int c = 0; c < 3; ++c) {
+            float value = c0[c] + (c1[c] - c0[c]) * t;
+            float diff = block.channel[c][p] - value;
+            candidate.error += diff * diff;
+        }
+        candidate.indices |= static_cast<uint32_t>(kBc1Order[positions[p]]) << (p * 2);
+    }
+    return candidate;
+}
+
+void encodeBc1(const BlockPixels& block, uint8_t* out) {
+    // Principal axis of the colours by power iteration on the covariance
+    float mean[3] = {};
+    for (int c = 0; c < 3; ++c) {
+        for (int p = 0; p < 16; ++p) mean[c] += block.channel[c][p];
+        mean[c] /= 16.0f;
+    }
+
+    float cov[6] = {};
+    for (int p = 0; p < 16; ++p) {
+        float r = block.channel[0][p] - mean[0];
+        float g = block.channel[1][p] - mean[1];
+        float b = block.channel[2][p] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 4; ++iteration) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float length = std::max({ std::fabs(x), std::fabs(y), std::fabs(z) });
+        if (length <= 0.0f) break;
+        axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+    }
+
+    float minProjection = std::numeric_limits<float>::max();
+    float maxProjection = std::numeric_limits<float>::lowest();
+    for (int p = 0; p < 16; ++p) {
+        float projection = (block.channel[0][p] - mean[0]) * axis[0] +
+                           (block.channel[1][p] - mean[1]) * axis[1] +
+                           (block.channel[2][p] - mean[2]) * axis[2];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+
+    // Endpoints on the axis, inset by 1/16 of the range to reduce error
+    // from the interpolated palette entries
+    float inset = (maxProjection - minProjection) / 16.0f;
+    float e0[3], e1[3];
+    for (int c = 0; c < 3; ++c) {
+        e0[c] = std::clamp(mean[c] + axis[c] * (maxProjection - inset), 0.0f, 255.0f);
+        e1[c] = std::clamp(mean[c] + axis[c] * (minProjection + inset), 0.0f, 255.0f);
+    }
+
+    Bc1Candidate best = evaluateBc1(block, packRgb565(e0), packRgb565(e1));
+
+    // One least-squares refinement of the endpoints for the chosen indices
+    if (best.color0 != best.color1) {
+        float aa = 0, ab = 0, bb = 0, ax[3] = {}, bx[3] = {};
+        for (int p = 0; p < 16; ++p) {
+            int index = (best.indices >> (p * 2)) & 3;
+            static const float kWeight[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+            float alpha = kWeight[index], beta = 1.0f - alpha;
+            aa += alpha * alpha; ab += alpha * beta; bb += beta * beta;
+            for (int c = 0; c < 3; ++c) {
+                ax[c] += alpha * block.channel[c][p];
+                bx[c] += beta * block.channel[c][p];
+            }
+        }
+        float determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) > 1e-6f) {
+            float r0[3], r1[3];
+            for (int c = 0; c < 3; ++c) {
+                r0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+                r1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+            }
+            Bc1Candidate refined = evaluateBc1(block, packRgb565(r0), packRgb565(r1));
+            if (refined.error < best.error) best = refined;
+        }
+    }
+
+    if (best.color0 == best.color1) {
+        best.indices = 0;
+    }
+
+    out[0] = static_cast<uint8_t>(best.color0 & 0xFF);
+    out[1] = static_cast<uint8_t>(best.color0 >> 8);
+    out[2] = static_cast<uint8_t>(best.color1 & 0xFF);
+    out[3] = static_cast<uint8_t>(best.color1 >> 8);
+    std::memcpy(out + 4, &best.indices, 4);
+}
+
+// BC4 (also the alpha half of BC3 and both halves of BC5)
+
+// Position along r0->r1 (0..7) to BC4 8-value palette index
+const int kBc4Order[8] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+void encodeBc4(const BlockPixels& block, int channel, uint8_t* out) {
+    float low = 255.0f, high = 0.0f;
+    for (int p = 0; p < 16; ++p) {
+        low = std::min(low, block.channel[channel][p]);
+        high = std::max(high, block.channel[channel][p]);
+    }
+
+    uint8_t r0 = static_cast<uint8_t>(high + 0.5f);
+    uint8_t r1 = static_cast<uint8_t>(low + 0.5f);
+    out[0] = r0;
+    out[1] = r1;
+
+    uint64_t bits = 0;
+    if (r0 != r1) {
+        int positions[16];
+        float start = r0, direction = static_cast<float>(r1) - static_cast<float>(r0);
+        projectIndices(block, 1, &channel, &start, &direction, 7.0f, positions);
+        for (int p = 0; p < 16; ++p) {
+            bits |= static_cast<uint64_t>(kBc4Order[positions[p]]) << (p * 3);
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+}
+
+void decodeBc1(const uint8_t* in, uint8_t* pixels, int stride) {
+    uint16_t color0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    uint16_t color1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    float palette[4][3];
+    unpackRgb565(color0, palette[0]);
+    unpackRgb565(color1, palette[1]);
+    bool fourColor = color0 > color1;
+    for (int c = 0; c < 3; ++c) {
+        if (fourColor) {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2.0f;
+            palette[3][c] = 0.0f;
+        }
+    }
+
+    uint32_t indices;
+    std::memcpy(&indices, in + 4, 4);
+    for (int p = 0; p < 16; ++p) {
+        int index = (indices >> (p * 2)) & 3;
+        uint8_t* pixel = pixels + (p / 4) * stride + (p % 4) * 4;
+        for (int c = 0; c < 3; ++c) {
+            pixel[c] = static_cast<uint8_t>(palette[index][c] + 0.5f);
+        }
+        pixel[3] = (!fourColor && index == 3) ? 0 : 255;
+    }
+}
+
+void decodeBc4(const uint8_t* in, uint8_t* pixels, int stride, int channel) {
+    float palette[8];
+    palette[0] = in[0];
+    palette[1] = in[1];
+    if (in[0] > in[1]) {
+        for (int i = 1; i < 7; ++i) palette[i + 1] = ((7 - i) * palette[0] + i * palette[1]) / 7.0f;
+    } else {
+        for (int i = 1; i < 5; ++i) palette[i + 1] = ((5 - i) * palette[0] + i * palette[1]) / 5.0f;
+        palette[6] = 0.0f;
+        palette[7] = 255.0f;
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; ++i) bits |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+    for (int p = 0; p < 16; ++p) {
+        int index = static_cast<int>((bits >> (p * 3)) & 7);
+        pixels[(p / 4) * stride + (p % 4) * 4 + channel] = static_cast<uint8_t>(palette[index] + 0.5f);
+    }
+}
+
+} // namespace
+
+size_t getBlockBytes(BlockFormat format) {
+    return (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8 : 16;
+}
+
+size_t getCompressedSize(BlockFormat format, int width, int height) {
+    size_t blocksX = static_cast<size_t>((width + 3) / 4);
+    size_t blocksY = static_cast<size_t>((height + 3) / 4);
+    return blocksX * blocksY * getBlockBytes(format);
+}
+
+void compressLevel(const TextureLevel& level, BlockFormat format, std::vector<uint8_t>& out, JobSystem* jobs) {
+    int blocksX = (level.width + 3) / 4;
+    int blocksY = (level.height + 3) / 4;
+    size_t blockBytes = getBlockBytes(format);
+    out.resize(getCompressedSize(format, level.width, level.height));
+
+    auto encodeRows = [&](size_t begin, size_t end) {
+        BlockPixels block;
+        for (size_t by = begin; by < end; ++by) {
+            for (int bx = 0; bx < blocksX; ++bx) {
+                loadBlock(level, bx, static_cast<int>(by), block);
+                uint8_t* dst = out.data() + (by * blocksX + bx) * blockBytes;
+                switch (format) {
+                    case BlockFormat::BC1:
+                        encodeBc1(block, dst);
+                        break;
+                    case BlockFormat::BC3:
+                        encodeBc4(block, 3, dst);
+                        encodeBc1(block, dst + 8);
+                        break;
+                    case BlockFormat::BC4:
+                        encodeBc4(block, 0, dst);
+                        break;
+                    case BlockFormat::BC5:
+                        encodeBc4(block, 0, dst);
+                        encodeBc4(block, 1, dst + 8);
+                        break;
+                }
+            }
+        }
+    };
+
+    if (jobs) {
+        jobs->parallelFor(static_cast<size_t>(blocksY), encodeRows, 4);
+    } else {
+        encodeRows(0, static_cast<size_t>(blocksY));
+    }
+}
+
+void decompressLevel(BlockFormat format, const uint8_t* data, int width, int height, TextureLevel& out) {
+    int blocksX = (width + 3) / 4;
+    int blocksY = (height + 3) / 4;
+    size_t blockBytes = getBlockBytes(format);
+
+    // Decode into a block-aligned scratch image, then crop
+    int paddedWidth = blocksX * 4;
+    std::vector<uint8_t> padded(static_cast<size_t>(paddedWidth) * blocksY * 4 * 4, 0);
+    int stride = paddedWidth * 4;
+
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            const uint8_t* block = data + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+            uint8_t* pixels = padded.data() + static_cast<size_t>(by) * 4 * stride + bx * 16;
+            switch (format) {
+                case BlockFormat::BC1:
+                    decodeBc1(block, pixels, stride);
+                    break;
+                case BlockFormat::BC3:
+                    decodeBc1(block + 8, pixels, stride);
+                    decodeBc4(block, pixels, stride, 3);
+                    break;
+                case BlockFormat::BC4:
+                    decodeBc4(block, pixels, stride, 0);
+                    break;
+                case BlockFormat::BC5:
+                    decodeBc4(block, pixels, stride, 0);
+                    decodeBc4(block + 8, pixels, stride, 1);
+                    break;
+            }
+        }
+    }
+
+    out.width = width;
+    out.height = height;
+    out.pixels.resize(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(&out.pixels[static_cast<size_t>(y) * width * 4], &padded[static_cast<size_t>(y) * stride],
+                    static_cast<size_t>(width) * 4);
+    }
+}
+
+double computePsnr(const TextureLevel& reference, const TextureLevel& test, int channelCount) {
+    double squaredError = 0.0;
+    size_t samples = 0;
+    size_t pixels = std::min(reference.pixels.size(), test.pixels.size()) / 4;
+    for (size_t i = 0; i < pixels; ++i) {
+        for (int c = 0; c < channelCount; ++c) {
+            double diff = static_cast<double>(reference.pixels[i * 4 + c]) - test.pixels[i * 4 + c];
+            squaredError += diff * diff;
+            ++samples;
+        }
+    }
+    if (samples == 0 || squaredError == 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double mse = squaredError / samples;
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
@@ -0,0 +1,99 @@
+#include "graphics/ClusteredLighting.h"
+#include "graphics/ShaderProgram.h"
+
+namespace {
+
+// Respecify the whole buffer each frame so the driver can hand out fresh
+// storage instead of waiting for last frame's draws
+void uploadBuffer(GLuint buffer, const void* data, size_t size) {
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    // Keep at least one element so the buffer texture stays complete
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(size > 0 ? size : 16), size > 0 ? data : nullptr, GL_STREAM_DRAW);
+}
+
+const char* kClusteredLightingSource = R"(
+uniform samplerBuffer uClusterLights;     // Two texels per light
+uniform usamplerBuffer uClusterCells;     // (offset, count) per cluster
+uniform usamplerBuffer uClusterIndices;
+uniform vec3 uClusterGrid;                // Tiles x, tiles y, slices
+uniform vec2 uClusterDepth;               // slice = log(depth) * x + y
+uniform vec2 uClusterViewport;
+
+vec3 evaluateClusteredLights(vec3 worldPosition, vec3 normal, vec3 albedo, float viewDepth) {
+    ivec3 grid = ivec3(uClusterGrid);
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / uClusterViewport * uClusterGrid.xy), ivec2(0), grid.xy - 1);
+    int slice = clamp(int(log(viewDepth) * uClusterDepth.x + uClusterDepth.y), 0, grid.z - 1);
+    uvec2 cell = texelFetch(uClusterCells, (slice * grid.y + tile.y) * grid.x + tile.x).xy;
+
+    vec3 n = normalize(normal);
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < cell.y; ++i) {
+        int light = int(texelFetch(uClusterIndices, int(cell.x + i)).x);
+        vec4 positionRadius = texelFetch(uClusterLights, light * 2);
+        vec4 colorIntensity = texelFetch(uClusterLights, light * 2 + 1);
+
+        vec3 toLight = positionRadius.xyz - worldPosition;
+        float distance = length(toLight);
+        // Inverse square with a window that reaches zero at the radius
+        float window = clamp(1.0 - pow(distance / positionRadius.w, 4.0), 0.0, 1.0);
+        float attenuation = window * window / (distance * distance + 1.0);
+        float lambert = max(dot(n, toLight / max(distance, 1e-4)), 0.0);
+        result += albedo * colorIntensity.rgb * (colorIntensity.a * lambert * attenuation);
+    }
+    return result;
+}
+)";
+
+} // namespace
+
+ClusteredLighting::ClusteredLighting()
+    : m_tilesX(1), m_tilesY(1), m_slices(1), m_depthScale(0.0f), m_depthBias(0.0f) {
+    glGenBuffers(BufferCount, m_buffers);
+    glGenTextures(BufferCount, m_textures);
+
+    const GLenum formats[BufferCount] = { GL_RGBA32F, GL_RG32UI, GL_R16UI };
+    for (int i = 0; i < BufferCount; ++i) {
+        uploadBuffer(m_buffers[i], nullptr, 0);
+        glBindTexture(GL_TEXTURE_BUFFER, m_textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], m_buffers[i]);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+ClusteredLighting::~ClusteredLighting() {
+    glDeleteTextures(BufferCount, m_textures);
+    glDeleteBuffers(BufferCount, m_buffers);
+}
+
+void ClusteredLighting::upload(const LightClusterGrid& grid, const PointLight* lights, size_t lightCount) {
+    uploadBuffer(m_buffers[Lights], lights, lightCount * sizeof(PointLight));
+    uploadBuffer(m_buffers[Cells], grid.getCells().data(), grid.getCells().size() * sizeof(LightClusterCell));
+    uploadBuffer(m_buffers[Indices], grid.getIndices().data(), grid.getIndices().size() * sizeof(uint16_t));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    m_tilesX = grid.getTilesX();
+    m_tilesY = grid.getTilesY();
+    m_slices = grid.getSlices();
+    m_depthScale = grid.getDepthScale();
+    m_depthBias = grid.getDepthBias();
+}
+
+void ClusteredLighting::bind(ShaderProgram& shader, int viewportWidth, int viewportHeight, int firstUnit) const {
+    const char* samplers[BufferCount] = { "uClusterLights", "uClusterCells", "uClusterIndices" };
+    for (int i = 0; i < BufferCount; ++i) {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, m_textures[i]);
+        shader.setUniform(samplers[i], firstUnit + i);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.setUniform("uClusterGrid", glm::vec3(static_cast<float>(m_tilesX), static_cast<float>(m_tilesY),
+                                                static_cast<float>(m_slices)));
+    shader.setUniform("uClusterDepth", glm::vec2(m_depthScale, m_depthBias));
+    shader.setUniform("uClusterViewport", glm::vec2(static_cast<float>(viewportWidth), static_cast<float>(viewportHeight)));
+}
+
+const char* ClusteredLighting::getShaderSource() {
+    return kClusteredLightingSource;
+}
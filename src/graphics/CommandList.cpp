@@ -0,0 +1,80 @@
+#include "graphics/CommandList.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+CommandList::CommandList(size_t arenaBlockSize)
+    : m_arena(arenaBlockSize, alignof(std::max_align_t)) {
+    m_commands.reserve(1024);
+}
+
+void CommandList::draw(const DrawCommand& command) {
+    DrawCommand* stored = m_arena.allocArray<DrawCommand>(1);
+    *stored = command;
+    m_commands.push_back(stored);
+}
+
+const void* CommandList::storeConstants(const void* data, size_t size) {
+    void* stored = m_arena.alloc(size, 16);
+    std::memcpy(stored, data, size);
+    return stored;
+}
+
+void CommandList::sort() {
+    std::stable_sort(m_commands.begin(), m_commands.end(),
+        [](const DrawCommand* a, const DrawCommand* b) { return a->sortKey < b->sortKey; });
+}
+
+void CommandList::reset() {
+    m_commands.clear();
+    m_arena.reset();
+}
+
+void recordCommandLists(JobSystem& jobs, std::vector<CommandList>& lists, size_t itemCount,
+                        const CommandRecordFunction& recordFunction) {
+    jobs.parallelFor(itemCount, [&](size_t begin, size_t end) {
+        int thread = jobs.getCurrentThreadIndex();
+        recordFunction(lists[thread], begin, end);
+    });
+
+    jobs.parallelFor(lists.size(), [&lists](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            lists[i].sort();
+        }
+    }, 1);
+}
+
+void mergeCommandLists(const std::vector<CommandList>& lists, std::vector<const DrawCommand*>& merged) {
+    merged.clear();
+
+    size_t total = 0;
+    for (const auto& list : lists) {
+        total += list.size();
+    }
+    merged.reserve(total);
+
+    struct Cursor {
+        const std::vector<DrawCommand*>* commands;
+        size_t index;
+    };
+    auto greater = [](const Cursor& a, const Cursor& b) {
+        return (*a.commands)[a.index]->sortKey > (*b.commands)[b.index]->sortKey;
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(greater)> heap(greater);
+
+    for (const auto& list : lists) {
+        if (list.size() > 0) {
+            heap.push({ &list.getCommands(), 0 });
+        }
+    }
+
+    while (!heap.empty()) {
+        Cursor cursor = heap.top();
+        heap.pop();
+        merged.push_back((*cursor.commands)[cursor.index]);
+        if (++cursor.index < cursor.commands->size()) {
+            heap.push(cursor);
+        }
+    }
+}
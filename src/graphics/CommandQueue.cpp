@@ -0,0 +1,102 @@
+#include "graphics/CommandQueue.h"
+#include "graphics/StreamBuffer.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+#include <cstring>
+#include <glad/glad.h>
+
+static GLenum toGLPrimitive(DrawCommand::Primitive primitive) {
+    switch (primitive) {
+        case DrawCommand::Primitive::Lines:  return GL_LINES;
+        case DrawCommand::Primitive::Points: return GL_POINTS;
+        default:                             return GL_TRIANGLES;
+    }
+}
+
+CommandQueue::CommandQueue(JobSystem& jobs) : m_jobs(jobs) {
+    m_lists.resize(jobs.getThreadCount());
+}
+
+void CommandQueue::record(size_t itemCount, const RecordFunction& recordFunction) {
+    recordCommandLists(m_jobs, m_lists, itemCount, recordFunction);
+}
+
+CommandQueue::Stats CommandQueue::execute(StreamBuffer* constantBuffer) {
+    mergeCommandLists(m_lists, m_merged);
+
+    Stats stats;
+    GLuint currentProgram = 0;
+    GLuint currentVertexArray = 0;
+
+    GLint uboAlignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboAlignment);
+    const size_t alignment = static_cast<size_t>(uboAlignment);
+
+    // Pack every draw's constants into one mapping for the whole queue
+    // rather than mapping the stream buffer once per draw
+    StreamBuffer::Allocation constants = { nullptr, 0, 0 };
+    if (constantBuffer) {
+        size_t total = 0;
+        m_constantOffsets.resize(m_merged.size());
+        for (size_t i = 0; i < m_merged.size(); ++i) {
+            if (m_merged[i]->constants) {
+                m_constantOffsets[i] = total;
+                total = (total + m_merged[i]->constantsSize + alignment - 1) / alignment * alignment;
+            }
+        }
+        if (total > 0) {
+            constants = constantBuffer->map(total, alignment);
+            for (size_t i = 0; i < m_merged.size(); ++i) {
+                if (m_merged[i]->constants) {
+                    std::memcpy(static_cast<char*>(constants.data) + m_constantOffsets[i], m_merged[i]->constants,
+                                m_merged[i]->constantsSize);
+                }
+            }
+            constantBuffer->unmap();
+        }
+    }
+
+    for (size_t i = 0; i < m_merged.size(); ++i) {
+        const DrawCommand* command = m_merged[i];
+        if (command->program != currentProgram) {
+            glUseProgram(command->program);
+            currentProgram = command->program;
+            ++stats.programChanges;
+        }
+        if (command->vertexArray != currentVertexArray) {
+            glBindVertexArray(command->vertexArray);
+            currentVertexArray = command->vertexArray;
+            ++stats.vertexArrayChanges;
+        }
+
+        if (command->constants && constants.size > 0) {
+            StreamBuffer::Allocation range = { nullptr, constants.offset + static_cast<GLintptr>(m_constantOffsets[i]),
+                                               static_cast<GLsizeiptr>(command->constantsSize) };
+            constantBuffer->bindRange(GL_UNIFORM_BUFFER, kDrawConstantsBinding, range);
+            stats.constantBytes += command->constantsSize;
+        }
+
+        GLenum mode = toGLPrimitive(command->primitive);
+        GLsizei instances = static_cast<GLsizei>(std::max(1u, command->instanceCount));
+
+        if (command->indexType == DrawCommand::IndexType::None) {
+            glDrawArraysInstanced(mode, command->first, command->count, instances);
+        } else {
+            GLenum indexType = command->indexType == DrawCommand::IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            size_t indexSize = command->indexType == DrawCommand::IndexType::UInt16 ? 2 : 4;
+            const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(command->first) * indexSize);
+            glDrawElementsInstancedBaseVertex(mode, command->count, indexType, offset, instances, command->baseVertex);
+        }
+        ++stats.draws;
+    }
+
+    glBindVertexArray(0);
+    return stats;
+}
+
+void CommandQueue::reset() {
+    for (auto& list : m_lists) {
+        list.reset();
+    }
+    m_merged.clear();
+}
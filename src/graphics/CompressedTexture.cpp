@@ -0,0 +1,288 @@
+#include "graphics/CompressedTexture.h"
+#include "core/AsyncFile.h"
+#include "core/Hash.h"
+#include "graphics/GLExecutor.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// S3TC enums come from EXT_texture_compression_s3tc / EXT_texture_sRGB,
+// which the loader may not have generated
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+static constexpr uint64_t kLevelAlignment = 16;
+
+static bool hasExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension && std::strcmp(extension, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// BC4/BC5 (RGTC) are core; BC1/BC3 need S3TC, and their sRGB variants
+// EXT_texture_sRGB on top. Queried once on the GL thread.
+static bool isUploadSupported(BlockFormat format, bool srgb) {
+    if (format != BlockFormat::BC1 && format != BlockFormat::BC3) {
+        return true;
+    }
+    static const bool s3tc = hasExtension("GL_EXT_texture_compression_s3tc");
+    static const bool s3tcSrgb = s3tc && hasExtension("GL_EXT_texture_sRGB");
+    static bool warned = false;
+    bool supported = srgb ? s3tcSrgb : s3tc;
+    if (!supported && !warned) {
+        std::cerr << "S3TC textures are not supported here; uploading them uncompressed" << std::endl;
+        warned = true;
+    }
+    return supported;
+}
+
+// Unique per cook, so concurrent cooks of the same key (threads or
+// processes sharing a cache directory) never write the same file
+static std::string makeTemporaryPath(const std::string& outputPath) {
+    static const uint32_t processTag = std::random_device{}();
+    static std::atomic<uint32_t> sequence{0};
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%08x-%u.tmp", processTag, sequence.fetch_add(1, std::memory_order_relaxed));
+    return outputPath + suffix;
+}
+
+uint64_t computeTextureCacheKey(const uint8_t* source, size_t size, const CompressedTextureOptions& options) {
+    uint64_t hash = hashBytes(source, size);
+    uint32_t settings[4] = {
+        kCompressedTextureVersion,
+        static_cast<uint32_t>(options.format),
+        options.srgb ? 1u : 0u,
+        static_cast<uint32_t>(options.filter)
+    };
+    return hashBytes(settings, sizeof(settings), hash);
+}
+
+bool cookCompressedTexture(const uint8_t* source, size_t size, const CompressedTextureOptions& options,
+                           const std::string& outputPath, JobSystem* jobs) {
+    TextureData data;
+    // Only colour formats are gamma-encoded; BC4/BC5 hold linear data
+    data.srgb = options.srgb && (options.format == BlockFormat::BC1 || options.format == BlockFormat::BC3);
+    if (!decodeImage(source, size, data)) {
+        return false;
+    }
+    generateMipChain(data, options.filter, jobs);
+
+    std::vector<std::vector<uint8_t>> blobs(data.levels.size());
+    for (size_t level = 0; level < data.levels.size(); ++level) {
+        compressLevel(data.levels[level], options.format, blobs[level], jobs);
+    }
+
+    CompressedTextureHeader header = {};
+    std::memcpy(header.magic, kCompressedTextureMagic, sizeof(header.magic));
+    header.version = kCompressedTextureVersion;
+    header.format = options.format;
+    header.width = static_cast<uint32_t>(data.getWidth());
+    header.height = static_cast<uint32_t>(data.getHeight());
+    header.levelCount = static_cast<uint32_t>(data.levels.size());
+    header.srgb = data.srgb ? 1 : 0;
+    header.cacheKey = computeTextureCacheKey(source, size, options);
+
+    std::vector<CompressedTextureLevel> levels(data.levels.size());
+    uint64_t offset = sizeof(header) + sizeof(CompressedTextureLevel) * levels.size();
+    for (size_t level = 0; level < levels.size(); ++level) {
+        offset = (offset + kLevelAlignment - 1) & ~(kLevelAlignment - 1);
+        levels[level].width = static_cast<uint32_t>(data.levels[level].width);
+        levels[level].height = static_cast<uint32_t>(data.levels[level].height);
+        levels[level].offset = offset;
+        levels[level].size = blobs[level].size();
+        offset += blobs[level].size();
+    }
+
+    // Write to a temporary name and rename, so a crash never leaves a
+    // truncated file that looks like a valid cache entry
+    std::string temporaryPath = makeTemporaryPath(outputPath);
+    std::error_code error;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to create texture cache file: " << temporaryPath << std::endl;
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(sizeof(CompressedTextureLevel) * levels.size()));
+        static const char padding[kLevelAlignment] = {};
+        uint64_t written = sizeof(header) + sizeof(CompressedTextureLevel) * levels.size();
+        for (size_t level = 0; level < levels.size(); ++level) {
+            file.write(padding, static_cast<std::streamsize>(levels[level].offset - written));
+            file.write(reinterpret_cast<const char*>(blobs[level].data()), static_cast<std::streamsize>(blobs[level].size()));
+            written = levels[level].offset + levels[level].size;
+        }
+
+        if (!file.good()) {
+            std::cerr << "Failed to write texture cache file: " << temporaryPath << std::endl;
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    // Renaming over an entry another cook just finished is fine: both
+    // files hold the same bytes
+    std::filesystem::rename(temporaryPath, outputPath, error);
+    if (error) {
+        std::cerr << "Failed to move texture cache file into place: " << outputPath << std::endl;
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool CompressedTextureFile::open(const std::string& path) {
+    // Opening unmaps any previous file, even when it fails
+    m_header = nullptr;
+    m_levels = nullptr;
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    if (m_file.size() < sizeof(CompressedTextureHeader)) {
+        m_file.close();
+        return false;
+    }
+
+    const size_t size = m_file.size();
+    m_header = reinterpret_cast<const CompressedTextureHeader*>(m_file.data());
+    m_levels = reinterpret_cast<const CompressedTextureLevel*>(m_file.data() + sizeof(CompressedTextureHeader));
+
+    const BlockFormat format = m_header->format;
+    bool valid = std::memcmp(m_header->magic, kCompressedTextureMagic, sizeof(m_header->magic)) == 0 &&
+                 m_header->version == kCompressedTextureVersion &&
+                 (format == BlockFormat::BC1 || format == BlockFormat::BC3 ||
+                  format == BlockFormat::BC4 || format == BlockFormat::BC5) &&
+                 m_header->width > 0 && m_header->height > 0 &&
+                 m_header->levelCount > 0 && m_header->levelCount <= 32 &&
+                 sizeof(CompressedTextureHeader) + sizeof(CompressedTextureLevel) * m_header->levelCount <= size;
+    // Levels must follow the header's mip chain, so the sizes handed to
+    // glCompressedTexImage2D match the data behind them
+    for (uint32_t level = 0; valid && level < m_header->levelCount; ++level) {
+        const CompressedTextureLevel& info = m_levels[level];
+        valid = info.width == std::max(1u, m_header->width >> level) &&
+                info.height == std::max(1u, m_header->height >> level) &&
+                info.offset <= size && info.size <= size - info.offset &&
+                info.size == getCompressedSize(format, static_cast<int>(info.width), static_cast<int>(info.height));
+    }
+
+    if (!valid) {
+        std::cerr << "Texture cache file is invalid or from another version: " << path << std::endl;
+        m_file.close();
+        m_header = nullptr;
+        m_levels = nullptr;
+        return false;
+    }
+    return true;
+}
+
+GLenum getBlockFormatGLInternalFormat(BlockFormat format, bool srgb) {
+    switch (format) {
+        case BlockFormat::BC1: return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case BlockFormat::BC3: return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case BlockFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+        case BlockFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+    }
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+CompressedTexture::CompressedTexture(const CompressedTextureFile& file, int firstLevel)
+    : m_id(0), m_byteSize(0), m_uncompressedByteSize(0) {
+    const CompressedTextureHeader& header = file.getHeader();
+    GLenum internalFormat = getBlockFormatGLInternalFormat(header.format, header.srgb != 0);
+    bool compressed = isUploadSupported(header.format, header.srgb != 0);
+    int levelCount = static_cast<int>(header.levelCount);
+    firstLevel = std::clamp(firstLevel, 0, levelCount - 1);
+
+    glGenTextures(1, &m_id);
+    glBindTexture(GL_TEXTURE_2D, m_id);
+
+    TextureLevel decoded;
+    for (int level = firstLevel; level < levelCount; ++level) {
+        const CompressedTextureLevel& info = file.getLevel(level);
+        size_t uncompressedBytes = static_cast<size_t>(info.width) * info.height * 4;
+        if (compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level - firstLevel, internalFormat,
+                                   static_cast<GLsizei>(info.width), static_cast<GLsizei>(info.height), 0,
+                                   static_cast<GLsizei>(info.size), file.getLevelData(level));
+            m_byteSize += info.size;
+        } else {
+            // Decode on the CPU and upload as RGBA8
+            decompressLevel(header.format, file.getLevelData(level), static_cast<int>(info.width),
+                            static_cast<int>(info.height), decoded);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexImage2D(GL_TEXTURE_2D, level - firstLevel, header.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+                         static_cast<GLsizei>(info.width), static_cast<GLsizei>(info.height), 0, GL_RGBA,
+                         GL_UNSIGNED_BYTE, decoded.pixels.data());
+            m_byteSize += uncompressedBytes;
+        }
+        m_uncompressedByteSize += uncompressedBytes;
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - firstLevel - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount - firstLevel > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+CompressedTexture::~CompressedTexture() {
+    if (m_id != 0) {
+        glDeleteTextures(1, &m_id);
+    }
+}
+
+void CompressedTexture::bind(int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, m_id);
+}
+
+Task<std::unique_ptr<CompressedTexture>> loadCompressedTexture(JobSystem& jobs, GLExecutor& gl, std::string path,
+                                                               std::string cacheDirectory,
+                                                               CompressedTextureOptions options) {
+    std::vector<uint8_t> source = co_await readFile(jobs, path);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.llrtex",
+                  static_cast<unsigned long long>(computeTextureCacheKey(source.data(), source.size(), options)));
+    std::string cachePath = (std::filesystem::path(cacheDirectory) / name).string();
+
+    CompressedTextureFile file;
+    if (!file.open(cachePath)) {
+        std::filesystem::create_directories(cacheDirectory);
+        if (!cookCompressedTexture(source.data(), source.size(), options, cachePath, &jobs) || !file.open(cachePath)) {
+            throw std::runtime_error("Failed to cook compressed texture: " + path);
+        }
+    }
+    source = {};
+
+    co_await gl.schedule();
+    co_return std::make_unique<CompressedTexture>(file);
+}
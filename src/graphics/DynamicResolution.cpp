@@ -0,0 +1,85 @@
+#include "graphics/DynamicResolution.h"
+#include "graphics/GpuProfiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+// Corrections smaller than this are not worth a visible resolution change
+constexpr float kMinimumChange = 0.02f;
+
+} // namespace
+
+DynamicResolution::DynamicResolution(DynamicResolutionSettings settings)
+    : m_settings(settings), m_smoothedMilliseconds(0.0), m_lastCollectedFrame(0), m_settling(0),
+      m_seeded(false), m_scaleSum(0.0) {
+    if (m_settings.targetMilliseconds <= 0.0 || m_settings.minScale <= 0.0f ||
+        m_settings.minScale > m_settings.maxScale) {
+        throw std::invalid_argument("DynamicResolution needs a positive target and 0 < minScale <= maxScale");
+    }
+    m_scale = m_settings.maxScale;
+    m_stats.minScale = m_scale;
+}
+
+bool DynamicResolution::update(const GpuProfiler& gpuProfiler) {
+    uint64_t collected = gpuProfiler.getCollectedFrameCount();
+    if (collected == m_lastCollectedFrame) {
+        return false;
+    }
+    m_lastCollectedFrame = collected;
+    return addSample(gpuProfiler.getLastFrameMilliseconds());
+}
+
+DynamicResolutionStats DynamicResolution::getStats() const {
+    DynamicResolutionStats stats = m_stats;
+    stats.averageScale = stats.samples ? m_scaleSum / static_cast<double>(stats.samples) : m_scale;
+    return stats;
+}
+
+bool DynamicResolution::addSample(double milliseconds) {
+    ++m_stats.samples;
+    m_scaleSum += m_scale;
+    if (m_settling > 0) {
+        --m_settling;
+        return false;
+    }
+    if (!m_seeded) {
+        m_smoothedMilliseconds = milliseconds;
+        m_seeded = true;
+    } else {
+        m_smoothedMilliseconds += (milliseconds - m_smoothedMilliseconds) * m_settings.smoothing;
+    }
+
+    const double target = m_settings.targetMilliseconds;
+    bool over = m_smoothedMilliseconds > target;
+    bool under = m_smoothedMilliseconds < target * m_settings.upscaleThreshold;
+    if (!over && !under) {
+        return false;
+    }
+    if ((over && m_scale <= m_settings.minScale) || (under && m_scale >= m_settings.maxScale)) {
+        return false;
+    }
+
+    // Aim for the middle of the band, not its edge, so the next small
+    // fluctuation does not cross it again
+    double aim = target * (1.0 + m_settings.upscaleThreshold) * 0.5;
+    float ratio = static_cast<float>(std::sqrt(aim / std::max(m_smoothedMilliseconds, 1e-3)));
+    ratio = std::clamp(ratio, m_settings.maxDecrease, m_settings.maxIncrease);
+    float scale = std::clamp(m_scale * ratio, m_settings.minScale, m_settings.maxScale);
+    if (std::abs(scale - m_scale) < kMinimumChange && scale != m_settings.minScale && scale != m_settings.maxScale) {
+        return false;
+    }
+
+    if (m_settings.logDecisions) {
+        std::cout << "Dynamic resolution: " << (over ? "down " : "up ") << m_scale << " -> " << scale << " (GPU "
+                  << m_smoothedMilliseconds << " ms, target " << target << " ms)" << std::endl;
+    }
+    m_scale = scale;
+    m_stats.minScale = std::min(m_stats.minScale, scale);
+    ++m_stats.changes;
+    m_settling = m_settings.settleSamples;
+    m_seeded = false;
+    return true;
+}
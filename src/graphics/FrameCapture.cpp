@@ -0,0 +1,175 @@
+#include "graphics/FrameCapture.h"
+#include "core/Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <stb_image_write.h>
+
+FrameCapture::FrameCapture(JobSystem& jobs, int width, int height, int slotCount)
+    : m_jobs(jobs), m_width(width), m_height(height),
+      m_frameBytes(static_cast<size_t>(width) * height * 4), m_sequence(0) {
+    if (width <= 0 || height <= 0 || slotCount < 1) {
+        throw std::invalid_argument("FrameCapture needs a positive size and at least one slot");
+    }
+
+    m_slots.resize(slotCount);
+    for (Slot& slot : m_slots) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(m_frameBytes), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+FrameCapture::~FrameCapture() {
+    flush();
+    for (Slot& slot : m_slots) {
+        glDeleteBuffers(1, &slot.buffer);
+    }
+}
+
+bool FrameCapture::capture(GLuint framebuffer, uint64_t frameIndex, Consumer consumer) {
+    LLR_PROFILE_FUNCTION();
+    auto free = std::find_if(m_slots.begin(), m_slots.end(), [](const Slot& slot) { return slot.fence == nullptr; });
+    if (free == m_slots.end()) {
+        ++m_stats.dropped;
+        return false;
+    }
+
+    // With a pack buffer bound glReadPixels only queues the copy
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, free->buffer);
+    GLint packAlignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    free->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    free->frameIndex = frameIndex;
+    free->sequence = m_sequence++;
+    free->consumer = std::move(consumer);
+    // Make sure the fence reaches the GPU so polling can see it signal
+    glFlush();
+
+    ++m_stats.captured;
+    return true;
+}
+
+void FrameCapture::update() {
+    LLR_PROFILE_FUNCTION();
+
+    // Fences signal in submission order, so stop at the first busy one
+    while (true) {
+        Slot* oldest = nullptr;
+        for (Slot& slot : m_slots) {
+            if (slot.fence && (!oldest || slot.sequence < oldest->sequence)) {
+                oldest = &slot;
+            }
+        }
+        if (!oldest) {
+            return;
+        }
+        GLenum status = glClientWaitSync(oldest->fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return;
+        }
+        deliver(*oldest);
+    }
+}
+
+void FrameCapture::flush() {
+    while (true) {
+        Slot* oldest = nullptr;
+        for (Slot& slot : m_slots) {
+            if (slot.fence && (!oldest || slot.sequence < oldest->sequence)) {
+                oldest = &slot;
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        glClientWaitSync(oldest->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        deliver(*oldest);
+    }
+    m_jobs.wait(m_consumers);
+}
+
+void FrameCapture::deliver(Slot& slot) {
+    std::unique_ptr<CapturedFrame> frame;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (!m_pool.empty()) {
+            frame = std::move(m_pool.back());
+            m_pool.pop_back();
+        }
+    }
+    if (!frame) {
+        frame = std::make_unique<CapturedFrame>();
+    }
+    frame->frameIndex = slot.frameIndex;
+    frame->width = m_width;
+    frame->height = m_height;
+    frame->rgba.resize(m_frameBytes);
+
+    // GL rows are bottom-up; copy out flipped so the slot is free again
+    // before any encoding starts
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const uint8_t* mapped = static_cast<const uint8_t*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(m_frameBytes), GL_MAP_READ_BIT));
+    if (mapped) {
+        size_t rowBytes = static_cast<size_t>(m_width) * 4;
+        for (int y = 0; y < m_height; ++y) {
+            std::memcpy(&frame->rgba[static_cast<size_t>(y) * rowBytes],
+                        mapped + static_cast<size_t>(m_height - 1 - y) * rowBytes, rowBytes);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        std::cerr << "Failed to map capture buffer for frame " << slot.frameIndex << std::endl;
+        frame->width = 0;
+        frame->height = 0;
+        frame->rgba.clear();
+        ++m_stats.failed;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    Consumer consumer = std::move(slot.consumer);
+    slot.consumer = nullptr;
+    if (!consumer) {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        m_pool.push_back(std::move(frame));
+        return;
+    }
+
+    // std::function needs a copyable callable, so ownership travels as a
+    // raw pointer and goes back to the pool when the consumer is done
+    CapturedFrame* raw = frame.release();
+    m_jobs.run([this, raw, consumer = std::move(consumer)]() {
+        LLR_PROFILE_SCOPE("Consume capture");
+        consumer(*raw);
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        m_pool.emplace_back(raw);
+    }, &m_consumers);
+    if (mapped) {
+        ++m_stats.delivered;
+    }
+}
+
+FrameCapture::Consumer FrameCapture::writePng(std::string prefix) {
+    return [prefix = std::move(prefix)](CapturedFrame& frame) {
+        if (!frame.isValid()) {
+            return;
+        }
+        char path[1024];
+        std::snprintf(path, sizeof(path), "%s%05llu.png", prefix.c_str(), static_cast<unsigned long long>(frame.frameIndex));
+        if (!stbi_write_png(path, frame.width, frame.height, 4, frame.rgba.data(), frame.width * 4)) {
+            std::cerr << "Failed to write " << path << std::endl;
+        }
+    };
+}
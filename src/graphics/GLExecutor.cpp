@@ -0,0 +1,37 @@
+#include "graphics/GLExecutor.h"
+#include <chrono>
+
+void GLExecutor::post(std::function<void()> work) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(std::move(work));
+}
+
+size_t GLExecutor::runPending(double budgetMilliseconds) {
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(budgetMilliseconds));
+
+    size_t executed = 0;
+    do {
+        std::function<void()> work;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_queue.empty()) {
+                break;
+            }
+            work = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        // Run outside the lock: work may post more work
+        work();
+        ++executed;
+    } while (Clock::now() < deadline);
+
+    return executed;
+}
+
+size_t GLExecutor::getQueuedCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
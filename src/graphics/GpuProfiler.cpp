@@ -0,0 +1,116 @@
+#include "graphics/GpuProfiler.h"
+#include <stdexcept>
+
+GpuProfiler::GpuProfiler(int latencyFrames, size_t maxScopesPerFrame)
+    : m_maxScopes(maxScopesPerFrame + 1), m_current(0), m_enabled(true), m_inFrame(false),
+      m_lastFrameMilliseconds(0.0), m_collectedFrames(0), m_droppedFrames(0) {
+    if (latencyFrames < 1) {
+        throw std::invalid_argument("GpuProfiler needs at least one frame of latency");
+    }
+
+    // Two timestamps per scope, plus the frame scope itself
+    m_frames.resize(latencyFrames);
+    for (Frame& frame : m_frames) {
+        frame.queries.resize(m_maxScopes * 2);
+        glGenQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        frame.scopes.reserve(m_maxScopes);
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (Frame& frame : m_frames) {
+        glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+    }
+}
+
+void GpuProfiler::beginFrame() {
+    if (!m_enabled) {
+        return;
+    }
+
+    m_current = (m_current + 1) % static_cast<int>(m_frames.size());
+    Frame& frame = m_frames[m_current];
+    if (frame.pending) {
+        collect(frame);
+    }
+
+    frame.scopes.clear();
+    frame.queryCount = 0;
+    frame.pending = false;
+    m_stack.clear();
+    m_inFrame = true;
+
+    // GL_TIMESTAMP read back directly is the GPU clock "now"; pairing it
+    // with the CPU clock lines both tracks up in the trace
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    frame.clockOffset = Profiler::now() - static_cast<int64_t>(gpuNow);
+
+    push("GPU Frame");
+}
+
+void GpuProfiler::endFrame() {
+    if (!m_inFrame) {
+        return;
+    }
+    while (!m_stack.empty()) {
+        pop();
+    }
+    m_frames[m_current].pending = true;
+    m_inFrame = false;
+}
+
+void GpuProfiler::push(const char* name) {
+    if (!m_inFrame) {
+        return;
+    }
+    Frame& frame = m_frames[m_current];
+    if (frame.scopes.size() >= m_maxScopes) {
+        m_stack.push_back(-1);
+        return;
+    }
+    uint32_t query = frame.queryCount++;
+    glQueryCounter(frame.queries[query], GL_TIMESTAMP);
+    m_stack.push_back(static_cast<int>(frame.scopes.size()));
+    frame.scopes.push_back({ name, query, 0 });
+}
+
+void GpuProfiler::pop() {
+    if (!m_inFrame || m_stack.empty()) {
+        return;
+    }
+    int scope = m_stack.back();
+    m_stack.pop_back();
+    if (scope < 0) {
+        return;
+    }
+    Frame& frame = m_frames[m_current];
+    uint32_t query = frame.queryCount++;
+    glQueryCounter(frame.queries[query], GL_TIMESTAMP);
+    frame.scopes[scope].endQuery = query;
+}
+
+void GpuProfiler::collect(Frame& frame) {
+    frame.pending = false;
+
+    // The last query issued completes last; if it is not there yet the
+    // frame is dropped rather than waited for
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(frame.queries[frame.queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        ++m_droppedFrames;
+        return;
+    }
+
+    for (const Scope& scope : frame.scopes) {
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(frame.queries[scope.startQuery], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.queries[scope.endQuery], GL_QUERY_RESULT, &end);
+        if (&scope == &frame.scopes.front()) {
+            m_lastFrameMilliseconds = static_cast<double>(end - start) / 1e6;
+        }
+        Profiler::recordGpu(scope.name, static_cast<int64_t>(start) + frame.clockOffset,
+                            static_cast<int64_t>(end) + frame.clockOffset);
+    }
+    ++m_collectedFrames;
+}
@@ -0,0 +1,279 @@
+#include "graphics/GpuResourceManager.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+struct TextureFormat {
+    GLenum internalFormat;
+    GLenum format;
+    GLenum type;
+    size_t bytesPerPixel;
+};
+
+// Formats createTexture2D can allocate; glTexImage2D on 4.1 needs a
+// matching client format even without data
+constexpr TextureFormat kTextureFormats[] = {
+    { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 },
+    { GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 },
+    { GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8 },
+    { GL_RGBA32F, GL_RGBA, GL_FLOAT, 16 },
+    { GL_RG8, GL_RG, GL_UNSIGNED_BYTE, 2 },
+    { GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1 },
+    { GL_R16F, GL_RED, GL_HALF_FLOAT, 2 },
+    { GL_R32F, GL_RED, GL_FLOAT, 4 },
+    { GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, 4 },
+    { GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT, 4 },
+};
+
+const TextureFormat* findTextureFormat(GLenum internalFormat) {
+    for (const TextureFormat& format : kTextureFormats) {
+        if (format.internalFormat == internalFormat) {
+            return &format;
+        }
+    }
+    return nullptr;
+}
+
+size_t typeIndex(GpuResourceType type) {
+    return static_cast<size_t>(type);
+}
+
+} // namespace
+
+GpuResourceManager::~GpuResourceManager() {
+    flush();
+    std::vector<GLuint> ids;
+    for (size_t type = 0; type < GpuResourceStats::kTypeCount; ++type) {
+        ids.clear();
+        for (const Slot& slot : m_pools[type].slots) {
+            if (slot.live) {
+                ids.push_back(slot.id);
+            }
+        }
+        deleteObjects(static_cast<GpuResourceType>(type), ids);
+    }
+}
+
+BufferHandle GpuResourceManager::createBuffer(size_t bytes, const void* data, GLenum usage) {
+    GLuint id = 0;
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(bytes), data, usage);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return adoptBuffer(id, bytes);
+}
+
+void GpuResourceManager::setBufferData(BufferHandle handle, size_t bytes, const void* data, GLenum usage) {
+    Slot* slot = findSlot(GpuResourceType::Buffer, handle.index, handle.generation);
+    if (!slot) {
+        throw std::invalid_argument("setBufferData on a destroyed buffer");
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, slot->id);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(bytes), data, usage);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    Pool& pool = m_pools[typeIndex(GpuResourceType::Buffer)];
+    pool.liveBytes = pool.liveBytes - slot->bytes + bytes;
+    slot->bytes = bytes;
+}
+
+TextureHandle GpuResourceManager::createTexture2D(int width, int height, int levelCount, GLenum internalFormat) {
+    const TextureFormat* format = findTextureFormat(internalFormat);
+    if (!format) {
+        throw std::invalid_argument("createTexture2D does not know this internal format");
+    }
+    if (width <= 0 || height <= 0 || levelCount < 1) {
+        throw std::invalid_argument("createTexture2D needs a positive size and at least one level");
+    }
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    for (int level = 0; level < levelCount; ++level) {
+        glTexImage2D(GL_TEXTURE_2D, level, static_cast<GLint>(internalFormat), std::max(1, width >> level),
+                     std::max(1, height >> level), 0, format->format, format->type, nullptr);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return adoptTexture(id, getTextureBytes(width, height, levelCount, internalFormat));
+}
+
+size_t GpuResourceManager::getTextureBytes(int width, int height, int levelCount, GLenum internalFormat) {
+    const TextureFormat* format = findTextureFormat(internalFormat);
+    if (!format) {
+        return 0;
+    }
+    size_t bytes = 0;
+    for (int level = 0; level < levelCount; ++level) {
+        bytes += static_cast<size_t>(std::max(1, width >> level)) * std::max(1, height >> level) * format->bytesPerPixel;
+    }
+    return bytes;
+}
+
+VertexArrayHandle GpuResourceManager::createVertexArray() {
+    GLuint id = 0;
+    glGenVertexArrays(1, &id);
+    uint32_t index = allocateSlot(GpuResourceType::VertexArray, id, 0);
+    return { index, m_pools[typeIndex(GpuResourceType::VertexArray)].slots[index].generation };
+}
+
+BufferHandle GpuResourceManager::adoptBuffer(GLuint id, size_t bytes) {
+    uint32_t index = allocateSlot(GpuResourceType::Buffer, id, bytes);
+    return { index, m_pools[typeIndex(GpuResourceType::Buffer)].slots[index].generation };
+}
+
+TextureHandle GpuResourceManager::adoptTexture(GLuint id, size_t bytes) {
+    uint32_t index = allocateSlot(GpuResourceType::Texture, id, bytes);
+    return { index, m_pools[typeIndex(GpuResourceType::Texture)].slots[index].generation };
+}
+
+ProgramHandle GpuResourceManager::adoptProgram(GLuint id) {
+    uint32_t index = allocateSlot(GpuResourceType::Program, id, 0);
+    return { index, m_pools[typeIndex(GpuResourceType::Program)].slots[index].generation };
+}
+
+const GpuResourceManager::Slot* GpuResourceManager::findSlot(GpuResourceType type, uint32_t index, uint32_t generation) const {
+    const Pool& pool = m_pools[typeIndex(type)];
+    if (generation == 0 || index >= pool.slots.size()) {
+        return nullptr;
+    }
+    const Slot& slot = pool.slots[index];
+    return slot.live && slot.generation == generation ? &slot : nullptr;
+}
+
+GpuResourceManager::Slot* GpuResourceManager::findSlot(GpuResourceType type, uint32_t index, uint32_t generation) {
+    return const_cast<Slot*>(static_cast<const GpuResourceManager*>(this)->findSlot(type, index, generation));
+}
+
+uint32_t GpuResourceManager::allocateSlot(GpuResourceType type, GLuint id, size_t bytes) {
+    if (id == 0) {
+        throw std::runtime_error("Failed to create GL object");
+    }
+    Pool& pool = m_pools[typeIndex(type)];
+    uint32_t index;
+    if (!pool.freeList.empty()) {
+        index = pool.freeList.back();
+        pool.freeList.pop_back();
+    } else {
+        index = static_cast<uint32_t>(pool.slots.size());
+        pool.slots.emplace_back();
+    }
+
+    Slot& slot = pool.slots[index];
+    slot.id = id;
+    slot.bytes = bytes;
+    slot.live = true;
+    ++pool.liveCount;
+    pool.liveBytes += bytes;
+    return index;
+}
+
+void GpuResourceManager::destroySlot(GpuResourceType type, uint32_t index, uint32_t generation) {
+    Slot* slot = findSlot(type, index, generation);
+    if (!slot) {
+        return;
+    }
+
+    m_pending.push_back({ type, slot->id, slot->bytes, m_frame });
+    m_pendingBytes += slot->bytes;
+
+    Pool& pool = m_pools[typeIndex(type)];
+    --pool.liveCount;
+    pool.liveBytes -= slot->bytes;
+    slot->id = 0;
+    slot->bytes = 0;
+    slot->live = false;
+    // Generation 0 marks null handles, so wrap past it
+    if (++slot->generation == 0) {
+        slot->generation = 1;
+    }
+    pool.freeList.push_back(index);
+}
+
+void GpuResourceManager::endFrame() {
+    m_fences.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), m_frame });
+    ++m_frame;
+
+    // Fences signal in order, so stop at the first one still pending
+    while (!m_fences.empty()) {
+        GLenum status = glClientWaitSync(m_fences.front().fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        m_retiredFrame = m_fences.front().frame;
+        glDeleteSync(m_fences.front().fence);
+        m_fences.pop_front();
+    }
+    deleteRetired();
+}
+
+void GpuResourceManager::flush() {
+    // Objects destroyed since the last endFrame belong to a frame without
+    // a fence yet
+    if (!m_pending.empty() && m_pending.back().frame == m_frame) {
+        m_fences.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), m_frame });
+        ++m_frame;
+    }
+    while (!m_fences.empty()) {
+        glClientWaitSync(m_fences.front().fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        m_retiredFrame = m_fences.front().frame;
+        glDeleteSync(m_fences.front().fence);
+        m_fences.pop_front();
+    }
+    deleteRetired();
+}
+
+void GpuResourceManager::deleteRetired() {
+    // Pending deletes are in frame order; gather the retired prefix by type
+    // so each type is one glDelete call
+    std::vector<GLuint> ids[GpuResourceStats::kTypeCount];
+    while (!m_pending.empty() && m_pending.front().frame <= m_retiredFrame) {
+        const PendingDelete& pending = m_pending.front();
+        ids[typeIndex(pending.type)].push_back(pending.id);
+        m_pendingBytes -= pending.bytes;
+        m_pending.pop_front();
+    }
+    for (size_t type = 0; type < GpuResourceStats::kTypeCount; ++type) {
+        m_deletedCount += ids[type].size();
+        deleteObjects(static_cast<GpuResourceType>(type), ids[type]);
+    }
+}
+
+void GpuResourceManager::deleteObjects(GpuResourceType type, std::vector<GLuint>& ids) {
+    if (ids.empty()) {
+        return;
+    }
+    GLsizei count = static_cast<GLsizei>(ids.size());
+    switch (type) {
+    case GpuResourceType::Buffer:
+        glDeleteBuffers(count, ids.data());
+        break;
+    case GpuResourceType::Texture:
+        glDeleteTextures(count, ids.data());
+        break;
+    case GpuResourceType::VertexArray:
+        glDeleteVertexArrays(count, ids.data());
+        break;
+    case GpuResourceType::Program:
+        for (GLuint id : ids) {
+            glDeleteProgram(id);
+        }
+        break;
+    case GpuResourceType::Count:
+        break;
+    }
+}
+
+GpuResourceStats GpuResourceManager::getStats() const {
+    GpuResourceStats stats;
+    for (size_t type = 0; type < GpuResourceStats::kTypeCount; ++type) {
+        stats.liveCount[type] = m_pools[type].liveCount;
+        stats.liveBytes[type] = m_pools[type].liveBytes;
+    }
+    stats.pendingCount = m_pending.size();
+    stats.pendingBytes = m_pendingBytes;
+    stats.deletedCount = m_deletedCount;
+    return stats;
+}
@@ -0,0 +1,452 @@
+#include "graphics/RenderGraph.h"
+#include "core/Profiler.h"
+#include "graphics/GpuProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Pooled textures survive this many frames without use, so a pass that is
+// toggled or culled for a moment does not reallocate its targets
+constexpr uint64_t kRetainFrames = 3;
+
+bool isDepthFormat(GLenum internalFormat) {
+    return internalFormat == GL_DEPTH_COMPONENT16 || internalFormat == GL_DEPTH_COMPONENT24 ||
+           internalFormat == GL_DEPTH_COMPONENT32F || internalFormat == GL_DEPTH24_STENCIL8;
+}
+
+} // namespace
+
+GLuint RenderGraph::PassContext::getTexture(RenderGraphTexture texture) const {
+    return m_graph.getGLTexture(texture.index);
+}
+
+const RenderGraphTextureDesc& RenderGraph::PassContext::getDesc(RenderGraphTexture texture) const {
+    return m_graph.m_textures.at(texture.index).desc;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(RenderGraphTexture texture) {
+    m_graph.m_passes[m_pass].reads.push_back(texture.index);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::writeColor(RenderGraphTexture texture, RenderGraphLoad load) {
+    m_graph.m_passes[m_pass].colorWrites.push_back({ texture.index, load });
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::writeDepth(RenderGraphTexture texture, RenderGraphLoad load) {
+    Pass& pass = m_graph.m_passes[m_pass];
+    pass.hasDepth = true;
+    pass.depthWrite = { texture.index, load };
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::setSideEffect() {
+    m_graph.m_passes[m_pass].sideEffect = true;
+    return *this;
+}
+
+RenderGraph::RenderGraph(GpuResourceManager& resources)
+    : m_resources(resources), m_frame(0), m_compiled(false) {}
+
+RenderGraph::~RenderGraph() {
+    for (auto& entry : m_framebuffers) {
+        glDeleteFramebuffers(1, &entry.second);
+    }
+    for (PooledTexture& pooled : m_pool) {
+        m_resources.destroy(pooled.handle);
+    }
+}
+
+void RenderGraph::reset() {
+    m_passes.clear();
+    m_textures.clear();
+    m_order.clear();
+    m_compiled = false;
+    ++m_frame;
+    releaseUnusedTextures();
+}
+
+RenderGraphTexture RenderGraph::createTexture(const char* name, const RenderGraphTextureDesc& desc) {
+    if (desc.width <= 0 || desc.height <= 0) {
+        throw std::invalid_argument("Render graph textures need a positive size");
+    }
+    m_textures.push_back({ name, desc });
+    return { static_cast<uint32_t>(m_textures.size() - 1) };
+}
+
+RenderGraphTexture RenderGraph::importTexture(const char* name, GLuint texture, const RenderGraphTextureDesc& desc) {
+    Texture imported{ name, desc };
+    imported.imported = texture;
+    m_textures.push_back(imported);
+    return { static_cast<uint32_t>(m_textures.size() - 1) };
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const char* name, ExecuteFunction execute) {
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+    m_compiled = false;
+    return PassBuilder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+}
+
+void RenderGraph::compile() {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<bool> live;
+    cull(live);
+    sortPasses(live);
+    allocateTextures();
+    m_compiled = true;
+
+    m_stats.passCount = m_passes.size();
+    m_stats.culledPassCount = m_passes.size() - m_order.size();
+    m_stats.compileMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Dependencies follow declaration order: a read sees the last write
+// declared before it, and a Keep write builds on it. A texture read before
+// any declared write is produced by all of its writers, wherever they were
+// declared. Ordering additionally keeps writes after the reads and writes
+// of the previous contents.
+void RenderGraph::cull(std::vector<bool>& live) const {
+    const size_t passCount = m_passes.size();
+    std::vector<std::vector<uint32_t>> needs(passCount);
+    std::vector<int> lastWriter(m_textures.size(), -1);
+    std::vector<std::vector<uint32_t>> writers(m_textures.size());
+    std::vector<std::vector<uint32_t>> earlyReaders(m_textures.size());
+
+    for (uint32_t p = 0; p < passCount; ++p) {
+        const Pass& pass = m_passes[p];
+        for (uint32_t texture : pass.reads) {
+            if (lastWriter[texture] >= 0) {
+                needs[p].push_back(static_cast<uint32_t>(lastWriter[texture]));
+            } else {
+                earlyReaders[texture].push_back(p);
+            }
+        }
+        auto write = [&](const Access& access) {
+            if (access.load == RenderGraphLoad::Keep && lastWriter[access.texture] >= 0) {
+                needs[p].push_back(static_cast<uint32_t>(lastWriter[access.texture]));
+            }
+            lastWriter[access.texture] = static_cast<int>(p);
+            writers[access.texture].push_back(p);
+        };
+        for (const Access& access : pass.colorWrites) write(access);
+        if (pass.hasDepth) write(pass.depthWrite);
+    }
+    for (size_t texture = 0; texture < m_textures.size(); ++texture) {
+        for (uint32_t reader : earlyReaders[texture]) {
+            needs[reader].insert(needs[reader].end(), writers[texture].begin(), writers[texture].end());
+        }
+    }
+
+    // Roots are passes with effects outside the graph
+    live.assign(passCount, false);
+    std::vector<uint32_t> stack;
+    for (uint32_t p = 0; p < passCount; ++p) {
+        const Pass& pass = m_passes[p];
+        bool root = pass.sideEffect;
+        for (const Access& access : pass.colorWrites) root |= m_textures[access.texture].imported != 0;
+        if (pass.hasDepth) root |= m_textures[pass.depthWrite.texture].imported != 0;
+        if (root) {
+            live[p] = true;
+            stack.push_back(p);
+        }
+    }
+    while (!stack.empty()) {
+        uint32_t p = stack.back();
+        stack.pop_back();
+        for (uint32_t needed : needs[p]) {
+            if (!live[needed]) {
+                live[needed] = true;
+                stack.push_back(needed);
+            }
+        }
+    }
+}
+
+void RenderGraph::sortPasses(const std::vector<bool>& live) {
+    const size_t passCount = m_passes.size();
+    std::vector<std::vector<uint32_t>> successors(passCount);
+    std::vector<int> predecessorCount(passCount, 0);
+    auto addEdge = [&](uint32_t before, uint32_t after) {
+        if (before != after && live[before] && live[after]) {
+            successors[before].push_back(after);
+            ++predecessorCount[after];
+        }
+    };
+
+    // Same walk as cull(), but only over live passes and with the
+    // write-after-read and write-after-write edges too
+    std::vector<int> lastWriter(m_textures.size(), -1);
+    std::vector<std::vector<uint32_t>> readersSinceWrite(m_textures.size());
+    std::vector<std::vector<uint32_t>> writers(m_textures.size());
+    std::vector<std::vector<uint32_t>> earlyReaders(m_textures.size());
+    for (uint32_t p = 0; p < passCount; ++p) {
+        if (!live[p]) {
+            continue;
+        }
+        const Pass& pass = m_passes[p];
+        for (uint32_t texture : pass.reads) {
+            if (lastWriter[texture] >= 0) {
+                addEdge(static_cast<uint32_t>(lastWriter[texture]), p);
+                readersSinceWrite[texture].push_back(p);
+            } else {
+                earlyReaders[texture].push_back(p);
+            }
+        }
+        auto write = [&](const Access& access) {
+            if (lastWriter[access.texture] >= 0) {
+                addEdge(static_cast<uint32_t>(lastWriter[access.texture]), p);
+            }
+            for (uint32_t reader : readersSinceWrite[access.texture]) {
+                addEdge(reader, p);
+            }
+            readersSinceWrite[access.texture].clear();
+            lastWriter[access.texture] = static_cast<int>(p);
+            writers[access.texture].push_back(p);
+        };
+        for (const Access& access : pass.colorWrites) write(access);
+        if (pass.hasDepth) write(pass.depthWrite);
+    }
+    for (size_t texture = 0; texture < m_textures.size(); ++texture) {
+        for (uint32_t reader : earlyReaders[texture]) {
+            for (uint32_t writer : writers[texture]) {
+                addEdge(writer, reader);
+            }
+        }
+    }
+
+    // Kahn's algorithm; among ready passes the earliest declared goes first
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+    size_t liveCount = 0;
+    for (uint32_t p = 0; p < passCount; ++p) {
+        if (live[p]) {
+            ++liveCount;
+            if (predecessorCount[p] == 0) {
+                ready.push(p);
+            }
+        }
+    }
+    m_order.clear();
+    while (!ready.empty()) {
+        uint32_t p = ready.top();
+        ready.pop();
+        m_order.push_back(p);
+        for (uint32_t successor : successors[p]) {
+            if (--predecessorCount[successor] == 0) {
+                ready.push(successor);
+            }
+        }
+    }
+    if (m_order.size() != liveCount) {
+        throw std::runtime_error("Render graph has a dependency cycle");
+    }
+}
+
+void RenderGraph::allocateTextures() {
+    for (Texture& texture : m_textures) {
+        texture.physical = -1;
+        texture.firstUse = texture.lastUse = -1;
+    }
+    for (int position = 0; position < static_cast<int>(m_order.size()); ++position) {
+        const Pass& pass = m_passes[m_order[position]];
+        auto use = [&](uint32_t index) {
+            Texture& texture = m_textures[index];
+            if (texture.firstUse < 0) texture.firstUse = position;
+            texture.lastUse = position;
+        };
+        for (uint32_t texture : pass.reads) use(texture);
+        for (const Access& access : pass.colorWrites) use(access.texture);
+        if (pass.hasDepth) use(pass.depthWrite.texture);
+    }
+
+    std::vector<uint32_t> transients;
+    for (uint32_t index = 0; index < m_textures.size(); ++index) {
+        if (m_textures[index].imported == 0 && m_textures[index].firstUse >= 0) {
+            transients.push_back(index);
+        }
+    }
+    std::sort(transients.begin(), transients.end(), [&](uint32_t a, uint32_t b) {
+        return m_textures[a].firstUse < m_textures[b].firstUse;
+    });
+
+    // Greedy interval assignment: each transient takes a pooled texture of
+    // the same description that is free by its first use
+    for (PooledTexture& pooled : m_pool) {
+        pooled.busyUntil = -1;
+    }
+    m_stats.transientTextureCount = transients.size();
+    m_stats.transientBytes = 0;
+    for (uint32_t index : transients) {
+        Texture& texture = m_textures[index];
+        int chosen = -1;
+        for (int candidate = 0; candidate < static_cast<int>(m_pool.size()); ++candidate) {
+            const PooledTexture& pooled = m_pool[candidate];
+            if (pooled.desc == texture.desc && pooled.busyUntil < texture.firstUse) {
+                chosen = candidate;
+                break;
+            }
+        }
+        if (chosen < 0) {
+            PooledTexture pooled;
+            pooled.desc = texture.desc;
+            pooled.handle = m_resources.createTexture2D(texture.desc.width, texture.desc.height, 1, texture.desc.internalFormat);
+            pooled.bytes = GpuResourceManager::getTextureBytes(texture.desc.width, texture.desc.height, 1,
+                                                                texture.desc.internalFormat);
+            GLuint id = m_resources.get(pooled.handle);
+            glBindTexture(GL_TEXTURE_2D, id);
+            GLint filter = isDepthFormat(texture.desc.internalFormat) ? GL_NEAREST : GL_LINEAR;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            m_pool.push_back(pooled);
+            chosen = static_cast<int>(m_pool.size() - 1);
+        }
+        m_pool[chosen].busyUntil = texture.lastUse;
+        m_pool[chosen].lastUsedFrame = m_frame;
+        texture.physical = chosen;
+        m_stats.transientBytes += m_pool[chosen].bytes;
+    }
+
+    m_stats.physicalTextureCount = 0;
+    m_stats.physicalBytes = 0;
+    for (const PooledTexture& pooled : m_pool) {
+        if (pooled.busyUntil >= 0) {
+            ++m_stats.physicalTextureCount;
+            m_stats.physicalBytes += pooled.bytes;
+        }
+    }
+}
+
+void RenderGraph::releaseUnusedTextures() {
+    for (size_t i = 0; i < m_pool.size();) {
+        PooledTexture& pooled = m_pool[i];
+        if (pooled.lastUsedFrame + kRetainFrames >= m_frame) {
+            ++i;
+            continue;
+        }
+        GLuint id = m_resources.get(pooled.handle);
+        for (auto it = m_framebuffers.begin(); it != m_framebuffers.end();) {
+            if (std::find(it->first.begin(), it->first.end(), id) != it->first.end()) {
+                glDeleteFramebuffers(1, &it->second);
+                it = m_framebuffers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        // Deletion waits for the frames that may still sample it
+        m_resources.destroy(pooled.handle);
+        m_pool.erase(m_pool.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+GLuint RenderGraph::getGLTexture(uint32_t index) const {
+    const Texture& texture = m_textures.at(index);
+    if (texture.imported != 0) {
+        return texture.imported;
+    }
+    if (texture.physical < 0) {
+        throw std::logic_error("Render graph texture used outside the passes that declared it");
+    }
+    return m_resources.get(m_pool[texture.physical].handle);
+}
+
+GLuint RenderGraph::getFramebuffer(const Pass& pass) {
+    // Key: color attachments in order, then depth (0 if none)
+    std::vector<GLuint> key;
+    for (const Access& access : pass.colorWrites) {
+        key.push_back(getGLTexture(access.texture));
+    }
+    key.push_back(pass.hasDepth ? getGLTexture(pass.depthWrite.texture) : 0);
+
+    auto found = m_framebuffers.find(key);
+    if (found != m_framebuffers.end()) {
+        return found->second;
+    }
+
+    GLuint framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    std::vector<GLenum> drawBuffers;
+    for (size_t i = 0; i < pass.colorWrites.size(); ++i) {
+        GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, key[i], 0);
+        drawBuffers.push_back(attachment);
+    }
+    if (pass.hasDepth) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, key.back(), 0);
+    }
+    if (drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+    } else {
+        glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    }
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        throw std::runtime_error(std::string("Render graph pass has an incomplete framebuffer: ") + pass.name);
+    }
+    m_framebuffers.emplace(std::move(key), framebuffer);
+    return framebuffer;
+}
+
+void RenderGraph::execute(GpuProfiler* gpuProfiler) {
+    if (!m_compiled) {
+        compile();
+    }
+
+    PassContext context(*this);
+    for (uint32_t index : m_order) {
+        const Pass& pass = m_passes[index];
+        LLR_PROFILE_SCOPE(pass.name);
+        if (gpuProfiler) {
+            gpuProfiler->push(pass.name);
+        }
+
+        if (!pass.colorWrites.empty() || pass.hasDepth) {
+            glBindFramebuffer(GL_FRAMEBUFFER, getFramebuffer(pass));
+            const RenderGraphTextureDesc& size = m_textures[pass.colorWrites.empty() ? pass.depthWrite.texture
+                                                                                      : pass.colorWrites[0].texture].desc;
+            glViewport(0, 0, size.width, size.height);
+
+            // DontCare would map to glInvalidateFramebuffer, which is 4.3
+            const GLfloat clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (size_t i = 0; i < pass.colorWrites.size(); ++i) {
+                if (pass.colorWrites[i].load == RenderGraphLoad::Clear) {
+                    glClearBufferfv(GL_COLOR, static_cast<GLint>(i), clearColor);
+                }
+            }
+            if (pass.hasDepth && pass.depthWrite.load == RenderGraphLoad::Clear) {
+                const GLfloat clearDepth = 1.0f;
+                glDepthMask(GL_TRUE);
+                glClearBufferfv(GL_DEPTH, 0, &clearDepth);
+            }
+        }
+
+        pass.execute(context);
+        if (gpuProfiler) {
+            gpuProfiler->pop();
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+std::vector<const char*> RenderGraph::getExecutionOrder() const {
+    std::vector<const char*> names;
+    for (uint32_t index : m_order) {
+        names.push_back(m_passes[index].name);
+    }
+    return names;
+}
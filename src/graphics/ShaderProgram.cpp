@@ -3,12 +3,22 @@
 #include <fstream>
 #include <sstream>
 
-ShaderProgram::ShaderProgram() : m_id(0) {}
+ShaderProgram::ShaderProgram() : m_id(0), m_resources(nullptr) {}
+
+ShaderProgram::ShaderProgram(GpuResourceManager& resources) : m_id(0), m_resources(&resources) {}
 
 ShaderProgram::~ShaderProgram() {
-    if (m_id != 0) {
+    destroyProgram();
+}
+
+void ShaderProgram::destroyProgram() {
+    if (m_resources) {
+        m_resources->destroy(m_handle);
+        m_handle = {};
+    } else if (m_id != 0) {
         glDeleteProgram(m_id);
     }
+    m_id = 0;
 }
 
 bool ShaderProgram::compile(const std::string& vertexSource, const std::string& fragmentSource) {
@@ -60,10 +70,11 @@ bool ShaderProgram::compile(const std::string& vertexSource, const std::string&
     glDeleteShader(fragmentShader);
     
     // Store program ID
-    if (m_id != 0) {
-        glDeleteProgram(m_id);
-    }
+    destroyProgram();
     m_id = program;
+    if (m_resources) {
+        m_handle = m_resources->adoptProgram(program);
+    }
     
     // Clear uniform cache
     m_uniformLocations.clear();
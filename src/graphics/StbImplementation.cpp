@@ -0,0 +1,5 @@
+// Single translation unit that compiles the header-only stb libraries
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
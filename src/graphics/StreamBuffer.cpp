@@ -0,0 +1,154 @@
+#include "graphics/StreamBuffer.h"
+#include <cstring>
+#include <stdexcept>
+
+StreamBuffer::StreamBuffer(GLenum target, size_t regionSize, int regionCount, Mode mode)
+    : m_id(0), m_target(target), m_mode(mode), m_regionSize(regionSize),
+      m_regionCount(regionCount), m_region(0), m_regionUsed(0), m_defaultAlignment(16), m_mapped(false),
+      m_orphanPending(false), m_stallCount(0) {
+
+    if (regionSize == 0 || regionCount < 1) {
+        throw std::invalid_argument("StreamBuffer needs a non-empty region size and at least one region");
+    }
+
+    // Uniform ranges must start on the implementation's offset alignment,
+    // so round each region up to keep every region start bindable, and
+    // align allocations to it by default
+    if (target == GL_UNIFORM_BUFFER) {
+        GLint uboAlignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboAlignment);
+        m_defaultAlignment = static_cast<size_t>(uboAlignment);
+        m_regionSize = (m_regionSize + m_defaultAlignment - 1) / m_defaultAlignment * m_defaultAlignment;
+    }
+
+    m_fences.assign(m_regionCount, nullptr);
+
+    // Storage is touched through the copy-write binding point only, so the
+    // bound VAO's element buffer (or any other target) is left alone
+    glGenBuffers(1, &m_id);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(m_regionSize * m_regionCount), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync fence : m_fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    if (m_id != 0) {
+        glDeleteBuffers(1, &m_id);
+    }
+}
+
+StreamBuffer::Allocation StreamBuffer::map(size_t size, size_t alignment) {
+    if (m_mapped) {
+        throw std::logic_error("StreamBuffer::map called while a range is still mapped");
+    }
+    if (alignment == 0) {
+        alignment = m_defaultAlignment;
+    }
+
+    size_t offsetInRegion = (m_regionUsed + alignment - 1) / alignment * alignment;
+    if (offsetInRegion + size > m_regionSize) {
+        throw std::runtime_error("StreamBuffer region overflow; increase regionSize");
+    }
+
+    GLintptr offset = static_cast<GLintptr>(m_region * m_regionSize + offsetInRegion);
+    if (size == 0) {
+        // Nothing to write; hand back the position without mapping
+        return { nullptr, offset, 0 };
+    }
+
+    // First write into this region this frame: make sure the GPU is done with it
+    if (m_regionUsed == 0 && m_mode == Mode::Fenced) {
+        waitForRegion(m_region);
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    if (m_orphanPending) {
+        // Wrapped around since the last write: hand the old storage to the
+        // driver and start fresh, whichever region is written first
+        m_orphanPending = false;
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(m_regionSize * m_regionCount), nullptr, GL_STREAM_DRAW);
+    }
+
+    void* data = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, static_cast<GLsizeiptr>(size), access);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (!data) {
+        throw std::runtime_error("Failed to map stream buffer range");
+    }
+
+    m_regionUsed = offsetInRegion + size;
+    m_mapped = true;
+
+    return { data, offset, static_cast<GLsizeiptr>(size) };
+}
+
+void StreamBuffer::unmap() {
+    if (!m_mapped) {
+        return;
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    m_mapped = false;
+}
+
+StreamBuffer::Allocation StreamBuffer::write(const void* data, size_t size, size_t alignment) {
+    Allocation allocation = map(size, alignment);
+    if (size > 0) {
+        std::memcpy(allocation.data, data, size);
+        unmap();
+    }
+    allocation.data = nullptr;
+    return allocation;
+}
+
+void StreamBuffer::endFrame() {
+    unmap();
+
+    if (m_mode == Mode::Fenced && m_regionUsed > 0) {
+        if (m_fences[m_region]) {
+            glDeleteSync(m_fences[m_region]);
+        }
+        m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    m_region = (m_region + 1) % m_regionCount;
+    m_regionUsed = 0;
+    if (m_mode == Mode::Orphaned && m_region == 0) {
+        m_orphanPending = true;
+    }
+}
+
+void StreamBuffer::bind() const {
+    glBindBuffer(m_target, m_id);
+}
+
+void StreamBuffer::bindRange(GLenum target, GLuint index, const Allocation& allocation) const {
+    glBindBufferRange(target, index, m_id, allocation.offset, allocation.size);
+}
+
+void StreamBuffer::waitForRegion(int region) {
+    GLsync fence = m_fences[region];
+    if (!fence) {
+        return;
+    }
+
+    // Poll first so the common (already signalled) case never counts as a stall
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        ++m_stallCount;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    glDeleteSync(fence);
+    m_fences[region] = nullptr;
+}
@@ -0,0 +1,102 @@
+#include "graphics/Texture.h"
+#include "core/AsyncFile.h"
+#include "graphics/GLExecutor.h"
+#include <algorithm>
+#include <stdexcept>
+
+// Immutable storage in one call when the context has glTexStorage2D. The
+// entry point only exists in a loader generated for 4.2+, so the call sits
+// under the same guard as the runtime check.
+static bool allocateTextureStorage(GLenum internalFormat, int levelCount, int width, int height) {
+#if defined(GL_VERSION_4_2)
+    if (GLAD_GL_VERSION_4_2) {
+        glTexStorage2D(GL_TEXTURE_2D, levelCount, internalFormat, width, height);
+        return true;
+    }
+#endif
+    (void)internalFormat;
+    (void)levelCount;
+    (void)width;
+    (void)height;
+    return false;
+}
+
+Texture::Texture(int width, int height, int levelCount, bool srgb)
+    : m_id(0), m_width(width), m_height(height), m_levelCount(std::max(1, levelCount)) {
+    GLenum internalFormat = srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+
+    glGenTextures(1, &m_id);
+    glBindTexture(GL_TEXTURE_2D, m_id);
+
+    if (!allocateTextureStorage(internalFormat, m_levelCount, width, height)) {
+        // Same result on 4.1: every level defined once, never respecified
+        for (int level = 0; level < m_levelCount; ++level) {
+            glTexImage2D(GL_TEXTURE_2D, level, static_cast<GLint>(internalFormat),
+                         std::max(1, width >> level), std::max(1, height >> level), 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_levelCount - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+Texture::Texture(const TextureData& data)
+    : Texture(data.getWidth(), data.getHeight(), static_cast<int>(data.levels.size()), data.srgb) {
+    for (int level = 0; level < m_levelCount; ++level) {
+        uploadLevel(level, data.levels[level]);
+    }
+}
+
+Texture::~Texture() {
+    if (m_id != 0) {
+        glDeleteTextures(1, &m_id);
+    }
+}
+
+void Texture::uploadLevel(int level, const TextureLevel& data) {
+    glBindTexture(GL_TEXTURE_2D, m_id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, data.width, data.height, GL_RGBA, GL_UNSIGNED_BYTE, data.pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::bind(int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, m_id);
+}
+
+Task<std::unique_ptr<Texture>> loadTexture(JobSystem& jobs, GLExecutor& gl, std::string path,
+                                           TextureLoadOptions options) {
+    // Worker thread from here on
+    std::vector<uint8_t> bytes = co_await readFile(jobs, path);
+
+    TextureData data;
+    data.srgb = options.srgb;
+    if (!decodeImage(bytes.data(), bytes.size(), data)) {
+        throw std::runtime_error("Failed to decode texture: " + path);
+    }
+    bytes = {};
+
+    if (options.generateMips) {
+        generateMipChain(data, options.filter, &jobs);
+    }
+
+    // GL thread: allocate, then one level per executor slot
+    co_await gl.schedule();
+    auto texture = std::make_unique<Texture>(data.getWidth(), data.getHeight(),
+                                             static_cast<int>(data.levels.size()), data.srgb);
+    for (int level = 0; level < texture->getLevelCount(); ++level) {
+        if (level > 0) {
+            co_await gl.schedule();
+        }
+        texture->uploadLevel(level, data.levels[level]);
+    }
+
+    co_return texture;
+}
@@ -0,0 +1,243 @@
+#include "graphics/TextureData.h"
+#include "core/JobSystem.h"
+#include "core/Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stb_image.h>
+
+namespace {
+
+// sRGB <-> linear conversion tables. Decoding is exact per byte; encoding
+// indexes a 12-bit linear table, which is well below 8-bit sRGB precision.
+struct ColorTables {
+    float srgbToLinear[256];
+    float unormToFloat[256];
+    uint8_t linearToSrgb[4096];
+
+    ColorTables() {
+        for (int i = 0; i < 256; ++i) {
+            float c = i / 255.0f;
+            srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            unormToFloat[i] = c;
+        }
+        for (int i = 0; i < 4096; ++i) {
+            float l = i / 4095.0f;
+            float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            linearToSrgb[i] = static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+    }
+};
+
+const ColorTables& colorTables() {
+    static const ColorTables tables;
+    return tables;
+}
+
+// Linear float RGBA image used while filtering
+struct FloatImage {
+    int width = 0;
+    int height = 0;
+    std::vector<float> pixels;
+
+    float* row(int y) { return pixels.data() + static_cast<size_t>(y) * width * 4; }
+    const float* row(int y) const { return pixels.data() + static_cast<size_t>(y) * width * 4; }
+};
+
+template<typename Fn>
+void forEachRow(JobSystem* jobs, int rows, Fn&& fn) {
+    auto body = [&fn](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) fn(static_cast<int>(y));
+    };
+    // Small levels are not worth the scheduling overhead
+    if (jobs && rows >= 64) {
+        jobs->parallelFor(static_cast<size_t>(rows), body, 16);
+    } else {
+        body(0, static_cast<size_t>(rows));
+    }
+}
+
+FloatImage toLinear(const TextureLevel& level, bool srgb, JobSystem* jobs) {
+    const ColorTables& tables = colorTables();
+    const float* colorTable = srgb ? tables.srgbToLinear : tables.unormToFloat;
+
+    FloatImage image;
+    image.width = level.width;
+    image.height = level.height;
+    image.pixels.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+    forEachRow(jobs, level.height, [&](int y) {
+        const uint8_t* src = level.pixels.data() + static_cast<size_t>(y) * level.width * 4;
+        float* dst = image.row(y);
+        for (int x = 0; x < level.width * 4; x += 4) {
+            dst[x + 0] = colorTable[src[x + 0]];
+            dst[x + 1] = colorTable[src[x + 1]];
+            dst[x + 2] = colorTable[src[x + 2]];
+            dst[x + 3] = tables.unormToFloat[src[x + 3]];
+        }
+    });
+    return image;
+}
+
+TextureLevel fromLinear(const FloatImage& image, bool srgb, JobSystem* jobs) {
+    const ColorTables& tables = colorTables();
+
+    TextureLevel level;
+    level.width = image.width;
+    level.height = image.height;
+    level.pixels.resize(static_cast<size_t>(image.width) * image.height * 4);
+
+    forEachRow(jobs, image.height, [&](int y) {
+        const float* src = image.row(y);
+        uint8_t* dst = level.pixels.data() + static_cast<size_t>(y) * image.width * 4;
+        for (int x = 0; x < image.width * 4; x += 4) {
+            for (int c = 0; c < 3; ++c) {
+                float value = std::clamp(src[x + c], 0.0f, 1.0f);
+                dst[x + c] = srgb ? tables.linearToSrgb[static_cast<int>(value * 4095.0f + 0.5f)]
+                                  : static_cast<uint8_t>(value * 255.0f + 0.5f);
+            }
+            dst[x + 3] = static_cast<uint8_t>(std::clamp(src[x + 3], 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    });
+    return level;
+}
+
+// 2x2 average, one RGBA pixel per SIMD register. Odd edges clamp.
+FloatImage downsampleBox(const FloatImage& src, JobSystem* jobs) {
+    FloatImage dst;
+    dst.width = std::max(1, src.width / 2);
+    dst.height = std::max(1, src.height / 2);
+    dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+
+    const Float4 quarter(0.25f);
+    forEachRow(jobs, dst.height, [&](int y) {
+        const float* row0 = src.row(std::min(y * 2, src.height - 1));
+        const float* row1 = src.row(std::min(y * 2 + 1, src.height - 1));
+        float* out = dst.row(y);
+        for (int x = 0; x < dst.width; ++x) {
+            int x0 = std::min(x * 2, src.width - 1) * 4;
+            int x1 = std::min(x * 2 + 1, src.width - 1) * 4;
+            Float4 sum = Float4::load(row0 + x0) + Float4::load(row0 + x1) +
+                         Float4::load(row1 + x0) + Float4::load(row1 + x1);
+            (sum * quarter).store(out + x * 4);
+        }
+    });
+    return dst;
+}
+
+// Kaiser-windowed sinc for a 2:1 reduction, sampled at the six source
+// pixels around each destination pixel centre
+struct KaiserKernel {
+    static constexpr int kTaps = 6;
+    float weights[kTaps];
+
+    KaiserKernel() {
+        const double kPi = 3.14159265358979323846;
+        const double alpha = 4.0;
+        const double radius = 3.0;  // In source pixels
+        auto besselI0 = [](double x) {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; ++k) {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        };
+
+        double total = 0.0;
+        for (int i = 0; i < kTaps; ++i) {
+            double offset = (i - kTaps / 2) + 0.5;        // -2.5 .. 2.5 source pixels
+            double t = offset / 2.0;                      // In destination pixels
+            double sinc = t == 0.0 ? 1.0 : std::sin(kPi * t) / (kPi * t);
+            double ratio = offset / radius;
+            double window = besselI0(alpha * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / besselI0(alpha);
+            weights[i] = static_cast<float>(sinc * window);
+            total += weights[i];
+        }
+        for (float& weight : weights) {
+            weight = static_cast<float>(weight / total);
+        }
+    }
+};
+
+FloatImage downsampleKaiser(const FloatImage& src, JobSystem* jobs) {
+    static const KaiserKernel kernel;
+    constexpr int kTaps = KaiserKernel::kTaps;
+
+    // Horizontal pass: src.width -> dst.width, all rows
+    FloatImage horizontal;
+    horizontal.width = std::max(1, src.width / 2);
+    horizontal.height = src.height;
+    horizontal.pixels.resize(static_cast<size_t>(horizontal.width) * horizontal.height * 4);
+
+    forEachRow(jobs, src.height, [&](int y) {
+        const float* in = src.row(y);
+        float* out = horizontal.row(y);
+        for (int x = 0; x < horizontal.width; ++x) {
+            Float4 sum;
+            for (int t = 0; t < kTaps; ++t) {
+                int sx = std::clamp(x * 2 + t - kTaps / 2 + 1, 0, src.width - 1);
+                sum = madd(Float4::load(in + sx * 4), Float4(kernel.weights[t]), sum);
+            }
+            max(sum, Float4(0.0f)).store(out + x * 4);
+        }
+    });
+
+    // Vertical pass
+    FloatImage dst;
+    dst.width = horizontal.width;
+    dst.height = std::max(1, src.height / 2);
+    dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+
+    forEachRow(jobs, dst.height, [&](int y) {
+        const float* rows[kTaps];
+        for (int t = 0; t < kTaps; ++t) {
+            rows[t] = horizontal.row(std::clamp(y * 2 + t - kTaps / 2 + 1, 0, horizontal.height - 1));
+        }
+        float* out = dst.row(y);
+        for (int x = 0; x < dst.width * 4; x += 4) {
+            Float4 sum;
+            for (int t = 0; t < kTaps; ++t) {
+                sum = madd(Float4::load(rows[t] + x), Float4(kernel.weights[t]), sum);
+            }
+            max(sum, Float4(0.0f)).store(out + x);
+        }
+    });
+    return dst;
+}
+
+} // namespace
+
+bool decodeImage(const uint8_t* data, size_t size, TextureData& texture) {
+    int width = 0, height = 0, channels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4);
+    if (!pixels) {
+        std::cerr << "Failed to decode image: " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+
+    TextureLevel level;
+    level.width = width;
+    level.height = height;
+    level.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    texture.levels.clear();
+    texture.levels.push_back(std::move(level));
+    return true;
+}
+
+void generateMipChain(TextureData& texture, MipFilter filter, JobSystem* jobs) {
+    if (texture.levels.empty()) {
+        return;
+    }
+    texture.levels.resize(1);
+
+    // Each level is filtered from the previous one in linear float, so
+    // quantization error does not accumulate down the chain
+    FloatImage current = toLinear(texture.levels[0], texture.srgb, jobs);
+    while (current.width > 1 || current.height > 1) {
+        current = filter == MipFilter::Kaiser ? downsampleKaiser(current, jobs) : downsampleBox(current, jobs);
+        texture.levels.push_back(fromLinear(current, texture.srgb, jobs));
+    }
+}
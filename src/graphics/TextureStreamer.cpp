@@ -0,0 +1,348 @@
+#include "graphics/TextureStreamer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+TextureStreamer::TextureStreamer(JobSystem& jobs, TextureStreamerSettings settings)
+    : m_jobs(jobs), m_settings(settings) {
+}
+
+TextureStreamer::~TextureStreamer() {
+    for (auto& entry : m_entries) {
+        cancelLoad(entry);
+    }
+    // Workers still hold their file references; wait so no job outlives us
+    m_jobs.wait(m_loadCounter);
+}
+
+StreamedTextureHandle TextureStreamer::add(const std::string& cookedPath) {
+    auto file = std::make_shared<CompressedTextureFile>();
+    if (!file->open(cookedPath)) {
+        std::cerr << "Failed to open streamed texture: " << cookedPath << std::endl;
+        return kInvalidStreamedTexture;
+    }
+
+    StreamedTextureHandle handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    } else {
+        handle = static_cast<StreamedTextureHandle>(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    Entry& entry = m_entries[handle];
+    entry = Entry{};
+    entry.file = std::move(file);
+    entry.levelCount = static_cast<int>(entry.file->getHeader().levelCount);
+    entry.tailLevel = entry.levelCount - 1;
+    for (int level = 0; level < entry.levelCount; ++level) {
+        const CompressedTextureLevel& info = entry.file->getLevel(level);
+        if (static_cast<int>(std::max(info.width, info.height)) <= m_settings.tailSize) {
+            entry.tailLevel = level;
+            break;
+        }
+    }
+    entry.alive = true;
+
+    // The tail is small and always resident, so something is bindable at once
+    entry.residentLevel = entry.levelCount;
+    setResidentLevel(entry, entry.tailLevel);
+    entry.targetLevel = entry.tailLevel;
+    return handle;
+}
+
+void TextureStreamer::remove(StreamedTextureHandle handle) {
+    if (handle >= m_entries.size() || !m_entries[handle].alive) {
+        return;
+    }
+
+    Entry& entry = m_entries[handle];
+    cancelLoad(entry);
+    if (entry.texture) {
+        m_stats.residentBytes -= entry.texture->getByteSize();
+    }
+    entry = Entry{};
+    m_freeHandles.push_back(handle);
+}
+
+void TextureStreamer::request(StreamedTextureHandle handle, float screenSize) {
+    if (handle >= m_entries.size() || !m_entries[handle].alive) {
+        return;
+    }
+    Entry& entry = m_entries[handle];
+    entry.requestedSize = std::max(entry.requestedSize, screenSize);
+}
+
+float TextureStreamer::computeScreenSize(float worldSize, float distance, float fovY, int viewportHeight) {
+    float projected = worldSize / (2.0f * std::max(distance, 1e-3f) * std::tan(fovY * 0.5f));
+    return projected * static_cast<float>(viewportHeight);
+}
+
+void TextureStreamer::update() {
+    m_stats.uploadsThisFrame = 0;
+    m_stats.uploadedBytesThisFrame = 0;
+    m_uploadStart = std::chrono::steady_clock::now();
+
+    retireCancelledLoads();
+    retarget();
+    fitBudget();
+    issueLoads();
+    // Without background workers nothing else would run the page-ins
+    if (m_jobs.getThreadCount() == 1) {
+        m_jobs.wait(m_loadCounter);
+    }
+    uploadReady();
+
+    ++m_frame;
+}
+
+size_t TextureStreamer::getBytesFrom(const Entry& entry, int level) const {
+    size_t bytes = 0;
+    for (int i = level; i < entry.levelCount; ++i) {
+        bytes += entry.file->getLevel(i).size;
+    }
+    return bytes;
+}
+
+int TextureStreamer::computeWantedLevel(const Entry& entry) const {
+    if (entry.lastSize <= 0.0f || m_frame - entry.lastRequestFrame > m_settings.idleFrames) {
+        return entry.tailLevel;
+    }
+
+    const CompressedTextureHeader& header = entry.file->getHeader();
+    float texels = static_cast<float>(std::max(header.width, header.height));
+    // One texel per pixel: every halving of the on-screen size drops a level
+    int level = static_cast<int>(std::floor(std::log2(texels / entry.lastSize) + m_settings.lodBias));
+    return std::clamp(level, 0, entry.tailLevel);
+}
+
+void TextureStreamer::retarget() {
+    for (auto& entry : m_entries) {
+        if (!entry.alive) {
+            continue;
+        }
+        if (entry.requestedSize > 0.0f) {
+            entry.lastSize = entry.requestedSize;
+            entry.lastRequestFrame = m_frame;
+            entry.requestedSize = 0.0f;
+        }
+        entry.targetLevel = computeWantedLevel(entry);
+    }
+}
+
+void TextureStreamer::fitBudget() {
+    size_t wanted = 0;
+    std::vector<Entry*> order;
+    for (auto& entry : m_entries) {
+        if (entry.alive) {
+            wanted += getBytesFrom(entry, entry.targetLevel);
+            order.push_back(&entry);
+        }
+    }
+    m_stats.wantedBytes = wanted;
+    if (wanted <= m_settings.budgetBytes) {
+        return;
+    }
+
+    // Least recently needed first; among textures needed in the same frame,
+    // the smallest on screen give up detail first
+    std::sort(order.begin(), order.end(), [](const Entry* a, const Entry* b) {
+        if (a->lastRequestFrame != b->lastRequestFrame) return a->lastRequestFrame < b->lastRequestFrame;
+        return a->lastSize < b->lastSize;
+    });
+
+    // Coarsen one level at a time across each group of equally recent
+    // textures, so a group loses detail evenly before the next is touched
+    size_t groupBegin = 0;
+    while (groupBegin < order.size() && wanted > m_settings.budgetBytes) {
+        size_t groupEnd = groupBegin;
+        while (groupEnd < order.size() && order[groupEnd]->lastRequestFrame == order[groupBegin]->lastRequestFrame) {
+            ++groupEnd;
+        }
+
+        bool changed = true;
+        while (changed && wanted > m_settings.budgetBytes) {
+            changed = false;
+            for (size_t i = groupBegin; i < groupEnd && wanted > m_settings.budgetBytes; ++i) {
+                Entry& entry = *order[i];
+                if (entry.targetLevel < entry.tailLevel) {
+                    wanted -= entry.file->getLevel(entry.targetLevel).size;
+                    ++entry.targetLevel;
+                    changed = true;
+                }
+            }
+        }
+        groupBegin = groupEnd;
+    }
+}
+
+void TextureStreamer::issueLoads() {
+    // Drop what is no longer wanted first so loads can use the memory.
+    // Evicting recreates the texture from the levels that stay, which is
+    // an upload like any other; past the frame's limits it waits, and the
+    // memory it holds keeps new loads out until then.
+    for (auto& entry : m_entries) {
+        if (!entry.alive) {
+            continue;
+        }
+        if (entry.load && entry.load->level < entry.targetLevel) {
+            cancelLoad(entry);
+        }
+        if (entry.residentLevel < entry.targetLevel) {
+            size_t bytes = getBytesFrom(entry, entry.targetLevel);
+            if (!canUpload(bytes)) {
+                continue;
+            }
+            setResidentLevel(entry, entry.targetLevel);
+            ++m_stats.evictions;
+            ++m_stats.uploadsThisFrame;
+            m_stats.uploadedBytesThisFrame += bytes;
+        }
+    }
+
+    std::vector<Entry*> candidates;
+    size_t committed = m_stats.residentBytes;
+    for (auto& entry : m_entries) {
+        if (!entry.alive) {
+            continue;
+        }
+        if (entry.load) {
+            committed += getBytesFrom(entry, entry.load->level) - getBytesFrom(entry, entry.residentLevel);
+        } else if (entry.residentLevel > entry.targetLevel) {
+            candidates.push_back(&entry);
+        }
+    }
+
+    // Biggest shortfall first, then whatever is largest on screen
+    std::sort(candidates.begin(), candidates.end(), [](const Entry* a, const Entry* b) {
+        int deficitA = a->residentLevel - a->targetLevel;
+        int deficitB = b->residentLevel - b->targetLevel;
+        if (deficitA != deficitB) return deficitA > deficitB;
+        return a->lastSize > b->lastSize;
+    });
+
+    for (Entry* entry : candidates) {
+        if (m_stats.loadsInFlight >= m_settings.maxLoadsInFlight) {
+            break;
+        }
+        size_t growth = getBytesFrom(*entry, entry->targetLevel) - getBytesFrom(*entry, entry->residentLevel);
+        if (committed + growth > m_settings.budgetBytes) {
+            continue;
+        }
+        committed += growth;
+
+        auto load = std::make_shared<Load>();
+        load->file = entry->file;
+        load->level = entry->targetLevel;
+        int endLevel = entry->residentLevel;
+        entry->load = load;
+        ++m_stats.loadsInFlight;
+
+        // Page the missing levels in on a worker so the GL thread never
+        // blocks on disk inside glCompressedTexImage2D
+        m_jobs.run([load, endLevel]() {
+            constexpr size_t kPageSize = 4096;
+            for (int level = load->level; level < endLevel; ++level) {
+                if (load->cancelled.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                const uint8_t* data = load->file->getLevelData(level);
+                size_t size = load->file->getLevel(level).size;
+                volatile uint8_t sink = 0;
+                for (size_t offset = 0; offset < size; offset += kPageSize) {
+                    sink = sink + data[offset];
+                }
+            }
+            load->finished.store(true, std::memory_order_release);
+        }, &m_loadCounter);
+    }
+}
+
+void TextureStreamer::uploadReady() {
+    std::vector<Entry*> ready;
+    for (auto& entry : m_entries) {
+        if (entry.alive && entry.load && entry.load->finished.load(std::memory_order_acquire)) {
+            ready.push_back(&entry);
+        }
+    }
+    std::sort(ready.begin(), ready.end(), [](const Entry* a, const Entry* b) {
+        return a->lastSize > b->lastSize;
+    });
+
+    for (Entry* entry : ready) {
+        size_t bytes = getBytesFrom(*entry, entry->load->level);
+        if (!canUpload(bytes)) {
+            break;
+        }
+
+        int level = entry->load->level;
+        entry->load.reset();
+        --m_stats.loadsInFlight;
+        setResidentLevel(*entry, level);
+        ++m_stats.uploadsThisFrame;
+        m_stats.uploadedBytesThisFrame += bytes;
+    }
+}
+
+bool TextureStreamer::canUpload(size_t bytes) const {
+    if (m_stats.uploadsThisFrame == 0) {
+        return true;
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_uploadStart).count();
+    return m_stats.uploadedBytesThisFrame + bytes <= m_settings.maxUploadBytesPerFrame &&
+           elapsed < m_settings.maxUploadMillisecondsPerFrame;
+}
+
+void TextureStreamer::setResidentLevel(Entry& entry, int level) {
+    if (entry.texture) {
+        m_stats.residentBytes -= entry.texture->getByteSize();
+    }
+    entry.texture = std::make_unique<CompressedTexture>(*entry.file, level);
+    entry.residentLevel = level;
+    m_stats.residentBytes += entry.texture->getByteSize();
+}
+
+void TextureStreamer::cancelLoad(Entry& entry) {
+    if (!entry.load) {
+        return;
+    }
+    // The job stays in flight until it notices; it is retired in a later
+    // update() once it has returned
+    entry.load->cancelled.store(true, std::memory_order_relaxed);
+    m_cancelledLoads.push_back(std::move(entry.load));
+    ++m_stats.cancelledLoads;
+}
+
+void TextureStreamer::retireCancelledLoads() {
+    auto finished = std::remove_if(m_cancelledLoads.begin(), m_cancelledLoads.end(), [](const std::shared_ptr<Load>& load) {
+        return load->finished.load(std::memory_order_acquire);
+    });
+    m_stats.loadsInFlight -= static_cast<int>(m_cancelledLoads.end() - finished);
+    m_cancelledLoads.erase(finished, m_cancelledLoads.end());
+}
+
+void TextureStreamer::bind(StreamedTextureHandle handle, int unit) const {
+    if (handle < m_entries.size() && m_entries[handle].texture) {
+        m_entries[handle].texture->bind(unit);
+    } else {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+GLuint TextureStreamer::getTextureId(StreamedTextureHandle handle) const {
+    if (handle < m_entries.size() && m_entries[handle].texture) {
+        return m_entries[handle].texture->getId();
+    }
+    return 0;
+}
+
+int TextureStreamer::getResidentLevel(StreamedTextureHandle handle) const {
+    return handle < m_entries.size() && m_entries[handle].alive ? m_entries[handle].residentLevel : -1;
+}
+
+int TextureStreamer::getTargetLevel(StreamedTextureHandle handle) const {
+    return handle < m_entries.size() && m_entries[handle].alive ? m_entries[handle].targetLevel : -1;
+}
@@ -0,0 +1,208 @@
+#include "graphics/UploadContext.h"
+#include "app/Window.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Deletes a GL object unless released, so an upload that fails part way
+// does not leak what it already created
+class GLObjectGuard {
+public:
+    using Deleter = void (*)(GLuint);
+
+    GLObjectGuard(GLuint name, Deleter deleter) : m_name(name), m_deleter(deleter) {}
+    ~GLObjectGuard() {
+        if (m_name != 0) {
+            m_deleter(m_name);
+        }
+    }
+
+    GLObjectGuard(const GLObjectGuard&) = delete;
+    GLObjectGuard& operator=(const GLObjectGuard&) = delete;
+
+    GLuint get() const { return m_name; }
+    GLuint release() {
+        GLuint name = m_name;
+        m_name = 0;
+        return name;
+    }
+
+private:
+    GLuint m_name;
+    Deleter m_deleter;
+};
+
+GLuint genBuffer() {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    return buffer;
+}
+
+GLuint genTexture() {
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    return texture;
+}
+
+void deleteBuffer(GLuint buffer) { glDeleteBuffers(1, &buffer); }
+void deleteTexture(GLuint texture) { glDeleteTextures(1, &texture); }
+
+// Allocation failures such as GL_OUT_OF_MEMORY only show up here
+void throwOnGLError(const char* operation) {
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        throw std::runtime_error(std::string(operation) + " failed with GL error " + std::to_string(error));
+    }
+}
+
+GLuint uploadBuffer(GLenum target, const void* data, size_t size, GLenum usage) {
+    GLObjectGuard buffer(genBuffer(), deleteBuffer);
+    glBindBuffer(target, buffer.get());
+    glBufferData(target, static_cast<GLsizeiptr>(size), data, usage);
+    glBindBuffer(target, 0);
+    throwOnGLError("glBufferData");
+    return buffer.release();
+}
+
+} // namespace
+
+UploadTicket::~UploadTicket() {
+    if (m_fence) {
+        glDeleteSync(m_fence);
+    }
+}
+
+bool UploadTicket::isComplete() {
+    if (!m_submitted.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (!m_fence) {
+        return true;
+    }
+
+    // Sync objects are shared between the contexts; poll without blocking
+    GLenum result = glClientWaitSync(m_fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+    glDeleteSync(m_fence);
+    m_fence = nullptr;
+    return true;
+}
+
+UploadContext::UploadContext(Window& window)
+    : m_context(window.getUploadContext()), m_running(true) {
+    if (!m_context) {
+        throw std::runtime_error("Window was created without an upload context");
+    }
+    m_thread = std::thread(&UploadContext::threadLoop, this);
+}
+
+UploadContext::~UploadContext() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::shared_ptr<UploadTicket> UploadContext::submit(std::function<GLuint()> work) {
+    auto ticket = std::make_shared<UploadTicket>();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back({ std::move(work), ticket });
+    }
+    m_condition.notify_one();
+    return ticket;
+}
+
+std::shared_ptr<UploadTicket> UploadContext::createBuffer(GLenum target, std::vector<uint8_t> data, GLenum usage) {
+    return submit([target, data = std::move(data), usage]() {
+        return uploadBuffer(target, data.data(), data.size(), usage);
+    });
+}
+
+std::shared_ptr<UploadTicket> UploadContext::createBuffer(GLenum target, const void* data, size_t size, GLenum usage) {
+    return submit([target, data, size, usage]() {
+        return uploadBuffer(target, data, size, usage);
+    });
+}
+
+std::shared_ptr<UploadTicket> UploadContext::createTexture2D(int width, int height, GLenum internalFormat,
+                                                             GLenum format, GLenum type,
+                                                             std::vector<uint8_t> pixels, bool generateMipmaps) {
+    return submit([=, pixels = std::move(pixels)]() {
+        GLObjectGuard texture(genTexture(), deleteTexture);
+        glBindTexture(GL_TEXTURE_2D, texture.get());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width, height, 0, format, type,
+                     pixels.empty() ? nullptr : pixels.data());
+        if (generateMipmaps) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        } else {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        throwOnGLError("glTexImage2D");
+        return texture.release();
+    });
+}
+
+std::shared_ptr<UploadTicket> UploadContext::updateTexture2D(GLuint texture, int level, int x, int y,
+                                                             int width, int height, GLenum format, GLenum type,
+                                                             std::vector<uint8_t> pixels) {
+    return submit([=, pixels = std::move(pixels)]() {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, format, type, pixels.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+        throwOnGLError("glTexSubImage2D");
+        return texture;
+    });
+}
+
+size_t UploadContext::getPendingCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
+
+void UploadContext::threadLoop() {
+    glfwMakeContextCurrent(m_context);
+
+    while (true) {
+        Work work;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return !m_running || !m_queue.empty(); });
+            if (!m_running && m_queue.empty()) {
+                break;
+            }
+            work = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        // Errors left by earlier work would be blamed on this one
+        while (glGetError() != GL_NO_ERROR) {
+        }
+        try {
+            work.ticket->m_object = work.function();
+        } catch (const std::exception& e) {
+            std::cerr << "Upload failed: " << e.what() << std::endl;
+            work.ticket->m_failed.store(true, std::memory_order_release);
+        }
+
+        // Fence and flush so the render context can wait on the result
+        work.ticket->m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        work.ticket->m_submitted.store(true, std::memory_order_release);
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,254 @@
+#include "graphics/VideoRecorder.h"
+#include "core/Profiler.h"
+#include "core/Simd.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+
+// Full-range BT.601 (JPEG), matching the C420jpeg stream tag
+constexpr float kYR = 0.299f, kYG = 0.587f, kYB = 0.114f;
+constexpr float kUR = -0.168736f, kUG = -0.331264f, kUB = 0.5f;
+constexpr float kVR = 0.5f, kVG = -0.418688f, kVB = -0.081312f;
+
+uint8_t toByte(float value) {
+    return static_cast<uint8_t>(std::min(std::max(value, 0.0f), 255.0f) + 0.5f);
+}
+
+} // namespace
+
+VideoRecorder::VideoRecorder(JobSystem& jobs, int width, int height, VideoRecorderSettings settings)
+    : m_jobs(jobs), m_settings(std::move(settings)),
+      m_capture(jobs, width, height, std::max(2, std::min(m_settings.maxQueuedFrames, 4))),
+      m_output(nullptr), m_pipe(false), m_nextSequence(0), m_queued(0), m_stopping(false) {
+    if (m_settings.output.empty()) {
+        throw std::invalid_argument("VideoRecorder needs an output path or command");
+    }
+    if (m_settings.output[0] == '|') {
+        m_output = popen(m_settings.output.c_str() + 1, "w");
+        m_pipe = true;
+    } else {
+        m_output = std::fopen(m_settings.output.c_str(), "wb");
+    }
+    if (!m_output) {
+        throw std::runtime_error("Failed to open video output: " + m_settings.output);
+    }
+
+    std::fprintf(m_output, "YUV4MPEG2 W%d H%d F%d:%d Ip A1:1 C420jpeg\n", width, height,
+                 m_settings.fpsNumerator, m_settings.fpsDenominator);
+    m_writer = std::thread(&VideoRecorder::writerLoop, this);
+}
+
+VideoRecorder::~VideoRecorder() {
+    finish();
+}
+
+void VideoRecorder::recordFrame(GLuint framebuffer) {
+    LLR_PROFILE_FUNCTION();
+    m_capture.update();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_queued >= m_settings.maxQueuedFrames) {
+            if (m_settings.backpressure == VideoRecorderSettings::Backpressure::Drop) {
+                ++m_stats.droppedQueueFull;
+                return;
+            }
+            // Finish the readbacks and conversions in flight (helping with
+            // them on this thread), then wait for the writer
+            auto start = std::chrono::steady_clock::now();
+            lock.unlock();
+            m_capture.flush();
+            lock.lock();
+            m_queueChanged.wait(lock, [&] { return m_queued < m_settings.maxQueuedFrames; });
+            m_stats.blockedMilliseconds +=
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        ++m_queued;
+    }
+
+    bool accepted = m_capture.capture(framebuffer, m_nextSequence, [this](CapturedFrame& frame) {
+        if (!frame.isValid()) {
+            // An empty buffer tells the writer to skip this sequence
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_converted[frame.frameIndex] = {};
+            ++m_stats.failedReadback;
+            m_queueChanged.notify_all();
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<uint8_t> buffer;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_pool.empty()) {
+                buffer = std::move(m_pool.back());
+                m_pool.pop_back();
+            }
+        }
+        buffer.resize(getI420Size(frame.width, frame.height));
+        convertToI420(frame, buffer.data(), &m_jobs);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_converted[frame.frameIndex] = std::move(buffer);
+        m_stats.convertMilliseconds += ms;
+        m_queueChanged.notify_all();
+    });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (accepted) {
+        ++m_nextSequence;
+        ++m_stats.recorded;
+    } else {
+        --m_queued;
+        ++m_stats.droppedReadback;
+    }
+}
+
+void VideoRecorder::finish() {
+    if (!m_output) {
+        return;
+    }
+
+    // Every accepted frame is converted once the capture is flushed
+    m_capture.flush();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_queueChanged.notify_all();
+    m_writer.join();
+
+    if (m_pipe) {
+        pclose(m_output);
+    } else {
+        std::fclose(m_output);
+    }
+    m_output = nullptr;
+}
+
+VideoRecorderStats VideoRecorder::getStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void VideoRecorder::writerLoop() {
+    Profiler::setThreadName("Video writer");
+    uint64_t next = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_queueChanged.wait(lock, [&] { return m_stopping || m_converted.count(next) != 0; });
+        auto it = m_converted.find(next);
+        if (it == m_converted.end()) {
+            break;
+        }
+        std::vector<uint8_t> buffer = std::move(it->second);
+        m_converted.erase(it);
+        if (buffer.empty()) {
+            // Failed readback: nothing to write, but it no longer counts
+            // against the queue
+            --m_queued;
+            ++next;
+            m_queueChanged.notify_all();
+            continue;
+        }
+        lock.unlock();
+
+        bool ok;
+        {
+            LLR_PROFILE_SCOPE("Write video frame");
+            ok = std::fwrite("FRAME\n", 1, 6, m_output) == 6 &&
+                 std::fwrite(buffer.data(), 1, buffer.size(), m_output) == buffer.size();
+        }
+
+        lock.lock();
+        if (ok) {
+            ++m_stats.written;
+            m_stats.bytesWritten += buffer.size() + 6;
+        }
+        m_pool.push_back(std::move(buffer));
+        --m_queued;
+        ++next;
+        m_queueChanged.notify_all();
+    }
+}
+
+size_t VideoRecorder::getI420Size(int width, int height) {
+    size_t chromaWidth = static_cast<size_t>(width + 1) / 2;
+    size_t chromaHeight = static_cast<size_t>(height + 1) / 2;
+    return static_cast<size_t>(width) * height + 2 * chromaWidth * chromaHeight;
+}
+
+void VideoRecorder::convertToI420(const CapturedFrame& frame, uint8_t* out, JobSystem* jobs) {
+    const int width = frame.width;
+    const int height = frame.height;
+    const size_t chromaWidth = static_cast<size_t>(width + 1) / 2;
+    const size_t chromaHeight = static_cast<size_t>(height + 1) / 2;
+    uint8_t* planeY = out;
+    uint8_t* planeU = planeY + static_cast<size_t>(width) * height;
+    uint8_t* planeV = planeU + chromaWidth * chromaHeight;
+
+    // Rows are processed in pairs; a pair is deinterleaved into planar
+    // floats padded to four lanes (the last pixel repeats into the
+    // padding), Y and the summed U/V of both rows are computed four
+    // pixels at a time, then horizontal pairs are averaged while packing.
+    // U and V are linear in RGB, so averaging them equals converting the
+    // averaged 2x2 block.
+    const size_t paddedWidth = (chromaWidth * 2 + 3) & ~size_t(3);
+    auto convertRows = [&](size_t begin, size_t end) {
+        std::vector<float> scratch(paddedWidth * 10);
+        float* r[2] = { &scratch[0], &scratch[paddedWidth * 3] };
+        float* g[2] = { &scratch[paddedWidth], &scratch[paddedWidth * 4] };
+        float* b[2] = { &scratch[paddedWidth * 2], &scratch[paddedWidth * 5] };
+        float* y[2] = { &scratch[paddedWidth * 6], &scratch[paddedWidth * 7] };
+        float* u = &scratch[paddedWidth * 8];
+        float* v = &scratch[paddedWidth * 9];
+
+        const Float4 yr(kYR), yg(kYG), yb(kYB), ur(kUR), ug(kUG), ub(kUB), vr(kVR), vg(kVG), vb(kVB);
+        for (size_t cy = begin; cy < end; ++cy) {
+            int rows[2] = { static_cast<int>(cy * 2), std::min(static_cast<int>(cy * 2 + 1), height - 1) };
+            for (int k = 0; k < 2; ++k) {
+                const uint8_t* src = frame.rgba.data() + static_cast<size_t>(rows[k]) * width * 4;
+                for (size_t x = 0; x < paddedWidth; ++x) {
+                    size_t sx = std::min(x, static_cast<size_t>(width - 1)) * 4;
+                    r[k][x] = src[sx];
+                    g[k][x] = src[sx + 1];
+                    b[k][x] = src[sx + 2];
+                }
+            }
+
+            for (size_t x = 0; x < paddedWidth; x += 4) {
+                Float4 r0 = Float4::load(r[0] + x), g0 = Float4::load(g[0] + x), b0 = Float4::load(b[0] + x);
+                Float4 r1 = Float4::load(r[1] + x), g1 = Float4::load(g[1] + x), b1 = Float4::load(b[1] + x);
+                madd(r0, yr, madd(g0, yg, b0 * yb)).store(y[0] + x);
+                madd(r1, yr, madd(g1, yg, b1 * yb)).store(y[1] + x);
+                Float4 rs = r0 + r1, gs = g0 + g1, bs = b0 + b1;
+                madd(rs, ur, madd(gs, ug, bs * ub)).store(u + x);
+                madd(rs, vr, madd(gs, vg, bs * vb)).store(v + x);
+            }
+
+            for (int k = 0; k < 2; ++k) {
+                if (k == 1 && rows[1] == rows[0]) {
+                    break;
+                }
+                uint8_t* dst = planeY + static_cast<size_t>(rows[k]) * width;
+                for (int x = 0; x < width; ++x) {
+                    dst[x] = toByte(y[k][x]);
+                }
+            }
+            uint8_t* dstU = planeU + cy * chromaWidth;
+            uint8_t* dstV = planeV + cy * chromaWidth;
+            for (size_t x = 0; x < chromaWidth; ++x) {
+                dstU[x] = toByte((u[x * 2] + u[x * 2 + 1]) * 0.25f + 128.0f);
+                dstV[x] = toByte((v[x * 2] + v[x * 2 + 1]) * 0.25f + 128.0f);
+            }
+        }
+    };
+
+    if (jobs) {
+        jobs->parallelFor(chromaHeight, convertRows, 16);
+    } else {
+        convertRows(0, chromaHeight);
+    }
+}
@@ -1,19 +1,48 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 #include <glad/glad.h>
 
+#include "app/HeadlessContext.h"
+#include "app/RenderThread.h"
 #include "app/Window.h"
+#include "core/FramePacer.h"
+#include "core/JobSystem.h"
+#include "core/Profiler.h"
+#include "core/TripleBuffer.h"
+#include "graphics/ClusteredLighting.h"
+#include "graphics/DynamicResolution.h"
+#include "graphics/FrameCapture.h"
+#include "graphics/Framebuffer.h"
+#include "graphics/GpuProfiler.h"
+#include "graphics/GpuResourceManager.h"
+#include "graphics/RenderGraph.h"
 #include "graphics/ShaderProgram.h"
+#include "graphics/StreamBuffer.h"
+#include "graphics/TextureStreamer.h"
+#include "graphics/UploadContext.h"
+#include "graphics/VideoRecorder.h"
+#include "scene/LightClusters.h"
+#include "scene/Mesh.h"
+#include "scene/MeshCache.h"
+#include "scene/MeshClusters.h"
+#include "scene/OcclusionCuller.h"
 
 // Placeholder for future components
 // #include "core/MemoryPool.h"
 // #include "scene/Camera.h"
-// #include "scene/Mesh.h"
 
-void initializeOpenGL() {
+void initializeOpenGL(GLADloadproc loader) {
     // Load OpenGL functions using GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (!gladLoadGLLoader(loader)) {
         throw std::runtime_error("Failed to initialize GLAD");
     }
     
@@ -68,17 +97,286 @@ void main() {
 }
 )";
 
-int main() {
-    try {
-        // Create window
-        Window window(1280, 720, "LowLevelRenderer");
-        
-        // Initialize OpenGL
-        initializeOpenGL();
-        
-        // Create shader program
-        ShaderProgram shader;
-        if (!shader.compile(basicVertexShader, basicFragmentShader)) {
+// Cards showing the streamed textures
+const char* cardVertexShader = R"(
+#version 410 core
+layout(location = 0) in vec2 aPosition;
+layout(location = 1) in vec2 aUv;
+
+uniform mat4 uProjection;
+uniform mat4 uView;
+uniform mat4 uModel;
+
+out vec2 vUv;
+
+void main() {
+    gl_Position = uProjection * uView * uModel * vec4(aPosition, 0.0, 1.0);
+    vUv = aUv;
+}
+)";
+
+const char* cardFragmentShader = R"(
+#version 410 core
+in vec2 vUv;
+uniform sampler2D uTexture;
+out vec4 fragColor;
+
+void main() {
+    fragColor = vec4(texture(uTexture, vUv).rgb, 1.0);
+}
+)";
+
+// Backdrop lit by the point lights of its cluster
+const char* litVertexShader = R"(
+#version 410 core
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+
+uniform mat4 uProjection;
+uniform mat4 uView;
+
+out vec3 vWorldPosition;
+out vec3 vNormal;
+out float vViewDepth;
+
+void main() {
+    vec4 viewPosition = uView * vec4(aPosition, 1.0);
+    vWorldPosition = aPosition;
+    vNormal = aNormal;
+    vViewDepth = -viewPosition.z;
+    gl_Position = uProjection * viewPosition;
+}
+)";
+
+// ClusteredLighting::getShaderSource() goes between the two halves
+const char* litFragmentShaderHeader = R"(
+#version 410 core
+)";
+
+const char* litFragmentShaderBody = R"(
+in vec3 vWorldPosition;
+in vec3 vNormal;
+in float vViewDepth;
+out vec4 fragColor;
+
+void main() {
+    vec3 albedo = vec3(0.8);
+    vec3 color = albedo * 0.1 + evaluateClusteredLights(vWorldPosition, vNormal, albedo, vViewDepth);
+    fragColor = vec4(color, 1.0);
+}
+)";
+
+// Fullscreen triangle from gl_VertexID; draw 3 vertices with an empty VAO
+const char* fullscreenVertexShader = R"(
+#version 410 core
+out vec2 vUv;
+
+void main() {
+    vUv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(vUv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+// Post shaders read the rendered part of their source: uUvScale maps the
+// viewport onto it, uUvMax keeps bilinear taps off the unused texels
+const char* gradeFragmentShader = R"(
+#version 410 core
+in vec2 vUv;
+out vec4 fragColor;
+
+uniform sampler2D uSource;
+uniform vec2 uUvScale;
+uniform vec2 uUvMax;
+
+void main() {
+    vec3 color = texture(uSource, min(vUv * uUvScale, uUvMax)).rgb;
+    float luma = dot(color, vec3(0.2126, 0.7152, 0.0722));
+    color = mix(vec3(luma), color, 1.15);
+    color = (color - 0.5) * 1.1 + 0.5;
+    fragColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
+)";
+
+const char* vignetteFragmentShader = R"(
+#version 410 core
+in vec2 vUv;
+out vec4 fragColor;
+
+uniform sampler2D uSource;
+uniform vec2 uUvScale;
+uniform vec2 uUvMax;
+
+void main() {
+    float edge = length(vUv - 0.5) * 1.4142;
+    vec3 color = texture(uSource, min(vUv * uUvScale, uUvMax)).rgb;
+    fragColor = vec4(color * (1.0 - 0.35 * edge * edge), 1.0);
+}
+)";
+
+// Bilinear upscale with an optional unsharp mask over the neighbouring
+// source texels
+const char* upscaleFragmentShader = R"(
+#version 410 core
+in vec2 vUv;
+out vec4 fragColor;
+
+uniform sampler2D uSource;
+uniform vec2 uUvScale;
+uniform vec2 uUvMax;
+uniform float uSharpness;
+
+vec3 fetch(vec2 uv) {
+    return texture(uSource, min(uv * uUvScale, uUvMax)).rgb;
+}
+
+void main() {
+    vec3 color = fetch(vUv);
+    if (uSharpness > 0.0) {
+        vec2 texel = 1.0 / (vec2(textureSize(uSource, 0)) * uUvScale);
+        vec3 blur = (fetch(vUv + vec2(texel.x, 0.0)) + fetch(vUv - vec2(texel.x, 0.0)) +
+                     fetch(vUv + vec2(0.0, texel.y)) + fetch(vUv - vec2(0.0, texel.y))) * 0.25;
+        color = clamp(color + (color - blur) * uSharpness, 0.0, 1.0);
+    }
+    fragColor = vec4(color, 1.0);
+}
+)";
+
+struct Options {
+    bool headless = false;
+    int width = 1280;
+    int height = 720;
+    int frames = 600;               // Headless only
+    int dumpInterval = 0;           // Save every Nth headless frame, 0 = never
+    std::string dumpPrefix = "frame";
+    std::string frameTimesPath;     // Per-frame milliseconds as CSV
+    std::string recordOutput;       // Y4M file, or "|command" to pipe into
+    int recordFps = 60;
+    Window::VSync vsync = Window::VSync::On;
+    double fpsLimit = 0.0;          // 0 = unlimited
+    double simulationHz = 60.0;
+    bool renderThread = false;      // Render on a thread separate from events
+    bool captureMouse = false;      // Mouse look with a hidden cursor
+    double dynamicResolutionMs = 0.0;   // GPU frame time target, 0 = fixed resolution
+    float minRenderScale = 0.5f;
+    float sharpness = 0.0f;         // Upscale sharpening, 0 = off
+    int lightCount = 0;             // Clustered point lights on a backdrop, 0 = none
+    std::string meshPath;           // Cooked .llrmesh drawn instead of the triangle
+    bool uploadThread = false;      // Upload the mesh on a shared context (windowed, not --render-thread)
+    std::string textureDirectory;   // Cooked .llrtex files streamed onto cards
+    size_t textureBudgetMB = 64;
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                throw std::runtime_error("--size expects WIDTHxHEIGHT");
+            }
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--dump-every" && hasValue) {
+            options.dumpInterval = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--dump-prefix" && hasValue) {
+            options.dumpPrefix = argv[++i];
+        } else if (arg == "--frame-times" && hasValue) {
+            options.frameTimesPath = argv[++i];
+        } else if (arg == "--record" && hasValue) {
+            options.recordOutput = argv[++i];
+        } else if (arg == "--record-fps" && hasValue) {
+            options.recordFps = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--render-thread") {
+            options.renderThread = true;
+        } else if (arg == "--capture-mouse") {
+            options.captureMouse = true;
+        } else if (arg == "--vsync" && hasValue) {
+            std::string mode = argv[++i];
+            if (mode == "off") {
+                options.vsync = Window::VSync::Off;
+            } else if (mode == "on") {
+                options.vsync = Window::VSync::On;
+            } else if (mode == "adaptive") {
+                options.vsync = Window::VSync::Adaptive;
+            } else {
+                throw std::runtime_error("--vsync expects off, on or adaptive");
+            }
+        } else if (arg == "--fps-limit" && hasValue) {
+            options.fpsLimit = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--sim-hz" && hasValue) {
+            options.simulationHz = std::max(1.0, std::atof(argv[++i]));
+        } else if (arg == "--dynamic-res" && hasValue) {
+            options.dynamicResolutionMs = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--min-render-scale" && hasValue) {
+            options.minRenderScale = std::clamp(static_cast<float>(std::atof(argv[++i])), 0.1f, 1.0f);
+        } else if (arg == "--lights" && hasValue) {
+            options.lightCount = std::clamp(std::atoi(argv[++i]), 0, 0xFFFF);
+        } else if (arg == "--mesh" && hasValue) {
+            options.meshPath = argv[++i];
+        } else if (arg == "--upload-thread") {
+            options.uploadThread = true;
+        } else if (arg == "--textures" && hasValue) {
+            options.textureDirectory = argv[++i];
+        } else if (arg == "--texture-budget" && hasValue) {
+            options.textureBudgetMB = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--sharpen" && hasValue) {
+            options.sharpness = std::clamp(static_cast<float>(std::atof(argv[++i])), 0.0f, 2.0f);
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg + "\nUsage: LLR [--headless] [--size WxH] [--frames N] "
+                                     "[--dump-every N] [--dump-prefix path] [--frame-times file.csv] "
+                                     "[--record file.y4m|\"|command\"] [--record-fps N] "
+                                     "[--vsync off|on|adaptive] [--fps-limit N] [--sim-hz N] [--render-thread] "
+                                     "[--capture-mouse] [--dynamic-res MS] [--min-render-scale S] [--sharpen S] [--lights N] "
+                                     "[--mesh file.llrmesh] [--upload-thread] [--textures dir] [--texture-budget MB]");
+        }
+    }
+    return options;
+}
+
+// Demo simulation state, advanced in fixed steps
+struct DemoSimulation {
+    float angle = 0.0f;
+    float previousAngle = 0.0f;
+    
+    void step(float seconds) {
+        const float radiansPerSecond = 1.0f;
+        previousAngle = angle;
+        angle += radiansPerSecond * seconds;
+    }
+    
+    // Once per tick. Mouse motion turns the triangle right away rather
+    // than per step, so both interpolated states turn with it.
+    void applyInput(const InputFrame& input) {
+        const float radiansPerPixel = 0.005f;
+        float turn = input.mouseDeltaX * radiansPerPixel;
+        angle += turn;
+        previousAngle += turn;
+    }
+    
+    // alpha blends the previous step (0) into the latest (1)
+    float getAngle(float alpha) const {
+        return previousAngle + (angle - previousAngle) * alpha;
+    }
+};
+
+// Demo content shared by the windowed and headless paths
+class DemoScene {
+public:
+    explicit DemoScene(GpuResourceManager& resources)
+        : m_shader(resources), m_gradeShader(resources), m_vignetteShader(resources), m_upscaleShader(resources),
+          m_litShader(resources), m_cardShader(resources), m_resources(resources), m_graph(resources) {
+        // Create shader programs
+        if (!m_shader.compile(basicVertexShader, basicFragmentShader) ||
+            !m_gradeShader.compile(fullscreenVertexShader, gradeFragmentShader) ||
+            !m_vignetteShader.compile(fullscreenVertexShader, vignetteFragmentShader) ||
+            !m_upscaleShader.compile(fullscreenVertexShader, upscaleFragmentShader) ||
+            !m_litShader.compile(litVertexShader, std::string(litFragmentShaderHeader) +
+                                                      ClusteredLighting::getShaderSource() + litFragmentShaderBody) ||
+            !m_cardShader.compile(cardVertexShader, cardFragmentShader)) {
             throw std::runtime_error("Failed to compile shaders");
         }
         
@@ -95,13 +393,11 @@ int main() {
         };
         
         // Create vertex buffer
-        GLuint vao, vbo;
-        glGenVertexArrays(1, &vao);
-        glGenBuffers(1, &vbo);
+        m_vao = m_resources.createVertexArray();
+        m_vbo = m_resources.createBuffer(sizeof(vertices), vertices, GL_STATIC_DRAW);
         
-        glBindVertexArray(vao);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glBindVertexArray(m_resources.get(m_vao));
+        glBindBuffer(GL_ARRAY_BUFFER, m_resources.get(m_vbo));
         
         // Position attribute
         glEnableVertexAttribArray(0);
@@ -113,43 +409,1099 @@ int main() {
         
         glBindVertexArray(0);
         
-        // Main loop
-        while (!window.shouldClose()) {
-            // Clear screen
-            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            
-            // Set up identity matrices for demo
+        // Attributeless VAO for the fullscreen passes
+        m_emptyVao = m_resources.createVertexArray();
+        
+        // Backdrop wall behind the triangle, facing the camera
+        const float wallZ = -0.5f, wallSize = 3.0f;
+        float wall[6][6] = {
+            { -wallSize, -wallSize, wallZ, 0.0f, 0.0f, 1.0f }, { wallSize, -wallSize, wallZ, 0.0f, 0.0f, 1.0f },
+            { wallSize, wallSize, wallZ, 0.0f, 0.0f, 1.0f }, { -wallSize, -wallSize, wallZ, 0.0f, 0.0f, 1.0f },
+            { wallSize, wallSize, wallZ, 0.0f, 0.0f, 1.0f }, { -wallSize, wallSize, wallZ, 0.0f, 0.0f, 1.0f }
+        };
+        m_wallVao = m_resources.createVertexArray();
+        m_wallVbo = m_resources.createBuffer(sizeof(wall), wall, GL_STATIC_DRAW);
+        glBindVertexArray(m_resources.get(m_wallVao));
+        glBindBuffer(GL_ARRAY_BUFFER, m_resources.get(m_wallVbo));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(wall[0]), (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(wall[0]), (void*)(3 * sizeof(float)));
+        glBindVertexArray(0);
+        
+        // Unit card in the xy plane: position, uv
+        float card[6][4] = {
+            { -0.5f, -0.5f, 0.0f, 1.0f }, { 0.5f, -0.5f, 1.0f, 1.0f }, { 0.5f, 0.5f, 1.0f, 0.0f },
+            { -0.5f, -0.5f, 0.0f, 1.0f }, { 0.5f, 0.5f, 1.0f, 0.0f }, { -0.5f, 0.5f, 0.0f, 0.0f }
+        };
+        m_cardVao = m_resources.createVertexArray();
+        m_cardVbo = m_resources.createBuffer(sizeof(card), card, GL_STATIC_DRAW);
+        glBindVertexArray(m_resources.get(m_cardVao));
+        glBindBuffer(GL_ARRAY_BUFFER, m_resources.get(m_cardVbo));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(card[0]), (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(card[0]), (void*)(2 * sizeof(float)));
+        glBindVertexArray(0);
+    }
+    
+    ~DemoScene() {
+        m_resources.destroy(m_vao);
+        m_resources.destroy(m_vbo);
+        m_resources.destroy(m_emptyVao);
+        m_resources.destroy(m_wallVao);
+        m_resources.destroy(m_wallVbo);
+        m_resources.destroy(m_cardVao);
+        m_resources.destroy(m_cardVbo);
+    }
+    
+    // Render into the framebuffer 'output' (0 for the window) through the
+    // frame graph: scene -> grade -> vignette -> present. The scene and
+    // vignette targets share one texture since their lifetimes don't overlap.
+    //
+    // Below renderScale 1 the scene and post passes cover only the
+    // lower-left part of their targets and present upscales it. Targets
+    // stay at the output size, so a changing scale never reallocates them.
+    void draw(GpuProfiler& gpuProfiler, GLuint output, int width, int height, float renderScale, float angle) {
+        int renderWidth = std::clamp(static_cast<int>(std::lround(width * renderScale)), 1, width);
+        int renderHeight = std::clamp(static_cast<int>(std::lround(height * renderScale)), 1, height);
+        glm::vec2 uvScale(static_cast<float>(renderWidth) / width, static_cast<float>(renderHeight) / height);
+        glm::vec2 uvMax((renderWidth - 0.5f) / width, (renderHeight - 0.5f) / height);
+        
+        finishMeshUpload();
+        m_graph.reset();
+        RenderGraphTextureDesc colorDesc{ width, height, GL_RGBA8 };
+        RenderGraphTexture sceneColor = m_graph.createTexture("SceneColor", colorDesc);
+        RenderGraphTexture sceneDepth = m_graph.createTexture("SceneDepth", { width, height, GL_DEPTH_COMPONENT24 });
+        RenderGraphTexture graded = m_graph.createTexture("Graded", colorDesc);
+        RenderGraphTexture vignetted = m_graph.createTexture("Vignetted", colorDesc);
+        
+        m_graph.addPass("Scene", [=, this](const RenderGraph::PassContext&) {
+            glViewport(0, 0, renderWidth, renderHeight);
+            drawScene(width, height, renderWidth, renderHeight, angle);
+        })
+            .writeColor(sceneColor, RenderGraphLoad::DontCare)
+            .writeDepth(sceneDepth, RenderGraphLoad::Clear);
+        
+        m_graph.addPass("Grade", [=, this](const RenderGraph::PassContext& context) {
+            glViewport(0, 0, renderWidth, renderHeight);
+            drawFullscreen(m_gradeShader, context.getTexture(sceneColor), uvScale, uvMax);
+        })
+            .read(sceneColor)
+            .writeColor(graded, RenderGraphLoad::DontCare);
+        
+        m_graph.addPass("Vignette", [=, this](const RenderGraph::PassContext& context) {
+            glViewport(0, 0, renderWidth, renderHeight);
+            drawFullscreen(m_vignetteShader, context.getTexture(graded), uvScale, uvMax);
+        })
+            .read(graded)
+            .writeColor(vignetted, RenderGraphLoad::DontCare);
+        
+        m_graph.addPass("Present", [=, this](const RenderGraph::PassContext& context) {
+            glBindFramebuffer(GL_FRAMEBUFFER, output);
+            glViewport(0, 0, width, height);
+            m_upscaleShader.bind();
+            m_upscaleShader.setUniform("uSharpness", renderWidth < width ? m_sharpness : 0.0f);
+            drawFullscreen(m_upscaleShader, context.getTexture(vignetted), uvScale, uvMax);
+        })
+            .read(vignetted)
+            .setSideEffect();
+        
+        m_graph.execute(&gpuProfiler);
+        glBindFramebuffer(GL_FRAMEBUFFER, output);
+    }
+    
+    // Unsharp mask strength applied when upscaling
+    void setSharpness(float sharpness) { m_sharpness = sharpness; }
+    
+    // Point lights circling in front of a backdrop, shaded through the
+    // light clusters; 0 leaves the backdrop out
+    void setLightCount(int count) { m_lights.resize(static_cast<size_t>(std::clamp(count, 0, 0xFFFF))); }
+    const LightClusterStats& getLightStats() const { return m_lightStats; }
+    
+    // Replace the triangle with a cooked mesh. With clusters in the file,
+    // each frame culls them on the job system and packs the surviving
+    // index ranges into a stream buffer that the mesh is drawn from.
+    //
+    // With an upload context the buffers are filled on its thread straight
+    // from the mapping and the triangle stays up until they land. The
+    // context must be destroyed before the scene.
+    bool loadMesh(const std::string& path, JobSystem* jobs, UploadContext* uploads = nullptr) {
+        if (!m_meshCache.open(path)) {
+            return false;
+        }
+        if (uploads) {
+            m_vertexUpload = uploads->createBuffer(GL_ARRAY_BUFFER, m_meshCache.getVertices(),
+                                                   m_meshCache.getVertexCount() * sizeof(MeshVertex));
+            m_indexUpload = uploads->createBuffer(GL_ARRAY_BUFFER, m_meshCache.getIndices(),
+                                                  m_meshCache.getIndexCount() * sizeof(uint32_t));
+        } else {
+            m_mesh = std::make_unique<Mesh>(m_meshCache);
+        }
+        if (m_meshCache.getClusterCount() > 0) {
+            size_t maxIndices = m_meshCache.getLodCount() > 0 ? m_meshCache.getLods()[0].indexCount
+                                                              : m_meshCache.getIndexCount();
+            m_clusterCuller = std::make_unique<ClusterCuller>(m_meshCache.getClusters(), m_meshCache.getClusterCount());
+            m_clusterIndices = std::make_unique<StreamBuffer>(GL_ELEMENT_ARRAY_BUFFER, maxIndices * sizeof(uint32_t));
+        } else {
+            std::cout << "Mesh has no clusters; drawing whole LODs: " << path << std::endl;
+        }
+        
+        // Scaled to fit where the triangle was
+        const MeshBounds& bounds = m_meshCache.getBounds();
+        float extent = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            m_meshCenter[axis] = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+            extent = std::max(extent, bounds.max[axis] - bounds.min[axis]);
+        }
+        m_meshScale = 1.2f / std::max(extent, 1e-6f);
+        m_jobs = jobs;
+        return true;
+    }
+    
+    // Two rows of cards fly past the camera, each showing one of the cooked
+    // textures in the directory. The cards' visibility pass reports their
+    // on-screen size to the streamer, which pages the mips they need in
+    // within the budget. The jobs must outlive the scene.
+    bool loadTextures(const std::string& directory, JobSystem& jobs, size_t budgetBytes) {
+        std::vector<std::string> paths;
+        std::error_code error;
+        for (const auto& item : std::filesystem::directory_iterator(directory, error)) {
+            if (item.is_regular_file() && item.path().extension() == ".llrtex") {
+                paths.push_back(item.path().string());
+            }
+        }
+        if (error || paths.empty()) {
+            std::cerr << "No cooked textures in " << directory << std::endl;
+            return false;
+        }
+        std::sort(paths.begin(), paths.end());
+        
+        TextureStreamerSettings settings;
+        settings.budgetBytes = budgetBytes;
+        m_textureStreamer = std::make_unique<TextureStreamer>(jobs, settings);
+        for (const auto& path : paths) {
+            StreamedTextureHandle handle = m_textureStreamer->add(path);
+            if (handle == kInvalidStreamedTexture) {
+                return false;
+            }
+            m_streamedTextures.push_back(handle);
+        }
+        m_jobs = &jobs;
+        return true;
+    }
+    
+    // Null without --textures
+    const TextureStreamer* getTextureStreamer() const { return m_textureStreamer.get(); }
+    // Cards hidden behind the mesh or triangle, summed over every frame
+    const OcclusionStats& getCardOcclusionStats() const { return m_occlusionStats; }
+    uint64_t getCardOcclusionFrames() const { return m_occlusionFrames; }
+    // Peaks over every frame, to check against the streamer's limits
+    const TextureStreamerStats& getTexturePeaks() const { return m_texturePeaks; }
+    
+    // Level the last unclustered draw used, -1 before any
+    int getMeshLod() const { return m_meshLod; }
+    const Mesh* getMesh() const { return m_mesh.get(); }
+    
+    // Summed over every culled frame
+    const ClusterCullStats& getClusterStats() const { return m_clusterStats; }
+    uint64_t getClusterFrames() const { return m_clusterFrames; }
+    
+    const RenderGraph& getRenderGraph() const { return m_graph; }
+    
+private:
+    ShaderProgram m_shader;
+    ShaderProgram m_gradeShader;
+    ShaderProgram m_vignetteShader;
+    ShaderProgram m_upscaleShader;
+    ShaderProgram m_litShader;
+    ShaderProgram m_cardShader;
+    GpuResourceManager& m_resources;
+    RenderGraph m_graph;
+    VertexArrayHandle m_vao;
+    VertexArrayHandle m_emptyVao;
+    BufferHandle m_vbo;
+    VertexArrayHandle m_wallVao;
+    BufferHandle m_wallVbo;
+    VertexArrayHandle m_cardVao;
+    BufferHandle m_cardVbo;
+    float m_sharpness = 0.0f;
+    std::vector<PointLight> m_lights;
+    LightClusterGrid m_lightGrid;
+    ClusteredLighting m_clusteredLighting;
+    LightClusterStats m_lightStats;
+    MeshCacheFile m_meshCache;
+    std::unique_ptr<Mesh> m_mesh;
+    glm::vec3 m_meshCenter{ 0.0f };
+    float m_meshScale = 1.0f;
+    int m_meshLod = -1;
+    std::shared_ptr<UploadTicket> m_vertexUpload;
+    std::shared_ptr<UploadTicket> m_indexUpload;
+    std::unique_ptr<ClusterCuller> m_clusterCuller;
+    std::unique_ptr<StreamBuffer> m_clusterIndices;
+    std::vector<uint32_t> m_visibleClusters;
+    ClusterCullStats m_clusterStats;
+    uint64_t m_clusterFrames = 0;
+    JobSystem* m_jobs = nullptr;
+    std::unique_ptr<TextureStreamer> m_textureStreamer;
+    std::vector<StreamedTextureHandle> m_streamedTextures;
+    struct VisibleCard {
+        glm::vec3 position;
+        StreamedTextureHandle texture;
+        float depth;
+    };
+    std::vector<VisibleCard> m_visibleCards;
+    std::vector<MeshBounds> m_cardBounds;
+    std::vector<uint8_t> m_cardVisible;
+    OcclusionCuller m_occlusionCuller;
+    OcclusionStats m_occlusionStats;    // Summed over every frame with cards
+    uint64_t m_occlusionFrames = 0;
+    TextureStreamerStats m_texturePeaks;
+    
+    // Adopt the mesh buffers once both uploads have landed
+    void finishMeshUpload() {
+        if (!m_vertexUpload || !m_vertexUpload->isComplete() || !m_indexUpload->isComplete()) {
+            return;
+        }
+        GLuint vertexBuffer = m_vertexUpload->getObject();
+        GLuint indexBuffer = m_indexUpload->getObject();
+        if (m_vertexUpload->hasFailed() || m_indexUpload->hasFailed()) {
+            std::cerr << "Mesh upload failed; keeping the triangle" << std::endl;
+            glDeleteBuffers(1, &vertexBuffer);
+            glDeleteBuffers(1, &indexBuffer);
+        } else {
+            m_mesh = std::make_unique<Mesh>(vertexBuffer, m_meshCache.getVertexCount(), indexBuffer,
+                                            m_meshCache.getIndexCount(), m_meshCache.getLods(),
+                                            m_meshCache.getLodCount());
+        }
+        m_vertexUpload.reset();
+        m_indexUpload.reset();
+    }
+    
+    // Viewport is the render size; the matrices use the output aspect
+    void drawScene(int width, int height, int renderWidth, int renderHeight, float angle) {
+        // Background clear; the graph only clears to black
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        
+        // Set up matrices for demo; the camera sits two units back so the
+        // triangle at z = 0 is in front of the near plane
+        glm::mat4 model(1.0f);
+        model[0][0] = std::cos(angle);
+        model[0][1] = std::sin(angle);
+        model[1][0] = -std::sin(angle);
+        model[1][1] = std::cos(angle);
+        glm::mat4 view(1.0f);
+        view[3][2] = -2.0f;
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 
+                                                (float)width / height, 
+                                                0.1f, 100.0f);
+        
+        // Bind shader and set uniforms
+        m_shader.bind();
+        m_shader.setUniform("uModel", model);
+        m_shader.setUniform("uView", view);
+        m_shader.setUniform("uProjection", projection);
+        
+        if (!m_lights.empty()) {
+            drawLitBackdrop(view, projection, (float)width / height, renderWidth, renderHeight, angle);
+            m_shader.bind();
+        }
+        
+        if (m_textureStreamer) {
+            drawTextureCards(view, projection, model, (float)width / height, renderHeight, angle);
+            m_shader.bind();
+        }
+        
+        if (m_mesh) {
+            drawMesh(view, projection, renderHeight, angle);
+            return;
+        }
+        
+        // Draw triangle
+        glBindVertexArray(m_resources.get(m_vao));
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+    }
+    
+    // The mesh spins about the vertical axis: rotateY * scale * translate(-center)
+    glm::mat4 getMeshModel(float angle) const {
+        const glm::vec3& center = m_meshCenter;
+        float scale = m_meshScale;
+        float c = std::cos(angle), s = std::sin(angle);
+        glm::mat4 model(1.0f);
+        model[0][0] = c * scale;
+        model[0][2] = -s * scale;
+        model[1][1] = scale;
+        model[2][0] = s * scale;
+        model[2][2] = c * scale;
+        model[3][0] = -scale * (c * center[0] + s * center[2]);
+        model[3][1] = -scale * center[1];
+        model[3][2] = -scale * (-s * center[0] + c * center[2]);
+        return model;
+    }
+    
+    // The mesh's normals show through the basic shader's color input
+    void drawMesh(const glm::mat4& view, const glm::mat4& projection, int renderHeight, float angle) {
+        const glm::vec3& center = m_meshCenter;
+        float scale = m_meshScale;
+        float c = std::cos(angle), s = std::sin(angle);
+        glm::mat4 model = getMeshModel(angle);
+        m_shader.setUniform("uModel", model);
+        
+        if (!m_clusterCuller) {
+            // Coarsest level whose error stays under a pixel at the render
+            // size. The camera is 2 units from the center, 2 / scale in the
+            // mesh's own units that the level errors are measured in.
+            m_meshLod = m_mesh->selectLod(2.0f / scale, glm::radians(45.0f), renderHeight);
+            m_mesh->drawLod(m_meshLod);
+            return;
+        }
+        
+        // The camera sits at (0, 0, 2); take it back through the model transform
+        float eye[3] = { -2.0f * s / scale + center[0], center[1], 2.0f * c / scale + center[2] };
+        glm::mat4 modelViewProjection = projection * view * model;
+        ClusterCullView cullView = makeClusterCullView(glm::value_ptr(modelViewProjection), eye);
+        
+        ClusterCullStats stats;
+        m_clusterCuller->cull(cullView, m_visibleClusters, m_jobs, &stats);
+        size_t indexCount = m_clusterCuller->getIndexCount(m_visibleClusters);
+        if (indexCount > 0) {
+            StreamBuffer::Allocation allocation = m_clusterIndices->map(indexCount * sizeof(uint32_t), sizeof(uint32_t));
+            m_clusterCuller->compact(m_meshCache.getIndices(), m_visibleClusters, static_cast<uint32_t*>(allocation.data),
+                                     m_jobs, &stats);
+            m_clusterIndices->unmap();
+            m_mesh->drawIndices(m_clusterIndices->getId(), static_cast<size_t>(allocation.offset), indexCount);
+        }
+        m_clusterIndices->endFrame();
+        
+        m_clusterStats.clustersTested += stats.clustersTested;
+        m_clusterStats.clustersVisible += stats.clustersVisible;
+        m_clusterStats.trianglesTested += stats.trianglesTested;
+        m_clusterStats.trianglesVisible += stats.trianglesVisible;
+        m_clusterStats.cullMilliseconds += stats.cullMilliseconds;
+        m_clusterStats.compactMilliseconds += stats.compactMilliseconds;
+        ++m_clusterFrames;
+    }
+    
+    // Visibility pass first: cards outside the frustum or hidden behind the
+    // mesh (or the triangle) are dropped, each remaining card requests its
+    // texture at its projected size, then the streamer updates once and the
+    // cards are drawn with whatever is resident
+    void drawTextureCards(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& triangleModel,
+                          float aspect, int renderHeight, float angle) {
+        const int cardCount = 24;
+        const float cardSize = 0.8f, spacing = 1.0f, span = cardCount / 2 * spacing;
+        const float fovY = glm::radians(45.0f), nearPlane = 0.1f;
+        const float tanY = std::tan(fovY * 0.5f), tanX = tanY * aspect;
+        const float radius = cardSize * 0.7072f;
+        
+        m_visibleCards.clear();
+        m_cardBounds.clear();
+        for (int i = 0; i < cardCount; ++i) {
+            // Rows either side of the view axis, moving towards the camera
+            // and wrapping back to the far end once they pass it
+            glm::vec3 position((i % 2 == 0 ? -1.0f : 1.0f) * 0.9f, 0.0f,
+                               1.8f - std::fmod((i / 2) * spacing + angle * 0.8f, span));
+            glm::vec4 center = view * glm::vec4(position, 1.0f);
+            float depth = -center.z;
+            if (depth + radius < nearPlane || std::abs(center.x) - radius > depth * tanX ||
+                std::abs(center.y) - radius > depth * tanY) {
+                continue;
+            }
+            StreamedTextureHandle handle = m_streamedTextures[static_cast<size_t>(i) % m_streamedTextures.size()];
+            m_visibleCards.push_back({ position, handle, depth });
+            MeshBounds bounds;
+            for (int axis = 0; axis < 3; ++axis) {
+                float halfSize = axis < 2 ? cardSize * 0.5f : 0.0f;
+                bounds.min[axis] = position[axis] - halfSize;
+                bounds.max[axis] = position[axis] + halfSize;
+            }
+            m_cardBounds.push_back(bounds);
+        }
+        
+        cullOccludedCards(projection * view, triangleModel, angle);
+        for (const VisibleCard& card : m_visibleCards) {
+            m_textureStreamer->request(card.texture, TextureStreamer::computeScreenSize(
+                                                         cardSize, std::max(card.depth, nearPlane), fovY, renderHeight));
+        }
+        
+        m_textureStreamer->update();
+        const TextureStreamerStats& stats = m_textureStreamer->getStats();
+        m_texturePeaks.residentBytes = std::max(m_texturePeaks.residentBytes, stats.residentBytes);
+        m_texturePeaks.wantedBytes = std::max(m_texturePeaks.wantedBytes, stats.wantedBytes);
+        m_texturePeaks.loadsInFlight = std::max(m_texturePeaks.loadsInFlight, stats.loadsInFlight);
+        m_texturePeaks.uploadsThisFrame = std::max(m_texturePeaks.uploadsThisFrame, stats.uploadsThisFrame);
+        m_texturePeaks.uploadedBytesThisFrame = std::max(m_texturePeaks.uploadedBytesThisFrame,
+                                                         stats.uploadedBytesThisFrame);
+        
+        m_cardShader.bind();
+        m_cardShader.setUniform("uView", view);
+        m_cardShader.setUniform("uProjection", projection);
+        m_cardShader.setUniform("uTexture", 0);
+        glDisable(GL_CULL_FACE);
+        glBindVertexArray(m_resources.get(m_cardVao));
+        for (const VisibleCard& card : m_visibleCards) {
             glm::mat4 model(1.0f);
-            glm::mat4 view(1.0f);
-            glm::mat4 projection = glm::perspective(glm::radians(45.0f), 
-                                                    (float)window.getWidth() / window.getHeight(), 
-                                                    0.1f, 100.0f);
-            
-            // Bind shader and set uniforms
-            shader.bind();
-            shader.setUniform("uModel", model);
-            shader.setUniform("uView", view);
-            shader.setUniform("uProjection", projection);
-            
-            // Draw triangle
-            glBindVertexArray(vao);
-            glDrawArrays(GL_TRIANGLES, 0, 3);
-            glBindVertexArray(0);
-            
-            // Swap buffers and poll events
+            model[0][0] = cardSize;
+            model[1][1] = cardSize;
+            model[3] = glm::vec4(card.position, 1.0f);
+            m_cardShader.setUniform("uModel", model);
+            m_textureStreamer->bind(card.texture, 0);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glEnable(GL_CULL_FACE);
+    }
+    
+    // Rasterize whichever of the mesh and the triangle is drawn as the
+    // occluder, then keep only the cards whose bounds are not behind it
+    void cullOccludedCards(const glm::mat4& viewProjection, const glm::mat4& triangleModel, float angle) {
+        m_occlusionCuller.beginFrame(glm::value_ptr(viewProjection));
+        if (m_mesh) {
+            // Coarsest level whose error stays under a texel of the
+            // occlusion buffer, so the occluder matches the mesh's outline
+            glm::mat4 model = getMeshModel(angle);
+            int lod = m_mesh->selectLod(2.0f / m_meshScale, glm::radians(45.0f), m_occlusionCuller.getHeight());
+            const MeshLod& range = m_mesh->getLod(lod);
+            m_occlusionCuller.addOccluder(m_meshCache.getVertices()->position, sizeof(MeshVertex),
+                                          m_meshCache.getVertexCount(), m_meshCache.getIndices() + range.indexOffset,
+                                          range.indexCount, glm::value_ptr(model));
+        } else {
+            // Corners of the triangle's vertex buffer
+            const float corners[9] = { -0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f, 0.0f, 0.5f, 0.0f };
+            const uint32_t indices[3] = { 0, 1, 2 };
+            m_occlusionCuller.addOccluder(corners, 3 * sizeof(float), 3, indices, 3, glm::value_ptr(triangleModel));
+        }
+        m_occlusionCuller.render(m_jobs);
+        
+        m_cardVisible.resize(m_cardBounds.size());
+        m_occlusionCuller.testBounds(m_cardBounds.data(), m_cardBounds.size(), m_cardVisible.data(), m_jobs);
+        size_t kept = 0;
+        for (size_t i = 0; i < m_visibleCards.size(); ++i) {
+            if (m_cardVisible[i]) {
+                m_visibleCards[kept++] = m_visibleCards[i];
+            }
+        }
+        m_visibleCards.resize(kept);
+        
+        const OcclusionStats& stats = m_occlusionCuller.getStats();
+        m_occlusionStats.occluderTriangles += stats.occluderTriangles;
+        m_occlusionStats.objectsTested += stats.objectsTested;
+        m_occlusionStats.objectsOccluded += stats.objectsOccluded;
+        m_occlusionStats.rasterMilliseconds += stats.rasterMilliseconds;
+        m_occlusionStats.pyramidMilliseconds += stats.pyramidMilliseconds;
+        m_occlusionStats.testMilliseconds += stats.testMilliseconds;
+        ++m_occlusionFrames;
+    }
+    
+    void drawLitBackdrop(const glm::mat4& view, const glm::mat4& projection, float aspect, int renderWidth,
+                         int renderHeight, float angle) {
+        // Lights on a ring just in front of the wall, spun by the simulation
+        const size_t count = m_lights.size();
+        for (size_t i = 0; i < count; ++i) {
+            float t = static_cast<float>(i) / static_cast<float>(count);
+            float phase = angle * 0.5f + t * 6.2831853f;
+            float ring = 0.4f + 1.6f * std::fmod(t * 7.0f, 1.0f);
+            PointLight& light = m_lights[i];
+            light.position[0] = std::cos(phase) * ring * 1.4f;
+            light.position[1] = std::sin(phase) * ring * 0.8f;
+            light.position[2] = -0.3f;
+            light.radius = 0.6f;
+            light.color[0] = 0.5f + 0.5f * std::cos(t * 6.2831853f);
+            light.color[1] = 0.5f + 0.5f * std::cos(t * 6.2831853f - 2.094f);
+            light.color[2] = 0.5f + 0.5f * std::cos(t * 6.2831853f + 2.094f);
+            light.intensity = 0.3f;
+        }
+        
+        m_lightGrid.setProjection(glm::radians(45.0f), aspect, 0.1f, 100.0f);
+        m_lightGrid.build(m_lights.data(), count, glm::value_ptr(view), nullptr, &m_lightStats);
+        m_clusteredLighting.upload(m_lightGrid, m_lights.data(), count);
+        
+        m_litShader.bind();
+        m_litShader.setUniform("uView", view);
+        m_litShader.setUniform("uProjection", projection);
+        m_clusteredLighting.bind(m_litShader, renderWidth, renderHeight);
+        glBindVertexArray(m_resources.get(m_wallVao));
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+    }
+    
+    void drawFullscreen(ShaderProgram& shader, GLuint source, const glm::vec2& uvScale, const glm::vec2& uvMax) {
+        glDisable(GL_DEPTH_TEST);
+        shader.bind();
+        shader.setUniform("uSource", 0);
+        shader.setUniform("uUvScale", uvScale);
+        shader.setUniform("uUvMax", uvMax);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, source);
+        glBindVertexArray(m_resources.get(m_emptyVao));
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glEnable(GL_DEPTH_TEST);
+    }
+};
+
+// LLR_TRACE=<file.json> captures the first frames as a Chrome trace
+class TraceCapture {
+public:
+    TraceCapture() : m_path(std::getenv("LLR_TRACE")), m_frame(0) {
+        Profiler::setThreadName("Main");
+        if (m_path) {
+            Profiler::beginCapture();
+        }
+    }
+    
+    void nextFrame() {
+        const int traceFrames = 300;
+        if (m_path && m_frame++ == traceFrames) {
+            finish();
+        }
+    }
+    
+    void finish() {
+        if (!m_path) {
+            return;
+        }
+        Profiler::endCapture();
+        if (Profiler::writeChromeTrace(m_path)) {
+            std::cout << "Wrote trace to " << m_path << std::endl;
+        }
+        m_path = nullptr;
+    }
+    
+private:
+    const char* m_path;
+    int m_frame;
+};
+
+std::unique_ptr<VideoRecorder> createRecorder(const Options& options, JobSystem& jobs, int width, int height) {
+    if (options.recordOutput.empty()) {
+        return nullptr;
+    }
+    VideoRecorderSettings settings;
+    settings.output = options.recordOutput;
+    settings.fpsNumerator = options.recordFps;
+    return std::make_unique<VideoRecorder>(jobs, width, height, settings);
+}
+
+void finishRecording(VideoRecorder& recorder) {
+    recorder.finish();
+    VideoRecorderStats stats = recorder.getStats();
+    std::cout << "Recorded " << stats.written << " frames (" << stats.bytesWritten / (1024 * 1024) << " MiB), dropped "
+              << stats.droppedQueueFull << " on a full queue and " << stats.droppedReadback
+              << " with no free readback slot, " << stats.failedReadback << " failed to read back; conversion "
+              << (stats.written ? stats.convertMilliseconds / static_cast<double>(stats.written) : 0.0)
+              << " ms per frame" << std::endl;
+}
+
+void printGpuResources(const GpuResourceManager& resources) {
+    GpuResourceStats stats = resources.getStats();
+    std::cout << "GPU resources: " << stats.getLiveCount(GpuResourceType::Buffer) << " buffers ("
+              << stats.getLiveBytes(GpuResourceType::Buffer) / 1024 << " KiB), "
+              << stats.getLiveCount(GpuResourceType::Texture) << " textures ("
+              << stats.getLiveBytes(GpuResourceType::Texture) / 1024 << " KiB), "
+              << stats.getLiveCount(GpuResourceType::VertexArray) << " vertex arrays, "
+              << stats.getLiveCount(GpuResourceType::Program) << " programs; " << stats.pendingCount
+              << " awaiting deletion" << std::endl;
+}
+
+void loadSceneAssets(DemoScene& scene, const Options& options, JobSystem& jobs, UploadContext* uploads = nullptr) {
+    if (!options.meshPath.empty() && !scene.loadMesh(options.meshPath, &jobs, uploads)) {
+        throw std::runtime_error("Failed to load mesh: " + options.meshPath);
+    }
+    if (!options.textureDirectory.empty() &&
+        !scene.loadTextures(options.textureDirectory, jobs, options.textureBudgetMB * 1024 * 1024)) {
+        throw std::runtime_error("Failed to load textures: " + options.textureDirectory);
+    }
+}
+
+// Null unless --dynamic-res set a GPU frame time target
+std::unique_ptr<DynamicResolution> createDynamicResolution(const Options& options) {
+    if (options.dynamicResolutionMs <= 0.0) {
+        return nullptr;
+    }
+    DynamicResolutionSettings settings;
+    settings.targetMilliseconds = options.dynamicResolutionMs;
+    settings.minScale = options.minRenderScale;
+    return std::make_unique<DynamicResolution>(settings);
+}
+
+void printDynamicResolution(const DynamicResolution& dynamicResolution) {
+    DynamicResolutionStats stats = dynamicResolution.getStats();
+    std::cout << "Dynamic resolution: " << stats.changes << " changes over " << stats.samples
+              << " GPU samples, scale avg " << stats.averageScale << ", min " << stats.minScale << ", final "
+              << dynamicResolution.getScale() << std::endl;
+}
+
+void printLightClusters(const DemoScene& scene) {
+    const LightClusterStats& stats = scene.getLightStats();
+    std::cout << "Light clusters: " << stats.lightsVisible << " of " << stats.lightsTested << " lights visible, "
+              << stats.indexCount << " indices, at most " << stats.maxLightsPerCluster << " per cluster, binned in "
+              << stats.binMilliseconds << " ms" << std::endl;
+}
+
+void printMeshLod(const DemoScene& scene) {
+    int lod = scene.getMeshLod();
+    if (lod < 0) {
+        return;
+    }
+    const Mesh& mesh = *scene.getMesh();
+    std::cout << "Mesh LOD: level " << lod << " of " << mesh.getLodCount() << ", "
+              << mesh.getLod(lod).indexCount / 3 << " of " << mesh.getLod(0).indexCount / 3 << " triangles"
+              << std::endl;
+}
+
+void printMeshClusters(const DemoScene& scene) {
+    uint64_t frames = scene.getClusterFrames();
+    if (frames == 0) {
+        return;
+    }
+    const ClusterCullStats& stats = scene.getClusterStats();
+    double perFrame = 1.0 / static_cast<double>(frames);
+    std::cout << "Mesh clusters: " << stats.clustersVisible * perFrame << " of " << stats.clustersTested * perFrame
+              << " visible per frame, "
+              << 100.0 * static_cast<double>(stats.trianglesVisible) / static_cast<double>(std::max<size_t>(stats.trianglesTested, 1))
+              << "% of triangles drawn, cull " << stats.cullMilliseconds * perFrame << " ms, compact "
+              << stats.compactMilliseconds * perFrame << " ms" << std::endl;
+}
+
+void printTextureStreaming(const DemoScene& scene) {
+    const TextureStreamer* streamer = scene.getTextureStreamer();
+    if (!streamer) {
+        return;
+    }
+    const TextureStreamerStats& stats = streamer->getStats();
+    const TextureStreamerStats& peaks = scene.getTexturePeaks();
+    const TextureStreamerSettings& settings = streamer->getSettings();
+    const double mib = 1.0 / (1024.0 * 1024.0);
+    std::cout << "Texture streaming: peak " << peaks.residentBytes * mib << " MiB resident of "
+              << settings.budgetBytes * mib << " MiB budget with " << peaks.wantedBytes * mib << " MiB wanted, "
+              << stats.evictions << " evictions, " << stats.cancelledLoads << " cancelled loads, at most "
+              << peaks.loadsInFlight << " loads in flight, " << peaks.uploadsThisFrame << " uploads and "
+              << peaks.uploadedBytesThisFrame / 1024 << " of " << settings.maxUploadBytesPerFrame / 1024
+              << " KiB per frame" << std::endl;
+}
+
+void printCardOcclusion(const DemoScene& scene) {
+    uint64_t frames = scene.getCardOcclusionFrames();
+    if (frames == 0) {
+        return;
+    }
+    const OcclusionStats& stats = scene.getCardOcclusionStats();
+    double perFrame = 1.0 / static_cast<double>(frames);
+    std::cout << "Card occlusion: " << stats.objectsOccluded * perFrame << " of " << stats.objectsTested * perFrame
+              << " cards in the frustum hidden per frame, " << stats.occluderTriangles * perFrame
+              << " occluder triangles, raster " << stats.rasterMilliseconds * perFrame << " ms, pyramid "
+              << stats.pyramidMilliseconds * perFrame << " ms, test " << stats.testMilliseconds * perFrame << " ms"
+              << std::endl;
+}
+
+void printRenderGraph(const RenderGraph& graph) {
+    const RenderGraphStats& stats = graph.getStats();
+    std::cout << "Render graph: " << stats.passCount - stats.culledPassCount << " of " << stats.passCount
+              << " passes, " << stats.transientTextureCount << " transient textures on "
+              << stats.physicalTextureCount << " (" << stats.getBytesSavedByAliasing() / 1024
+              << " KiB saved by aliasing), compiled in " << stats.compileMilliseconds << " ms" << std::endl;
+}
+
+void printPacerStats(const FramePacer& pacer) {
+    FrameTimeStats stats = pacer.getStats();
+    std::cout << "Last " << stats.frames << " frames: avg " << stats.averageMilliseconds << " ms, p50 "
+              << stats.p50Milliseconds << ", p99 " << stats.p99Milliseconds << ", max " << stats.maxMilliseconds
+              << " ms" << std::endl;
+}
+
+// Input latency runs from the oldest event a frame consumed until its swap
+// returned; scan-out and the display add to that
+void printInputLatency(const std::vector<float>& latencyMs, const InputQueue& input) {
+    if (latencyMs.empty()) {
+        return;
+    }
+    FrameTimeStats stats = summarizeFrameTimes(latencyMs);
+    std::cout << "Input to present over " << stats.frames << " frames: p50 " << stats.p50Milliseconds << " ms, p99 "
+              << stats.p99Milliseconds << ", max " << stats.maxMilliseconds << " ms, " << input.getDroppedCount()
+              << " events dropped" << std::endl;
+}
+
+// Escape releases a captured cursor, or closes the window
+void handleWindowKeys(Window& window, const InputFrame& input, bool& cursorCaptured) {
+    if (!input.wasPressed(InputEvent::Type::Key, GLFW_KEY_ESCAPE)) {
+        return;
+    }
+    if (cursorCaptured) {
+        cursorCaptured = false;
+        window.setCursorCaptured(false);
+    } else {
+        window.setShouldClose(true);
+    }
+}
+
+void runWindowed(const Options& options) {
+    // Create window
+    Window window(options.width, options.height, "LowLevelRenderer", options.uploadThread);
+    window.setVSync(options.vsync);
+    
+    // Initialize OpenGL
+    initializeOpenGL((GLADloadproc)glfwGetProcAddress);
+    
+    GpuResourceManager resources;
+    JobSystem jobs;     // Before the scene, whose texture loads run on it
+    DemoScene scene(resources);
+    scene.setSharpness(options.sharpness);
+    scene.setLightCount(options.lightCount);
+    std::unique_ptr<DynamicResolution> dynamicResolution = createDynamicResolution(options);
+    DemoSimulation simulation;
+    GpuProfiler gpuProfiler;
+    TraceCapture trace;
+    // Declared after the scene so its pending uploads finish while the
+    // mesh mapping they read from is still open
+    std::unique_ptr<UploadContext> uploads;
+    if (options.uploadThread) {
+        uploads = std::make_unique<UploadContext>(window);
+    }
+    loadSceneAssets(scene, options, jobs, uploads.get());
+    // Recording keeps the size the window had when it started
+    std::unique_ptr<VideoRecorder> recorder = createRecorder(options, jobs, window.getWidth(), window.getHeight());
+    
+    FramePacerSettings pacerSettings;
+    pacerSettings.stepSeconds = 1.0 / options.simulationHz;
+    pacerSettings.targetFps = options.fpsLimit;
+    FramePacer pacer(pacerSettings);
+    
+    bool cursorCaptured = options.captureMouse;
+    window.setCursorCaptured(cursorCaptured);
+    InputFrame input;
+    std::vector<float> inputLatencyMs;
+    
+    // Main loop
+    while (!window.shouldClose()) {
+        trace.nextFrame();
+        LLR_PROFILE_SCOPE("Frame");
+        int steps = pacer.beginFrame();
+        window.getInput().drain(input);
+        handleWindowKeys(window, input, cursorCaptured);
+        simulation.applyInput(input);
+        for (int i = 0; i < steps; ++i) {
+            simulation.step(static_cast<float>(pacer.getStepSeconds()));
+        }
+        
+        gpuProfiler.beginFrame();
+        float renderScale = dynamicResolution ? dynamicResolution->getScale() : 1.0f;
+        scene.draw(gpuProfiler, 0, window.getWidth(), window.getHeight(), renderScale,
+                   simulation.getAngle(pacer.getAlpha()));
+        if (recorder) {
+            recorder->recordFrame(0);
+        }
+        gpuProfiler.endFrame();
+        if (dynamicResolution) {
+            dynamicResolution->update(gpuProfiler);
+        }
+        
+        // Swap buffers and poll events
+        {
+            LLR_PROFILE_SCOPE("Swap");
             window.swapBuffers();
-            window.pollEvents();
         }
+        resources.endFrame();
+        if (input.eventCount > 0) {
+            inputLatencyMs.push_back(static_cast<float>(InputQueue::now() - input.oldestTimestamp) * 1e-6f);
+        }
+        window.pollEvents();
+        pacer.endFrame();
+    }
+    if (recorder) {
+        finishRecording(*recorder);
+    }
+    
+    printPacerStats(pacer);
+    printInputLatency(inputLatencyMs, window.getInput());
+    if (dynamicResolution) {
+        printDynamicResolution(*dynamicResolution);
+    }
+    if (options.lightCount > 0) {
+        printLightClusters(scene);
+    }
+    printMeshLod(scene);
+    printMeshClusters(scene);
+    printTextureStreaming(scene);
+    printCardOcclusion(scene);
+    printRenderGraph(scene.getRenderGraph());
+    printGpuResources(resources);
+}
+
+// What the simulation hands to the render thread
+struct DemoSnapshot {
+    DemoSimulation simulation;
+    FramePacer::Clock::time_point stepTime;     // When the latest step was due
+    double stepSeconds = 1.0 / 60.0;
+    int width = 0;
+    int height = 0;
+    int64_t inputTimestamp = 0;     // Oldest input in this snapshot, 0 = none
+};
+
+// The main thread only pumps events and simulates, publishing a snapshot
+// after every batch of steps; the render thread owns the context and draws
+// the newest snapshot, extrapolating the blend factor from its timestamp
+// since the two loops run at unrelated rates. Rendering is one step behind
+// the simulation, as in the single-threaded loop.
+void runWindowedThreaded(const Options& options) {
+    Window window(options.width, options.height, "LowLevelRenderer");
+    TraceCapture trace;
+    
+    FramePacerSettings simulationSettings;
+    simulationSettings.stepSeconds = 1.0 / options.simulationHz;
+    FramePacer simulationPacer(simulationSettings);
+    DemoSimulation simulation;
+    
+    DemoSnapshot initial;
+    initial.stepTime = FramePacer::Clock::now();
+    initial.stepSeconds = simulationSettings.stepSeconds;
+    initial.width = window.getWidth();
+    initial.height = window.getHeight();
+    TripleBuffer<DemoSnapshot> snapshots(initial);
+    
+    // Render thread state. Steps are unused; the pacer limits and measures
+    // render frames.
+    FramePacerSettings renderSettings;
+    renderSettings.targetFps = options.fpsLimit;
+    FramePacer renderPacer(renderSettings);
+    std::unique_ptr<JobSystem> jobs;
+    std::unique_ptr<GpuResourceManager> resources;
+    std::unique_ptr<DemoScene> scene;
+    std::unique_ptr<GpuProfiler> gpuProfiler;
+    std::unique_ptr<DynamicResolution> dynamicResolution;
+    std::unique_ptr<VideoRecorder> recorder;
+    int64_t pendingInput = 0;
+    std::vector<float> inputLatencyMs;
+    
+    RenderThread::Callbacks callbacks;
+    callbacks.start = [&]() {
+        window.setVSync(options.vsync);
+        initializeOpenGL((GLADloadproc)glfwGetProcAddress);
+        jobs = std::make_unique<JobSystem>();
+        resources = std::make_unique<GpuResourceManager>();
+        scene = std::make_unique<DemoScene>(*resources);
+        scene->setSharpness(options.sharpness);
+        scene->setLightCount(options.lightCount);
+        loadSceneAssets(*scene, options, *jobs);
+        dynamicResolution = createDynamicResolution(options);
+        gpuProfiler = std::make_unique<GpuProfiler>();
+        recorder = createRecorder(options, *jobs, window.getWidth(), window.getHeight());
+    };
+    callbacks.frame = [&]() {
+        renderPacer.beginFrame();
+        LLR_PROFILE_SCOPE("Frame");
+        bool fresh = snapshots.acquire();
+        const DemoSnapshot& snapshot = snapshots.getReadBuffer();
+        if (fresh && snapshot.inputTimestamp != 0 && pendingInput == 0) {
+            pendingInput = snapshot.inputTimestamp;
+        }
+        double sinceStep = std::chrono::duration<double>(FramePacer::Clock::now() - snapshot.stepTime).count();
+        float alpha = static_cast<float>(std::clamp(sinceStep / snapshot.stepSeconds, 0.0, 1.0));
         
-        // Clean up
-        glDeleteVertexArrays(1, &vao);
-        glDeleteBuffers(1, &vbo);
+        gpuProfiler->beginFrame();
+        float renderScale = dynamicResolution ? dynamicResolution->getScale() : 1.0f;
+        scene->draw(*gpuProfiler, 0, snapshot.width, snapshot.height, renderScale, snapshot.simulation.getAngle(alpha));
+        if (recorder) {
+            recorder->recordFrame(0);
+        }
+        gpuProfiler->endFrame();
+        if (dynamicResolution) {
+            dynamicResolution->update(*gpuProfiler);
+        }
+        renderPacer.endFrame();
+    };
+    callbacks.presented = [&]() {
+        resources->endFrame();
+        if (pendingInput != 0) {
+            inputLatencyMs.push_back(static_cast<float>(InputQueue::now() - pendingInput) * 1e-6f);
+            pendingInput = 0;
+        }
+    };
+    callbacks.stop = [&]() {
+        if (recorder) {
+            finishRecording(*recorder);
+        }
+        recorder.reset();
+        gpuProfiler.reset();
+        if (dynamicResolution) {
+            printDynamicResolution(*dynamicResolution);
+        }
+        if (scene) {
+            if (options.lightCount > 0) {
+                printLightClusters(*scene);
+            }
+            printMeshLod(*scene);
+            printMeshClusters(*scene);
+            printTextureStreaming(*scene);
+            printCardOcclusion(*scene);
+            printRenderGraph(scene->getRenderGraph());
+        }
+        scene.reset();
+        printGpuResources(*resources);
+        resources.reset();
+        jobs.reset();
+    };
+    
+    bool cursorCaptured = options.captureMouse;
+    window.setCursorCaptured(cursorCaptured);
+    InputFrame input;
+    int64_t unpublishedInput = 0;
+    
+    RenderThread renderThread(window, std::move(callbacks));
+    while (!window.shouldClose() && renderThread.isRunning()) {
+        trace.nextFrame();
+        {
+            LLR_PROFILE_SCOPE("Simulate");
+            int steps = simulationPacer.beginFrame();
+            window.getInput().drain(input);
+            handleWindowKeys(window, input, cursorCaptured);
+            simulation.applyInput(input);
+            if (unpublishedInput == 0) {
+                unpublishedInput = input.oldestTimestamp;
+            }
+            for (int i = 0; i < steps; ++i) {
+                simulation.step(static_cast<float>(simulationPacer.getStepSeconds()));
+            }
+            if (steps > 0) {
+                double behind = simulationPacer.getAlpha() * simulationPacer.getStepSeconds();
+                DemoSnapshot& snapshot = snapshots.getWriteBuffer();
+                snapshot.simulation = simulation;
+                snapshot.stepTime = FramePacer::Clock::now() -
+                                    std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<double>(behind));
+                snapshot.stepSeconds = simulationPacer.getStepSeconds();
+                snapshot.width = window.getWidth();
+                snapshot.height = window.getHeight();
+                snapshot.inputTimestamp = unpublishedInput;
+                snapshots.publish();
+                unpublishedInput = 0;
+            }
+        }
         
+        // Sleep until input arrives or the next step is due
+        window.waitEvents(simulationPacer.getSecondsUntilNextStep());
+    }
+    renderThread.stop();
+    trace.finish();
+    
+    printPacerStats(renderPacer);
+    printInputLatency(inputLatencyMs, window.getInput());
+    std::cout << "Rendered " << renderThread.getFrameCount() << " frames" << std::endl;
+}
+
+void writeFrameTimes(const std::string& path, const std::vector<double>& frameMs) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open frame time file: " << path << std::endl;
+        return;
+    }
+    out << "frame,milliseconds\n";
+    for (size_t i = 0; i < frameMs.size(); ++i) {
+        out << i << "," << frameMs[i] << "\n";
+    }
+}
+
+void printFrameStats(const std::vector<double>& frameMs, const Options& options) {
+    FrameTimeStats stats = summarizeFrameTimes(std::vector<float>(frameMs.begin(), frameMs.end()));
+    std::cout << stats.frames << " frames at " << options.width << "x" << options.height << ": avg "
+              << stats.averageMilliseconds << " ms (" << 1000.0 / stats.averageMilliseconds << " fps), min "
+              << stats.minMilliseconds << ", p50 " << stats.p50Milliseconds << ", p95 " << stats.p95Milliseconds
+              << ", p99 " << stats.p99Milliseconds << ", max " << stats.maxMilliseconds << " ms" << std::endl;
+}
+
+// Render a fixed number of frames into an offscreen target. There is no
+// swap chain to pace the loop, so every frame ends with glFinish and its
+// time covers the CPU and GPU work of exactly that frame.
+void runHeadless(const Options& options) {
+    HeadlessContext context;
+    initializeOpenGL((GLADloadproc)HeadlessContext::getProcAddress);
+    
+    Framebuffer target(options.width, options.height);
+    GpuResourceManager resources;
+    JobSystem jobs;     // Before the scene, whose texture loads run on it
+    DemoScene scene(resources);
+    scene.setSharpness(options.sharpness);
+    scene.setLightCount(options.lightCount);
+    std::unique_ptr<DynamicResolution> dynamicResolution = createDynamicResolution(options);
+    DemoSimulation simulation;
+    GpuProfiler gpuProfiler;
+    TraceCapture trace;
+    loadSceneAssets(scene, options, jobs);
+    FrameCapture capture(jobs, options.width, options.height);
+    std::unique_ptr<VideoRecorder> recorder = createRecorder(options, jobs, options.width, options.height);
+    std::vector<double> frameMs;
+    frameMs.reserve(options.frames);
+    
+    for (int frame = 0; frame < options.frames; ++frame) {
+        trace.nextFrame();
+        auto start = std::chrono::steady_clock::now();
+        {
+            LLR_PROFILE_SCOPE("Frame");
+            gpuProfiler.beginFrame();
+            target.bind();
+            // One step per frame keeps headless output deterministic
+            simulation.step(static_cast<float>(1.0 / options.simulationHz));
+            float renderScale = dynamicResolution ? dynamicResolution->getScale() : 1.0f;
+            scene.draw(gpuProfiler, target.getId(), options.width, options.height, renderScale, simulation.angle);
+            gpuProfiler.endFrame();
+            if (dynamicResolution) {
+                dynamicResolution->update(gpuProfiler);
+            }
+            
+            // Dumps go through the PBO ring and are encoded on workers
+            if (options.dumpInterval > 0 && frame % options.dumpInterval == 0) {
+                capture.capture(target.getId(), static_cast<uint64_t>(frame), FrameCapture::writePng(options.dumpPrefix));
+            }
+            capture.update();
+            if (recorder) {
+                recorder->recordFrame(target.getId());
+            }
+            glFinish();
+            resources.endFrame();
+        }
+        frameMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    capture.flush();
+    if (recorder) {
+        finishRecording(*recorder);
+    }
+    trace.finish();
+    
+    printFrameStats(frameMs, options);
+    if (dynamicResolution) {
+        printDynamicResolution(*dynamicResolution);
+    }
+    if (options.lightCount > 0) {
+        printLightClusters(scene);
+    }
+    printMeshLod(scene);
+    printMeshClusters(scene);
+    printTextureStreaming(scene);
+    printCardOcclusion(scene);
+    printRenderGraph(scene.getRenderGraph());
+    printGpuResources(resources);
+    if (!options.frameTimesPath.empty()) {
+        writeFrameTimes(options.frameTimesPath, frameMs);
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        Options options = parseOptions(argc, argv);
+        if (options.headless) {
+            runHeadless(options);
+        } else if (options.renderThread) {
+            runWindowedThreaded(options);
+        } else {
+            runWindowed(options);
+        }
         return 0;
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-} 
\ No newline at end of file
+}
@@ -0,0 +1,213 @@
+#include "scene/LightClusters.h"
+#include "core/JobSystem.h"
+#include "core/Simd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Padding lanes sit far outside every cluster with zero radius
+constexpr float kFarAway = 1e30f;
+
+} // namespace
+
+LightClusterGrid::LightClusterGrid(const LightClusterSettings& settings)
+    : m_settings(settings), m_depthScale(0.0f), m_depthBias(0.0f) {
+    if (settings.tilesX <= 0 || settings.tilesY <= 0 || settings.slices <= 0) {
+        throw std::runtime_error("Light cluster grid dimensions must be positive");
+    }
+    size_t cellCount = static_cast<size_t>(settings.tilesX) * settings.tilesY * settings.slices;
+    m_cells.resize(cellCount);
+    m_minX.resize(cellCount);
+    m_minY.resize(cellCount);
+    m_minZ.resize(cellCount);
+    m_maxX.resize(cellCount);
+    m_maxY.resize(cellCount);
+    m_maxZ.resize(cellCount);
+    m_sliceIndices.resize(settings.slices);
+}
+
+void LightClusterGrid::setProjection(float fovY, float aspect, float nearZ, float farZ) {
+    float tanY = std::tan(fovY * 0.5f);
+    float tanX = tanY * aspect;
+    float logRange = std::log(farZ / nearZ);
+    m_depthScale = static_cast<float>(m_settings.slices) / logRange;
+    m_depthBias = -static_cast<float>(m_settings.slices) * std::log(nearZ) / logRange;
+
+    for (int slice = 0; slice < m_settings.slices; ++slice) {
+        float depthNear = nearZ * std::pow(farZ / nearZ, static_cast<float>(slice) / static_cast<float>(m_settings.slices));
+        float depthFar = nearZ * std::pow(farZ / nearZ, static_cast<float>(slice + 1) / static_cast<float>(m_settings.slices));
+        for (int y = 0; y < m_settings.tilesY; ++y) {
+            float ndcY0 = -1.0f + 2.0f * static_cast<float>(y) / static_cast<float>(m_settings.tilesY);
+            float ndcY1 = -1.0f + 2.0f * static_cast<float>(y + 1) / static_cast<float>(m_settings.tilesY);
+            for (int x = 0; x < m_settings.tilesX; ++x) {
+                float ndcX0 = -1.0f + 2.0f * static_cast<float>(x) / static_cast<float>(m_settings.tilesX);
+                float ndcX1 = -1.0f + 2.0f * static_cast<float>(x + 1) / static_cast<float>(m_settings.tilesX);
+
+                // Box around the tile's frustum segment; the camera looks down -z
+                size_t cell = (static_cast<size_t>(slice) * m_settings.tilesY + y) * m_settings.tilesX + x;
+                m_minX[cell] = std::min(ndcX0 * depthNear, ndcX0 * depthFar) * tanX;
+                m_maxX[cell] = std::max(ndcX1 * depthNear, ndcX1 * depthFar) * tanX;
+                m_minY[cell] = std::min(ndcY0 * depthNear, ndcY0 * depthFar) * tanY;
+                m_maxY[cell] = std::max(ndcY1 * depthNear, ndcY1 * depthFar) * tanY;
+                m_minZ[cell] = -depthFar;
+                m_maxZ[cell] = -depthNear;
+            }
+        }
+    }
+}
+
+void LightClusterGrid::build(const PointLight* lights, size_t count, const float* view, JobSystem* jobs,
+                             LightClusterStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    if (count > 0xFFFF) {
+        throw std::runtime_error("Light clusters index at most 65535 lights");
+    }
+
+    // Lights to view space
+    m_lightX.resize(count);
+    m_lightY.resize(count);
+    m_lightZ.resize(count);
+    m_lightRadius.resize(count);
+    auto transform = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const float* p = lights[i].position;
+            m_lightX[i] = view[0] * p[0] + view[4] * p[1] + view[8] * p[2] + view[12];
+            m_lightY[i] = view[1] * p[0] + view[5] * p[1] + view[9] * p[2] + view[13];
+            m_lightZ[i] = view[2] * p[0] + view[6] * p[1] + view[10] * p[2] + view[14];
+            m_lightRadius[i] = lights[i].radius;
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(count, transform, 1024);
+    } else {
+        transform(0, count);
+    }
+
+    auto bin = [&](size_t begin, size_t end) {
+        for (size_t slice = begin; slice < end; ++slice) {
+            binSlice(static_cast<int>(slice), count);
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(static_cast<size_t>(m_settings.slices), bin, 1);
+    } else {
+        bin(0, static_cast<size_t>(m_settings.slices));
+    }
+
+    // Concatenate the slices; cells past the index budget lose their lights
+    m_indices.clear();
+    bool overflowed = false;
+    size_t cellsPerSlice = static_cast<size_t>(m_settings.tilesX) * m_settings.tilesY;
+    for (int slice = 0; slice < m_settings.slices; ++slice) {
+        const std::vector<uint16_t>& sliceIndices = m_sliceIndices[slice];
+        size_t first = m_indices.size();
+        size_t kept = std::min(sliceIndices.size(), m_settings.maxLightIndices - std::min(first, m_settings.maxLightIndices));
+        m_indices.insert(m_indices.end(), sliceIndices.begin(), sliceIndices.begin() + kept);
+        overflowed |= kept < sliceIndices.size();
+
+        uint32_t offset = static_cast<uint32_t>(first);
+        uint32_t end = static_cast<uint32_t>(m_indices.size());
+        for (size_t i = 0; i < cellsPerSlice; ++i) {
+            LightClusterCell& cell = m_cells[slice * cellsPerSlice + i];
+            cell.offset = offset;
+            cell.count = std::min(cell.count, end - offset);
+            offset += cell.count;
+        }
+    }
+
+    if (stats) {
+        stats->lightsTested = count;
+        stats->indexCount = m_indices.size();
+        stats->overflowed = overflowed;
+        stats->maxLightsPerCluster = 0;
+        for (const LightClusterCell& cell : m_cells) {
+            stats->maxLightsPerCluster = std::max<size_t>(stats->maxLightsPerCluster, cell.count);
+        }
+        std::vector<uint8_t> touched(count, 0);
+        for (uint16_t index : m_indices) touched[index] = 1;
+        stats->lightsVisible = static_cast<size_t>(std::count(touched.begin(), touched.end(), 1));
+        stats->binMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void LightClusterGrid::binSlice(int slice, size_t lightCount) {
+    size_t cellsPerSlice = static_cast<size_t>(m_settings.tilesX) * m_settings.tilesY;
+    size_t firstCell = static_cast<size_t>(slice) * cellsPerSlice;
+    std::vector<uint16_t>& out = m_sliceIndices[slice];
+    out.clear();
+
+    // Lights overlapping the slice's depth range and the frustum's outer box
+    float sliceMinZ = m_minZ[firstCell];
+    float sliceMaxZ = m_maxZ[firstCell];
+    float sliceMinX = m_minX[firstCell];
+    float sliceMaxX = m_maxX[firstCell + cellsPerSlice - 1];
+    float sliceMinY = m_minY[firstCell];
+    float sliceMaxY = m_maxY[firstCell + cellsPerSlice - 1];
+    std::vector<uint16_t> candidates;
+    for (size_t i = 0; i < lightCount; ++i) {
+        float r = m_lightRadius[i];
+        if (m_lightZ[i] - r > sliceMaxZ || m_lightZ[i] + r < sliceMinZ ||
+            m_lightX[i] - r > sliceMaxX || m_lightX[i] + r < sliceMinX ||
+            m_lightY[i] - r > sliceMaxY || m_lightY[i] + r < sliceMinY) {
+            continue;
+        }
+        candidates.push_back(static_cast<uint16_t>(i));
+    }
+
+    std::vector<float> x, y, z, radiusSq;
+    std::vector<uint16_t> ids;
+    const Float4 zero(0.0f);
+    for (int row = 0; row < m_settings.tilesY; ++row) {
+        // Narrow to the row's vertical extent, as structure-of-arrays for
+        // the per-cluster test (every cluster of a row shares its y range)
+        size_t rowCell = firstCell + static_cast<size_t>(row) * m_settings.tilesX;
+        float rowMinY = m_minY[rowCell];
+        float rowMaxY = m_maxY[rowCell];
+        x.clear();
+        y.clear();
+        z.clear();
+        radiusSq.clear();
+        ids.clear();
+        for (uint16_t i : candidates) {
+            float r = m_lightRadius[i];
+            if (m_lightY[i] - r > rowMaxY || m_lightY[i] + r < rowMinY) {
+                continue;
+            }
+            x.push_back(m_lightX[i]);
+            y.push_back(m_lightY[i]);
+            z.push_back(m_lightZ[i]);
+            radiusSq.push_back(r * r);
+            ids.push_back(i);
+        }
+        while (x.size() % 4) {
+            x.push_back(kFarAway);
+            y.push_back(kFarAway);
+            z.push_back(kFarAway);
+            radiusSq.push_back(0.0f);
+        }
+
+        // Sphere against box: squared distance from the center to the box
+        for (int column = 0; column < m_settings.tilesX; ++column) {
+            size_t cell = rowCell + column;
+            Float4 minX(m_minX[cell]), minY(m_minY[cell]), minZ(m_minZ[cell]);
+            Float4 maxX(m_maxX[cell]), maxY(m_maxY[cell]), maxZ(m_maxZ[cell]);
+            size_t before = out.size();
+            for (size_t i = 0; i < x.size(); i += 4) {
+                Float4 px = Float4::load(&x[i]), py = Float4::load(&y[i]), pz = Float4::load(&z[i]);
+                Float4 dx = max(max(minX - px, px - maxX), zero);
+                Float4 dy = max(max(minY - py, py - maxY), zero);
+                Float4 dz = max(max(minZ - pz, pz - maxZ), zero);
+                int hits = moveMask(cmpGe(Float4::load(&radiusSq[i]), madd(dx, dx, madd(dy, dy, dz * dz))));
+                for (; hits; hits &= hits - 1) {
+                    int lane = 0;
+                    while (!(hits & (1 << lane))) ++lane;
+                    out.push_back(ids[i + lane]);
+                }
+            }
+            m_cells[cell].count = static_cast<uint32_t>(out.size() - before);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#include "scene/Mesh.h"
+#include "scene/MeshCache.h"
+#include <cstddef>
+
+Mesh::Mesh(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+           const MeshLod* lods, size_t lodCount)
+    : m_vao(0), m_vbo(0), m_ibo(0), m_vertexCount(vertexCount), m_indexCount(indexCount) {
+    setLods(lods, lodCount);
+    upload(vertices, indices);
+}
+
+Mesh::Mesh(const MeshData& data)
+    : Mesh(data.vertices.data(), data.vertices.size(), data.indices.data(), data.indices.size(),
+           data.lods.data(), data.lods.size()) {}
+
+Mesh::Mesh(const MeshCacheFile& cache)
+    : Mesh(cache.getVertices(), cache.getVertexCount(), cache.getIndices(), cache.getIndexCount(),
+           cache.getLods(), cache.getLodCount()) {}
+
+Mesh::Mesh(GLuint vertexBuffer, size_t vertexCount, GLuint indexBuffer, size_t indexCount, const MeshLod* lods,
+           size_t lodCount)
+    : m_vao(0), m_vbo(vertexBuffer), m_ibo(indexBuffer), m_vertexCount(vertexCount), m_indexCount(indexCount) {
+    setLods(lods, lodCount);
+    createVertexArray();
+}
+
+Mesh::~Mesh() {
+    if (m_vao != 0) glDeleteVertexArrays(1, &m_vao);
+    if (m_vbo != 0) glDeleteBuffers(1, &m_vbo);
+    if (m_ibo != 0) glDeleteBuffers(1, &m_ibo);
+}
+
+void Mesh::drawLod(int lod) const {
+    const MeshLod& range = m_lods[lod];
+    glBindVertexArray(m_vao);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), GL_UNSIGNED_INT,
+                   reinterpret_cast<const void*>(static_cast<uintptr_t>(range.indexOffset) * sizeof(uint32_t)));
+    glBindVertexArray(0);
+}
+
+void Mesh::drawIndices(GLuint indexBuffer, size_t byteOffset, size_t indexCount) const {
+    glBindVertexArray(m_vao);
+    // The element binding is VAO state: swap it for the draw, then restore
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT,
+                   reinterpret_cast<const void*>(static_cast<uintptr_t>(byteOffset)));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+    glBindVertexArray(0);
+}
+
+void Mesh::setLods(const MeshLod* lods, size_t lodCount) {
+    if (lodCount > 0) {
+        m_lods.assign(lods, lods + lodCount);
+    } else {
+        m_lods.push_back({ 0, static_cast<uint32_t>(m_indexCount), 0.0f, 0 });
+    }
+}
+
+void Mesh::upload(const MeshVertex* vertices, const uint32_t* indices) {
+    glGenBuffers(1, &m_vbo);
+    glGenBuffers(1, &m_ibo);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_vertexCount * sizeof(MeshVertex)), vertices, GL_STATIC_DRAW);
+
+    // Untyped storage; the element binding is made on the vertex array
+    glBindBuffer(GL_ARRAY_BUFFER, m_ibo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_indexCount * sizeof(uint32_t)), indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    createVertexArray();
+}
+
+void Mesh::createVertexArray() {
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+
+    // Position attribute
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, position));
+
+    // Normal attribute
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, normal));
+
+    // Texcoord attribute
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, uv));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
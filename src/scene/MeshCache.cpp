@@ -0,0 +1,221 @@
+#include "scene/MeshCache.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static uint64_t alignOffset(uint64_t offset) {
+    return (offset + kMeshSectionAlignment - 1) & ~(kMeshSectionAlignment - 1);
+}
+
+// Size of one element of a known section type, 0 for unknown types
+static uint64_t getSectionElementSize(MeshSectionType type) {
+    switch (type) {
+        case MeshSectionType::Vertices: return sizeof(MeshVertex);
+        case MeshSectionType::Indices: return sizeof(uint32_t);
+        case MeshSectionType::Bounds: return sizeof(MeshBounds);
+        case MeshSectionType::Lods: return sizeof(MeshLod);
+        case MeshSectionType::Clusters: return sizeof(MeshCluster);
+    }
+    return 0;
+}
+
+bool writeMeshCache(const std::string& path, const MeshData& mesh) {
+    MeshBounds bounds = mesh.computeBounds();
+
+    struct Blob {
+        MeshSectionType type;
+        uint32_t elementSize;
+        uint64_t elementCount;
+        const void* data;
+    };
+    std::vector<Blob> blobs = {
+        { MeshSectionType::Vertices, sizeof(MeshVertex), mesh.vertices.size(), mesh.vertices.data() },
+        { MeshSectionType::Indices, sizeof(uint32_t), mesh.indices.size(), mesh.indices.data() },
+        { MeshSectionType::Bounds, sizeof(MeshBounds), 1, &bounds }
+    };
+    if (!mesh.lods.empty()) {
+        blobs.push_back({ MeshSectionType::Lods, sizeof(MeshLod), mesh.lods.size(), mesh.lods.data() });
+    }
+    if (!mesh.clusters.empty()) {
+        blobs.push_back({ MeshSectionType::Clusters, sizeof(MeshCluster), mesh.clusters.size(), mesh.clusters.data() });
+    }
+    const uint32_t sectionCount = static_cast<uint32_t>(blobs.size());
+
+    // Lay out the section table
+    std::vector<MeshFileSection> sections(sectionCount);
+    uint64_t offset = sizeof(MeshFileHeader) + sizeof(MeshFileSection) * sectionCount;
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        offset = alignOffset(offset);
+        sections[i].type = blobs[i].type;
+        sections[i].elementSize = blobs[i].elementSize;
+        sections[i].elementCount = blobs[i].elementCount;
+        sections[i].offset = offset;
+        sections[i].size = blobs[i].elementSize * blobs[i].elementCount;
+        offset += sections[i].size;
+    }
+
+    MeshFileHeader header;
+    std::memcpy(header.magic, kMeshFileMagic, sizeof(header.magic));
+    header.version = kMeshFileVersion;
+    header.sectionCount = sectionCount;
+    header.vertexStride = sizeof(MeshVertex);
+    header.fileSize = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create mesh cache: " << path << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sections.data()), sizeof(MeshFileSection) * sectionCount);
+
+    static const char padding[kMeshSectionAlignment] = {};
+    uint64_t written = sizeof(MeshFileHeader) + sizeof(MeshFileSection) * sectionCount;
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        file.write(padding, static_cast<std::streamsize>(sections[i].offset - written));
+        file.write(static_cast<const char*>(blobs[i].data), static_cast<std::streamsize>(sections[i].size));
+        written = sections[i].offset + sections[i].size;
+    }
+
+    if (!file.good()) {
+        std::cerr << "Failed to write mesh cache: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MeshCacheFile::open(const std::string& path) {
+    // Opening unmaps any previous file, even when it fails
+    close();
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const uint8_t* base = m_file.data();
+    size_t size = m_file.size();
+
+    MeshFileHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "Mesh cache too small: " << path << std::endl;
+        close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+
+    if (std::memcmp(header.magic, kMeshFileMagic, sizeof(header.magic)) != 0 ||
+        header.version != kMeshFileVersion ||
+        header.vertexStride != sizeof(MeshVertex) ||
+        header.fileSize != size ||
+        sizeof(header) + sizeof(MeshFileSection) * header.sectionCount > size) {
+        std::cerr << "Mesh cache is invalid or from another version, re-cook it: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    const auto* sections = reinterpret_cast<const MeshFileSection*>(base + sizeof(header));
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        const MeshFileSection& section = sections[i];
+        if (section.offset > size || section.size > size - section.offset ||
+            section.offset % kMeshSectionAlignment != 0) {
+            std::cerr << "Mesh cache section out of range: " << path << std::endl;
+            close();
+            return false;
+        }
+
+        // Known sections must hold whole elements of their type, so a blob
+        // is never read past its end through a typed pointer
+        uint64_t elementSize = getSectionElementSize(section.type);
+        if (elementSize != 0 &&
+            (section.elementSize != elementSize || section.size % elementSize != 0 ||
+             section.size / elementSize != section.elementCount ||
+             (section.type == MeshSectionType::Bounds && section.elementCount != 1))) {
+            std::cerr << "Mesh cache section does not match its element type: " << path << std::endl;
+            close();
+            return false;
+        }
+
+        const uint8_t* blob = base + section.offset;
+        switch (section.type) {
+            case MeshSectionType::Vertices:
+                m_vertices = reinterpret_cast<const MeshVertex*>(blob);
+                m_vertexCount = section.elementCount;
+                break;
+            case MeshSectionType::Indices:
+                m_indices = reinterpret_cast<const uint32_t*>(blob);
+                m_indexCount = section.elementCount;
+                break;
+            case MeshSectionType::Bounds:
+                std::memcpy(&m_bounds, blob, sizeof(m_bounds));
+                break;
+            case MeshSectionType::Lods:
+                m_lods = reinterpret_cast<const MeshLod*>(blob);
+                m_lodCount = section.elementCount;
+                break;
+            case MeshSectionType::Clusters:
+                m_clusters = reinterpret_cast<const MeshCluster*>(blob);
+                m_clusterCount = section.elementCount;
+                break;
+            default:
+                // Unknown sections from newer cookers are skipped
+                break;
+        }
+    }
+
+    if (!m_vertices || !m_indices) {
+        std::cerr << "Mesh cache has no vertex or index section: " << path << std::endl;
+        close();
+        return false;
+    }
+    // One pass over the indices: the GPU must never fetch past the vertices
+    uint32_t maxIndex = 0;
+    for (size_t i = 0; i < m_indexCount; ++i) {
+        maxIndex = std::max(maxIndex, m_indices[i]);
+    }
+    if (m_indexCount > 0 && maxIndex >= m_vertexCount) {
+        std::cerr << "Mesh cache index out of range: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    for (size_t i = 0; i < m_lodCount; ++i) {
+        if (static_cast<uint64_t>(m_lods[i].indexOffset) + m_lods[i].indexCount > m_indexCount) {
+            std::cerr << "Mesh cache LOD out of range: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    for (size_t i = 0; i < m_clusterCount; ++i) {
+        if (static_cast<uint64_t>(m_clusters[i].indexOffset) + m_clusters[i].indexCount > m_indexCount) {
+            std::cerr << "Mesh cache cluster out of range: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MeshCacheFile::close() {
+    m_file.close();
+    m_vertices = nullptr;
+    m_vertexCount = 0;
+    m_indices = nullptr;
+    m_indexCount = 0;
+    m_bounds = {};
+    m_lods = nullptr;
+    m_lodCount = 0;
+    m_clusters = nullptr;
+    m_clusterCount = 0;
+}
+
+MeshData MeshCacheFile::toMeshData() const {
+    MeshData mesh;
+    mesh.vertices.assign(m_vertices, m_vertices + m_vertexCount);
+    mesh.indices.assign(m_indices, m_indices + m_indexCount);
+    mesh.lods.assign(m_lods, m_lods + m_lodCount);
+    mesh.clusters.assign(m_clusters, m_clusters + m_clusterCount);
+    return mesh;
+}
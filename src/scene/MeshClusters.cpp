@@ -0,0 +1,321 @@
+#include "scene/MeshClusters.h"
+#include "core/JobSystem.h"
+#include "core/Simd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+void normalize(float* v) {
+    float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (length > 0.0f) {
+        v[0] /= length;
+        v[1] /= length;
+        v[2] /= length;
+    }
+}
+
+MeshCluster computeClusterBounds(const MeshData& mesh, const uint32_t* indices, size_t indexCount) {
+    MeshCluster cluster = {};
+
+    float lower[3] = { INFINITY, INFINITY, INFINITY };
+    float upper[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (size_t i = 0; i < indexCount; ++i) {
+        const float* p = mesh.vertices[indices[i]].position;
+        for (int axis = 0; axis < 3; ++axis) {
+            lower[axis] = std::min(lower[axis], p[axis]);
+            upper[axis] = std::max(upper[axis], p[axis]);
+        }
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        cluster.center[axis] = (lower[axis] + upper[axis]) * 0.5f;
+    }
+    float radiusSq = 0.0f;
+    for (size_t i = 0; i < indexCount; ++i) {
+        const float* p = mesh.vertices[indices[i]].position;
+        float dx = p[0] - cluster.center[0], dy = p[1] - cluster.center[1], dz = p[2] - cluster.center[2];
+        radiusSq = std::max(radiusSq, dx * dx + dy * dy + dz * dz);
+    }
+    cluster.radius = std::sqrt(radiusSq);
+
+    // Cone around the mean face normal; its half-angle is the widest
+    // deviation of any face from the axis
+    std::vector<float> normals;
+    normals.reserve(indexCount);
+    float axis[3] = { 0.0f, 0.0f, 0.0f };
+    for (size_t i = 0; i < indexCount; i += 3) {
+        const float* p0 = mesh.vertices[indices[i]].position;
+        const float* p1 = mesh.vertices[indices[i + 1]].position;
+        const float* p2 = mesh.vertices[indices[i + 2]].position;
+        float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        if (n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f) {
+            continue;
+        }
+        normalize(n);
+        normals.insert(normals.end(), n, n + 3);
+        axis[0] += n[0];
+        axis[1] += n[1];
+        axis[2] += n[2];
+    }
+    normalize(axis);
+
+    float minDot = 1.0f;
+    for (size_t i = 0; i < normals.size(); i += 3) {
+        minDot = std::min(minDot, normals[i] * axis[0] + normals[i + 1] * axis[1] + normals[i + 2] * axis[2]);
+    }
+    std::copy(axis, axis + 3, cluster.coneAxis);
+    // A cone of 90 degrees or more never faces away as a whole
+    cluster.coneCutoff = normals.empty() || minDot <= 0.0f ? 2.0f : std::sqrt(1.0f - minDot * minDot);
+    return cluster;
+}
+
+} // namespace
+
+void buildClusters(MeshData& mesh) {
+    mesh.clusters.clear();
+    size_t baseOffset = mesh.lods.empty() ? 0 : mesh.lods[0].indexOffset;
+    size_t indexCount = mesh.lods.empty() ? mesh.indices.size() : mesh.lods[0].indexCount;
+    const uint32_t* indices = mesh.indices.data() + baseOffset;
+    size_t triangleCount = indexCount / 3;
+    size_t vertexCount = mesh.vertices.size();
+
+    // Triangles around each vertex
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < indexCount; ++i) ++offsets[indices[i] + 1];
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> adjacency(indexCount);
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indexCount; ++i) {
+            adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<uint8_t> assigned(triangleCount, 0);
+    // Stamp of the cluster currently holding the vertex / listing the triangle
+    std::vector<uint32_t> vertexStamp(vertexCount, UINT32_MAX);
+    std::vector<uint32_t> candidateStamp(triangleCount, UINT32_MAX);
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> reordered;
+    reordered.reserve(indexCount);
+
+    size_t seed = 0;
+    uint32_t clusterId = 0;
+    while (reordered.size() < indexCount) {
+        while (assigned[seed]) ++seed;
+
+        size_t clusterStart = reordered.size();
+        size_t clusterVertices = 0;
+        size_t clusterTriangles = 0;
+        candidates.assign(1, static_cast<uint32_t>(seed));
+        candidateStamp[seed] = clusterId;
+
+        // Grow greedily, taking the candidate that adds the fewest new
+        // vertices and, among those, the one nearest the cluster centroid,
+        // so clusters stay round and their bounds tight
+        float centroid[3] = { 0.0f, 0.0f, 0.0f };
+        while (clusterTriangles < kClusterMaxTriangles) {
+            size_t best = SIZE_MAX;
+            int bestNew = 4;
+            float bestDistance = INFINITY;
+            for (size_t c = 0; c < candidates.size();) {
+                uint32_t triangle = candidates[c];
+                if (assigned[triangle]) {
+                    candidates[c] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                int newVertices = 0;
+                float distance = 0.0f;
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t vertex = indices[triangle * 3 + k];
+                    newVertices += vertexStamp[vertex] != clusterId;
+                    if (clusterTriangles > 0) {
+                        const float* p = mesh.vertices[vertex].position;
+                        float dx = p[0] - centroid[0] / static_cast<float>(clusterTriangles * 3);
+                        float dy = p[1] - centroid[1] / static_cast<float>(clusterTriangles * 3);
+                        float dz = p[2] - centroid[2] / static_cast<float>(clusterTriangles * 3);
+                        distance += dx * dx + dy * dy + dz * dz;
+                    }
+                }
+                if (clusterVertices + newVertices <= kClusterMaxVertices &&
+                    (newVertices < bestNew || (newVertices == bestNew && distance < bestDistance))) {
+                    best = c;
+                    bestNew = newVertices;
+                    bestDistance = distance;
+                }
+                ++c;
+            }
+            if (best == SIZE_MAX) {
+                break;
+            }
+
+            uint32_t triangle = candidates[best];
+            candidates[best] = candidates.back();
+            candidates.pop_back();
+            assigned[triangle] = 1;
+            ++clusterTriangles;
+            for (int k = 0; k < 3; ++k) {
+                uint32_t vertex = indices[triangle * 3 + k];
+                reordered.push_back(vertex);
+                for (int axis = 0; axis < 3; ++axis) centroid[axis] += mesh.vertices[vertex].position[axis];
+                if (vertexStamp[vertex] == clusterId) {
+                    continue;
+                }
+                vertexStamp[vertex] = clusterId;
+                ++clusterVertices;
+                for (uint32_t a = offsets[vertex]; a < offsets[vertex + 1]; ++a) {
+                    uint32_t neighbour = adjacency[a];
+                    if (!assigned[neighbour] && candidateStamp[neighbour] != clusterId) {
+                        candidateStamp[neighbour] = clusterId;
+                        candidates.push_back(neighbour);
+                    }
+                }
+            }
+        }
+
+        MeshCluster cluster = computeClusterBounds(mesh, reordered.data() + clusterStart, reordered.size() - clusterStart);
+        cluster.indexOffset = static_cast<uint32_t>(baseOffset + clusterStart);
+        cluster.indexCount = static_cast<uint32_t>(reordered.size() - clusterStart);
+        mesh.clusters.push_back(cluster);
+        ++clusterId;
+    }
+
+    std::copy(reordered.begin(), reordered.end(), mesh.indices.begin() + baseOffset);
+}
+
+ClusterCullView makeClusterCullView(const float* m, const float* eye) {
+    // Gribb-Hartmann: rows of the matrix combined, m[column * 4 + row]
+    auto row = [m](int r, int c) { return m[c * 4 + r]; };
+    ClusterCullView view;
+    for (int i = 0; i < 3; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            view.planes[i * 2][c] = row(3, c) + row(i, c);
+            view.planes[i * 2 + 1][c] = row(3, c) - row(i, c);
+        }
+    }
+    for (auto& plane : view.planes) {
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        for (float& value : plane) value /= length;
+    }
+    std::copy(eye, eye + 3, view.eye);
+    return view;
+}
+
+ClusterCuller::ClusterCuller(const MeshCluster* clusters, size_t clusterCount) {
+    size_t padded = (clusterCount + 3) & ~size_t(3);
+    for (auto* array : { &m_centerX, &m_centerY, &m_centerZ, &m_radius, &m_axisX, &m_axisY, &m_axisZ, &m_cutoff }) {
+        array->assign(padded, 0.0f);
+    }
+    m_visible.assign(padded, 0);
+    m_ranges.resize(clusterCount);
+
+    for (size_t i = 0; i < clusterCount; ++i) {
+        const MeshCluster& cluster = clusters[i];
+        m_centerX[i] = cluster.center[0];
+        m_centerY[i] = cluster.center[1];
+        m_centerZ[i] = cluster.center[2];
+        m_radius[i] = cluster.radius;
+        m_axisX[i] = cluster.coneAxis[0];
+        m_axisY[i] = cluster.coneAxis[1];
+        m_axisZ[i] = cluster.coneAxis[2];
+        m_cutoff[i] = cluster.coneCutoff;
+        m_ranges[i] = { cluster.indexOffset, cluster.indexCount };
+    }
+}
+
+void ClusterCuller::cull(const ClusterCullView& view, std::vector<uint32_t>& visible, JobSystem* jobs,
+                         ClusterCullStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+
+    // One group is four clusters
+    auto test = [&](size_t begin, size_t end) {
+        Float4 eyeX(view.eye[0]), eyeY(view.eye[1]), eyeZ(view.eye[2]);
+        for (size_t group = begin; group < end; ++group) {
+            size_t i = group * 4;
+            Float4 cx = Float4::load(&m_centerX[i]);
+            Float4 cy = Float4::load(&m_centerY[i]);
+            Float4 cz = Float4::load(&m_centerZ[i]);
+            Float4 radius = Float4::load(&m_radius[i]);
+
+            // Smallest signed margin over all planes; positive means the
+            // sphere is at least partly inside every plane
+            Float4 margin(INFINITY);
+            for (const auto& plane : view.planes) {
+                Float4 distance = madd(cx, Float4(plane[0]), madd(cy, Float4(plane[1]), madd(cz, Float4(plane[2]), Float4(plane[3]))));
+                margin = min(margin, distance + radius);
+            }
+
+            // Normal cone: back-facing when dot(d, axis) >= cutoff * |d| + r
+            Float4 dx = cx - eyeX, dy = cy - eyeY, dz = cz - eyeZ;
+            Float4 length = sqrt(madd(dx, dx, madd(dy, dy, dz * dz)));
+            Float4 facing = madd(dx, Float4::load(&m_axisX[i]), madd(dy, Float4::load(&m_axisY[i]), dz * Float4::load(&m_axisZ[i])));
+            Float4 coneMargin = madd(Float4::load(&m_cutoff[i]), length, radius) - facing;
+            margin = min(margin, coneMargin);
+
+            float result[4];
+            margin.store(result);
+            for (int lane = 0; lane < 4; ++lane) {
+                m_visible[i + lane] = result[lane] > 0.0f;
+            }
+        }
+    };
+
+    size_t groups = m_visible.size() / 4;
+    if (jobs) {
+        jobs->parallelFor(groups, test, 64);
+    } else {
+        test(0, groups);
+    }
+
+    visible.clear();
+    for (size_t i = 0; i < m_ranges.size(); ++i) {
+        if (m_visible[i]) visible.push_back(static_cast<uint32_t>(i));
+    }
+
+    if (stats) {
+        stats->cullMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        stats->clustersTested = m_ranges.size();
+        stats->clustersVisible = visible.size();
+        stats->trianglesTested = 0;
+        for (const Range& range : m_ranges) stats->trianglesTested += range.count / 3;
+        stats->trianglesVisible = getIndexCount(visible) / 3;
+    }
+}
+
+size_t ClusterCuller::getIndexCount(const std::vector<uint32_t>& visible) const {
+    size_t count = 0;
+    for (uint32_t cluster : visible) count += m_ranges[cluster].count;
+    return count;
+}
+
+void ClusterCuller::compact(const uint32_t* indices, const std::vector<uint32_t>& visible, uint32_t* out,
+                            JobSystem* jobs, ClusterCullStats* stats) const {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<size_t> outputOffsets(visible.size());
+    size_t offset = 0;
+    for (size_t i = 0; i < visible.size(); ++i) {
+        outputOffsets[i] = offset;
+        offset += m_ranges[visible[i]].count;
+    }
+
+    auto copy = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Range& range = m_ranges[visible[i]];
+            std::copy(indices + range.offset, indices + range.offset + range.count, out + outputOffsets[i]);
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(visible.size(), copy, 256);
+    } else {
+        copy(0, visible.size());
+    }
+
+    if (stats) {
+        stats->compactMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
@@ -0,0 +1,36 @@
+#include "scene/MeshData.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MeshBounds MeshData::computeBounds() const {
+    MeshBounds bounds;
+    for (int axis = 0; axis < 3; ++axis) {
+        bounds.min[axis] = vertices.empty() ? 0.0f : std::numeric_limits<float>::max();
+        bounds.max[axis] = vertices.empty() ? 0.0f : std::numeric_limits<float>::lowest();
+    }
+
+    for (const auto& vertex : vertices) {
+        for (int axis = 0; axis < 3; ++axis) {
+            bounds.min[axis] = std::min(bounds.min[axis], vertex.position[axis]);
+            bounds.max[axis] = std::max(bounds.max[axis], vertex.position[axis]);
+        }
+    }
+    return bounds;
+}
+
+int selectLod(const MeshLod* lods, size_t lodCount, float distance, float fovY, int viewportHeight,
+              float maxPixelError) {
+    // World units to pixels at this distance
+    float pixelsPerUnit = static_cast<float>(viewportHeight) /
+                          (2.0f * std::max(distance, 1e-4f) * std::tan(fovY * 0.5f));
+
+    int selected = 0;
+    for (size_t i = 1; i < lodCount; ++i) {
+        if (lods[i].error * pixelsPerUnit > maxPixelError) {
+            break;
+        }
+        selected = static_cast<int>(i);
+    }
+    return selected;
+}
@@ -0,0 +1,381 @@
+#include "scene/MeshSimplifier.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Open borders are pinned much harder than surface deviation
+constexpr double kBorderWeight = 10.0;
+
+// Symmetric 4x4 plane quadric plus the total weight, so the evaluated
+// error is a weighted mean squared distance instead of growing with area
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0;
+    double b2 = 0, bc = 0, bd = 0;
+    double c2 = 0, cd = 0;
+    double d2 = 0;
+    double weight = 0;
+
+    void addPlane(double a, double b, double c, double d, double w) {
+        a2 += a * a * w; ab += a * b * w; ac += a * c * w; ad += a * d * w;
+        b2 += b * b * w; bc += b * c * w; bd += b * d * w;
+        c2 += c * c * w; cd += c * d * w;
+        d2 += d * d * w;
+        weight += w;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+        b2 += other.b2; bc += other.bc; bd += other.bd;
+        c2 += other.c2; cd += other.cd;
+        d2 += other.d2;
+        weight += other.weight;
+        return *this;
+    }
+
+    double evaluate(const float* p) const {
+        double x = p[0], y = p[1], z = p[2];
+        double error = a2 * x * x + b2 * y * y + c2 * z * z +
+                       2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z) + d2;
+        return weight > 0.0 ? std::fabs(error) / weight : 0.0;
+    }
+};
+
+struct Vec3 {
+    double x, y, z;
+};
+
+Vec3 sub(const float* a, const float* b) {
+    return { double(a[0]) - b[0], double(a[1]) - b[1], double(a[2]) - b[2] };
+}
+
+Vec3 cross(const Vec3& a, const Vec3& b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+double dot(const Vec3& a, const Vec3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+uint64_t edgeKey(uint32_t a, uint32_t b) {
+    return (uint64_t(a) << 32) | b;
+}
+
+struct Collapse {
+    double cost;
+    uint32_t from;
+    uint32_t to;
+};
+
+} // namespace
+
+float simplifyMesh(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+                   size_t targetIndexCount, float maxError, std::vector<uint32_t>& out) {
+    out.assign(indices, indices + indexCount);
+    if (indexCount <= targetIndexCount) {
+        return 0.0f;
+    }
+
+    // Weld by exact position: topology and quadrics live on positions, while
+    // the wedges (vertices) sharing one carry the seam attributes
+    std::vector<uint32_t> canonical(vertexCount);
+    {
+        std::vector<uint32_t> order(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            int c = std::memcmp(vertices[a].position, vertices[b].position, sizeof(vertices[a].position));
+            return c != 0 ? c < 0 : a < b;
+        });
+        for (size_t i = 0; i < order.size(); ++i) {
+            bool same = i > 0 && std::memcmp(vertices[order[i]].position, vertices[order[i - 1]].position,
+                                             sizeof(vertices[0].position)) == 0;
+            canonical[order[i]] = same ? canonical[order[i - 1]] : order[i];
+        }
+    }
+
+    auto position = [&](uint32_t vertex) { return vertices[vertex].position; };
+
+    // Surface quadrics, plus perpendicular planes along every wedge-level
+    // open edge so borders and seams resist moving off their line
+    std::vector<Quadric> quadrics(vertexCount);
+    {
+        std::vector<uint64_t> halfEdges;
+        halfEdges.reserve(indexCount);
+        for (size_t t = 0; t < indexCount; t += 3) {
+            for (int k = 0; k < 3; ++k) {
+                halfEdges.push_back(edgeKey(out[t + k], out[t + (k + 1) % 3]));
+            }
+        }
+        std::sort(halfEdges.begin(), halfEdges.end());
+
+        for (size_t t = 0; t < indexCount; t += 3) {
+            const uint32_t* tri = &out[t];
+            Vec3 normal = cross(sub(position(tri[1]), position(tri[0])), sub(position(tri[2]), position(tri[0])));
+            double length = std::sqrt(dot(normal, normal));
+            if (length <= 0.0) {
+                continue;
+            }
+            Vec3 n = { normal.x / length, normal.y / length, normal.z / length };
+            const float* p0 = position(tri[0]);
+            double d = -(n.x * p0[0] + n.y * p0[1] + n.z * p0[2]);
+            for (int k = 0; k < 3; ++k) {
+                quadrics[canonical[tri[k]]].addPlane(n.x, n.y, n.z, d, length * 0.5);
+            }
+
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = tri[k];
+                uint32_t b = tri[(k + 1) % 3];
+                if (std::binary_search(halfEdges.begin(), halfEdges.end(), edgeKey(b, a))) {
+                    continue;
+                }
+                Vec3 edge = sub(position(b), position(a));
+                double edgeLengthSq = dot(edge, edge);
+                Vec3 m = cross(edge, n);
+                double mLength = std::sqrt(dot(m, m));
+                if (mLength <= 0.0) {
+                    continue;
+                }
+                m = { m.x / mLength, m.y / mLength, m.z / mLength };
+                const float* pa = position(a);
+                double md = -(m.x * pa[0] + m.y * pa[1] + m.z * pa[2]);
+                quadrics[canonical[a]].addPlane(m.x, m.y, m.z, md, edgeLengthSq * kBorderWeight);
+                quadrics[canonical[b]].addPlane(m.x, m.y, m.z, md, edgeLengthSq * kBorderWeight);
+            }
+        }
+    }
+
+    const double maxCost = double(maxError) * maxError;
+    double worstCost = 0.0;
+
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<uint8_t> onBorder(vertexCount);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint64_t> directedEdges;
+    std::vector<uint64_t> edges;
+    std::vector<Collapse> collapses;
+    std::vector<std::pair<uint32_t, uint32_t>> wedgeMap;
+
+    // Each pass collapses an independent set of the cheapest edges (no two
+    // touching the same one-ring), then rebuilds the triangle list
+    while (out.size() > targetIndexCount) {
+        size_t triangleCount = out.size() / 3;
+
+        // Triangles around each position
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t index : out) ++adjacencyOffsets[canonical[index] + 1];
+        for (size_t i = 0; i < vertexCount; ++i) adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+        adjacency.resize(out.size());
+        {
+            std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < out.size(); ++i) {
+                adjacency[cursor[canonical[out[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // Position-level half-edges: one without its twin is a geometric border
+        directedEdges.clear();
+        edges.clear();
+        for (size_t t = 0; t < out.size(); t += 3) {
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = canonical[out[t + k]];
+                uint32_t b = canonical[out[t + (k + 1) % 3]];
+                directedEdges.push_back(edgeKey(a, b));
+                edges.push_back(edgeKey(std::min(a, b), std::max(a, b)));
+            }
+        }
+        std::sort(directedEdges.begin(), directedEdges.end());
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        auto isOpen = [&](uint32_t a, uint32_t b) {
+            return !std::binary_search(directedEdges.begin(), directedEdges.end(), edgeKey(b, a));
+        };
+        std::fill(onBorder.begin(), onBorder.end(), 0);
+        for (uint64_t key : directedEdges) {
+            uint32_t a = uint32_t(key >> 32);
+            uint32_t b = uint32_t(key);
+            if (isOpen(a, b)) {
+                onBorder[a] = onBorder[b] = 1;
+            }
+        }
+
+        collapses.clear();
+        for (uint64_t key : edges) {
+            uint32_t a = uint32_t(key >> 32);
+            uint32_t b = uint32_t(key);
+            bool borderEdge = isOpen(a, b) || isOpen(b, a);
+
+            Quadric combined = quadrics[a];
+            combined += quadrics[b];
+            // A border vertex may only slide along the border
+            bool canAB = !onBorder[a] || borderEdge;
+            bool canBA = !onBorder[b] || borderEdge;
+            double costAB = canAB ? combined.evaluate(position(b)) : HUGE_VAL;
+            double costBA = canBA ? combined.evaluate(position(a)) : HUGE_VAL;
+            if (!canAB && !canBA) {
+                continue;
+            }
+            if (costAB <= costBA) {
+                collapses.push_back({ costAB, a, b });
+            } else {
+                collapses.push_back({ costBA, b, a });
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) {
+            return x.cost < y.cost;
+        });
+
+        for (uint32_t i = 0; i < vertexCount; ++i) remap[i] = i;
+        std::fill(touched.begin(), touched.end(), 0);
+
+        size_t removed = 0;
+        size_t applied = 0;
+        for (const Collapse& collapse : collapses) {
+            if ((triangleCount - removed) * 3 <= targetIndexCount || collapse.cost > maxCost) {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to]) {
+                continue;
+            }
+
+            // Every wedge of the moving position must land on a wedge of the
+            // target through a shared triangle; otherwise the collapse would
+            // tear a seam or smear attributes across one
+            wedgeMap.clear();
+            bool valid = true;
+            size_t shared = 0;
+            for (uint32_t a = adjacencyOffsets[collapse.from]; valid && a < adjacencyOffsets[collapse.from + 1]; ++a) {
+                const uint32_t* tri = &out[adjacency[a] * 3];
+                int fromCorner = -1;
+                int toCorner = -1;
+                for (int k = 0; k < 3; ++k) {
+                    if (canonical[tri[k]] == collapse.from) fromCorner = k;
+                    if (canonical[tri[k]] == collapse.to) toCorner = k;
+                }
+                if (toCorner < 0) {
+                    continue;
+                }
+                ++shared;
+                auto it = std::find_if(wedgeMap.begin(), wedgeMap.end(),
+                                       [&](const auto& pair) { return pair.first == tri[fromCorner]; });
+                if (it == wedgeMap.end()) {
+                    wedgeMap.push_back({ tri[fromCorner], tri[toCorner] });
+                } else if (it->second != tri[toCorner]) {
+                    valid = false;
+                }
+            }
+
+            const float* target = position(collapse.to);
+            for (uint32_t a = adjacencyOffsets[collapse.from]; valid && a < adjacencyOffsets[collapse.from + 1]; ++a) {
+                const uint32_t* tri = &out[adjacency[a] * 3];
+                int fromCorner = -1;
+                bool hasTo = false;
+                for (int k = 0; k < 3; ++k) {
+                    if (canonical[tri[k]] == collapse.from) fromCorner = k;
+                    if (canonical[tri[k]] == collapse.to) hasTo = true;
+                }
+                if (hasTo) {
+                    continue;
+                }
+                valid = std::any_of(wedgeMap.begin(), wedgeMap.end(),
+                                    [&](const auto& pair) { return pair.first == tri[fromCorner]; });
+
+                // Reject collapses that flip a surviving triangle
+                const float* p[3] = { position(tri[0]), position(tri[1]), position(tri[2]) };
+                Vec3 before = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+                p[fromCorner] = target;
+                Vec3 after = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+                valid = valid && dot(before, after) > 0.0;
+            }
+            if (!valid || shared == 0) {
+                continue;
+            }
+
+            for (const auto& pair : wedgeMap) {
+                remap[pair.first] = pair.second;
+            }
+            quadrics[collapse.to] += quadrics[collapse.from];
+            for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; ++a) {
+                const uint32_t* tri = &out[adjacency[a] * 3];
+                for (int k = 0; k < 3; ++k) touched[canonical[tri[k]]] = 1;
+            }
+            removed += shared;
+            ++applied;
+            worstCost = std::max(worstCost, collapse.cost);
+        }
+
+        if (applied == 0) {
+            break;
+        }
+
+        size_t write = 0;
+        for (size_t t = 0; t < out.size(); t += 3) {
+            uint32_t a = remap[out[t]], b = remap[out[t + 1]], c = remap[out[t + 2]];
+            if (canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[a] == canonical[c]) {
+                continue;
+            }
+            out[write++] = a;
+            out[write++] = b;
+            out[write++] = c;
+        }
+        out.resize(write);
+    }
+
+    return static_cast<float>(std::sqrt(worstCost));
+}
+
+void generateLods(MeshData& mesh, const LodSettings& settings) {
+    if (!mesh.lods.empty()) {
+        const MeshLod& base = mesh.lods[0];
+        mesh.indices = std::vector<uint32_t>(mesh.indices.begin() + base.indexOffset,
+                                             mesh.indices.begin() + base.indexOffset + base.indexCount);
+        for (MeshCluster& cluster : mesh.clusters) {
+            cluster.indexOffset -= base.indexOffset;
+        }
+    }
+    mesh.lods.assign(1, { 0, static_cast<uint32_t>(mesh.indices.size()), 0.0f, 0 });
+
+    MeshBounds bounds = mesh.computeBounds();
+    float diagonal = std::sqrt((bounds.max[0] - bounds.min[0]) * (bounds.max[0] - bounds.min[0]) +
+                               (bounds.max[1] - bounds.min[1]) * (bounds.max[1] - bounds.min[1]) +
+                               (bounds.max[2] - bounds.min[2]) * (bounds.max[2] - bounds.min[2]));
+
+    std::vector<uint32_t> previous = mesh.indices;
+    std::vector<uint32_t> simplified;
+    for (int level = 1; level < settings.maxLevels; ++level) {
+        size_t target = static_cast<size_t>(static_cast<float>(previous.size() / 3) * settings.reduction) * 3;
+        if (target / 3 < settings.minTriangles) {
+            break;
+        }
+
+        // Simplify from the previous level: each step works on fewer
+        // triangles, and summing errors keeps the bound conservative
+        float error = simplifyMesh(mesh.vertices.data(), mesh.vertices.size(), previous.data(), previous.size(),
+                                   target, settings.maxError * diagonal, simplified);
+        if (simplified.size() * 10 > previous.size() * 9) {
+            break;   // Error limit reached; further levels would barely differ
+        }
+
+        mesh.lods.push_back({ static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(simplified.size()),
+                              mesh.lods.back().error + error, 0 });
+        mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+}
+
+void generateLods(std::vector<MeshData>& meshes, const LodSettings& settings, JobSystem* jobs) {
+    auto generate = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            generateLods(meshes[i], settings);
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(meshes.size(), generate, 1);
+    } else {
+        generate(0, meshes.size());
+    }
+}
@@ -0,0 +1,531 @@
+#include "scene/ObjImporter.h"
+#include "core/JobSystem.h"
+#include "core/MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Parsing
+
+const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isDigit(char c) {
+    return static_cast<unsigned>(c - '0') < 10u;
+}
+
+inline void skipSpaces(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+}
+
+// Numbers in OBJ files are short decimals, which fit in a 64-bit mantissa
+// and a small power of ten, so they can be converted exactly with one
+// double multiply/divide. Anything longer falls back to from_chars.
+bool parseFloat(const char*& p, const char* end, float& out) {
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    while (p < end && isDigit(*p)) {
+        anyDigits = true;
+        if (mantissa != 0 || *p != '0') {
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            } else {
+                ++exponent;
+            }
+            ++significantDigits;
+        }
+        ++p;
+    }
+
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && isDigit(*p)) {
+            anyDigits = true;
+            if (mantissa != 0 || *p != '0') {
+                if (significantDigits < 19) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                    --exponent;
+                }
+                ++significantDigits;
+            } else {
+                --exponent;
+            }
+            ++p;
+        }
+    }
+
+    if (!anyDigits) {
+        p = start;
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* exponentStart = p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        if (p < end && isDigit(*p)) {
+            int value = 0;
+            while (p < end && isDigit(*p)) {
+                value = std::min(value * 10 + (*p - '0'), 10000);
+                ++p;
+            }
+            exponent += negativeExponent ? -value : value;
+        } else {
+            p = exponentStart;
+        }
+    }
+
+    if (significantDigits <= 15 && exponent >= -22 && exponent <= 22) {
+        double value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / kPow10[-exponent] : value * kPow10[exponent];
+        out = static_cast<float>(negative ? -value : value);
+        return true;
+    }
+
+    // Slow path for long mantissas or large exponents
+#if defined(__cpp_lib_to_chars)
+    const char* fromStart = (*start == '+') ? start + 1 : start;
+    auto result = std::from_chars(fromStart, p, out);
+    return result.ec == std::errc();
+#else
+    char buffer[128];
+    size_t length = std::min<size_t>(static_cast<size_t>(p - start), sizeof(buffer) - 1);
+    std::memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    out = std::strtof(buffer, nullptr);
+    return true;
+#endif
+}
+
+inline bool parseInt(const char*& p, const char* end, int& out) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p >= end || !isDigit(*p)) {
+        return false;
+    }
+    int value = 0;
+    while (p < end && isDigit(*p)) {
+        value = value * 10 + (*p - '0');
+        ++p;
+    }
+    out = negative ? -value : value;
+    return true;
+}
+
+// Chunked parse results
+
+enum RelativeBits : uint8_t {
+    kRelativePosition = 1,
+    kRelativeUv = 2,
+    kRelativeNormal = 4
+};
+
+// One face corner. Before resolution an index is either absolute (0-based),
+// -1 for "absent", or chunk-relative when its RelativeBits flag is set.
+struct Corner {
+    int32_t position;
+    int32_t uv;
+    int32_t normal;
+    uint8_t relative;
+};
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> uvs;
+    std::vector<Corner> corners;
+    std::vector<uint32_t> faceSizes;
+
+    size_t positionBase = 0;
+    size_t normalBase = 0;
+    size_t uvBase = 0;
+    size_t triangleCount = 0;
+    size_t triangleBase = 0;
+
+    // Per attribute, whether some corner has it / lacks it; the identity
+    // path needs each attribute on all corners or none
+    bool anyUv = false;
+    bool anyMissingUv = false;
+    bool anyNormal = false;
+    bool anyMissingNormal = false;
+    bool indicesDiffer = false;     // Some vt or vn index differs from v
+};
+
+// OBJ indices are 1-based, or negative to count back from the most recent
+// element. Negative ones are stored relative to the chunk and fixed up once
+// the element counts of earlier chunks are known.
+inline int32_t encodeIndex(int index, size_t localCount, uint8_t bit, uint8_t& relative) {
+    if (index > 0) return index - 1;
+    if (index < 0) {
+        relative |= bit;
+        return static_cast<int32_t>(localCount) + index;
+    }
+    return -1;
+}
+
+void parseChunk(Chunk& chunk) {
+    const char* p = chunk.begin;
+    const char* end = chunk.end;
+
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) lineEnd = end;
+
+        skipSpaces(p, lineEnd);
+        if (p + 1 < lineEnd && p[0] == 'v') {
+            char kind = p[1];
+            if (kind == ' ' || kind == '\t') {
+                p += 2;
+                float value[3] = {};
+                for (int i = 0; i < 3; ++i) {
+                    skipSpaces(p, lineEnd);
+                    parseFloat(p, lineEnd, value[i]);
+                }
+                chunk.positions.insert(chunk.positions.end(), value, value + 3);
+            } else if (kind == 'n') {
+                p += 2;
+                float value[3] = {};
+                for (int i = 0; i < 3; ++i) {
+                    skipSpaces(p, lineEnd);
+                    parseFloat(p, lineEnd, value[i]);
+                }
+                chunk.normals.insert(chunk.normals.end(), value, value + 3);
+            } else if (kind == 't') {
+                p += 2;
+                float value[2] = {};
+                for (int i = 0; i < 2; ++i) {
+                    skipSpaces(p, lineEnd);
+                    parseFloat(p, lineEnd, value[i]);
+                }
+                chunk.uvs.insert(chunk.uvs.end(), value, value + 2);
+            }
+        } else if (p + 1 < lineEnd && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+            p += 2;
+            unsigned cornerCount = 0;
+            while (true) {
+                skipSpaces(p, lineEnd);
+                int position = 0, uv = 0, normal = 0;
+                if (!parseInt(p, lineEnd, position)) break;
+
+                // v, v/vt, v//vn or v/vt/vn
+                if (p < lineEnd && *p == '/') {
+                    ++p;
+                    parseInt(p, lineEnd, uv);
+                    if (p < lineEnd && *p == '/') {
+                        ++p;
+                        parseInt(p, lineEnd, normal);
+                    }
+                }
+
+                Corner corner;
+                corner.relative = 0;
+                corner.position = encodeIndex(position, chunk.positions.size() / 3, kRelativePosition, corner.relative);
+                corner.uv = encodeIndex(uv, chunk.uvs.size() / 2, kRelativeUv, corner.relative);
+                corner.normal = encodeIndex(normal, chunk.normals.size() / 3, kRelativeNormal, corner.relative);
+                chunk.corners.push_back(corner);
+                ++cornerCount;
+            }
+
+            chunk.faceSizes.push_back(cornerCount);
+            if (cornerCount >= 3) {
+                chunk.triangleCount += cornerCount - 2;
+            }
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+// Lock-free open-addressing map from a resolved corner to its vertex index,
+// shared by all chunks during deduplication
+class CornerTable {
+public:
+    static constexpr uint32_t kPending = 0xFFFFFFFFu;
+
+    explicit CornerTable(size_t expectedKeys) : m_nextVertex(0) {
+        size_t capacity = 16;
+        while (capacity < expectedKeys + expectedKeys / 4) capacity <<= 1;
+        m_slots = std::make_unique<Slot[]>(capacity);
+        m_mask = capacity - 1;
+    }
+
+    uint32_t insert(const Corner& key) {
+        uint32_t hash = hashKey(key) | 1u;
+        size_t index = hash & m_mask;
+
+        while (true) {
+            Slot& slot = m_slots[index];
+            uint32_t tag = slot.tag.load(std::memory_order_acquire);
+
+            if (tag == 0) {
+                if (slot.tag.compare_exchange_strong(tag, hash, std::memory_order_acq_rel)) {
+                    slot.position = key.position;
+                    slot.uv = key.uv;
+                    slot.normal = key.normal;
+                    uint32_t vertex = m_nextVertex.fetch_add(1, std::memory_order_relaxed);
+                    slot.vertex.store(vertex, std::memory_order_release);
+                    return vertex;
+                }
+                // Lost the race; tag now holds the winner's hash
+            }
+
+            if (tag == hash) {
+                uint32_t vertex;
+                while ((vertex = slot.vertex.load(std::memory_order_acquire)) == kPending) {
+                    // Key is being published by another thread
+                }
+                if (slot.position == key.position && slot.uv == key.uv && slot.normal == key.normal) {
+                    return vertex;
+                }
+            }
+
+            index = (index + 1) & m_mask;
+        }
+    }
+
+    size_t getVertexCount() const { return m_nextVertex.load(); }
+    size_t getCapacity() const { return m_mask + 1; }
+
+    template<typename Fn>
+    void forEachInRange(size_t begin, size_t end, Fn&& fn) const {
+        for (size_t i = begin; i < end; ++i) {
+            const Slot& slot = m_slots[i];
+            if (slot.tag.load(std::memory_order_relaxed) != 0) {
+                fn(Corner{ slot.position, slot.uv, slot.normal, 0 }, slot.vertex.load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> tag{0};
+        int32_t position = 0;
+        int32_t uv = 0;
+        int32_t normal = 0;
+        std::atomic<uint32_t> vertex{kPending};
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    std::atomic<uint32_t> m_nextVertex;
+
+    static uint32_t hashKey(const Corner& key) {
+        uint32_t hash = static_cast<uint32_t>(key.position) * 0x9E3779B1u;
+        hash ^= static_cast<uint32_t>(key.uv) * 0x85EBCA77u + (hash << 6) + (hash >> 2);
+        hash ^= static_cast<uint32_t>(key.normal) * 0xC2B2AE3Du + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+};
+
+template<typename Fn>
+void forEachParallel(JobSystem* jobs, size_t count, Fn&& fn) {
+    if (jobs) {
+        jobs->parallelFor(count, fn, 1);
+    } else {
+        fn(size_t(0), count);
+    }
+}
+
+} // namespace
+
+bool importObj(const std::string& path, MeshData& mesh, JobSystem* jobs) {
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Failed to open OBJ file: " << path << std::endl;
+        return false;
+    }
+    file.prefetch();
+
+    const char* data = reinterpret_cast<const char*>(file.data());
+    const char* dataEnd = data + file.size();
+
+    // Split at line boundaries into a few chunks per thread
+    size_t threadCount = jobs ? jobs->getThreadCount() : 1;
+    size_t targetChunkSize = std::max<size_t>(file.size() / (threadCount * 8), 1 << 20);
+
+    std::vector<Chunk> chunks;
+    for (const char* begin = data; begin < dataEnd;) {
+        const char* end = begin + std::min<size_t>(targetChunkSize, static_cast<size_t>(dataEnd - begin));
+        if (end < dataEnd) {
+            const char* newline = static_cast<const char*>(std::memchr(end, '\n', static_cast<size_t>(dataEnd - end)));
+            end = newline ? newline + 1 : dataEnd;
+        }
+        Chunk chunk;
+        chunk.begin = begin;
+        chunk.end = end;
+        chunks.push_back(std::move(chunk));
+        begin = end;
+    }
+
+    // Pass 1: tokenize every chunk independently
+    forEachParallel(jobs, chunks.size(), [&chunks](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            parseChunk(chunks[i]);
+        }
+    });
+
+    // Prefix sums give each chunk its global element and triangle offsets
+    size_t positionCount = 0, normalCount = 0, uvCount = 0, cornerCount = 0, triangleCount = 0;
+    for (auto& chunk : chunks) {
+        chunk.positionBase = positionCount;
+        chunk.normalBase = normalCount;
+        chunk.uvBase = uvCount;
+        chunk.triangleBase = triangleCount;
+        positionCount += chunk.positions.size() / 3;
+        normalCount += chunk.normals.size() / 3;
+        uvCount += chunk.uvs.size() / 2;
+        cornerCount += chunk.corners.size();
+        triangleCount += chunk.triangleCount;
+    }
+
+    std::vector<float> positions(positionCount * 3);
+    std::vector<float> normals(normalCount * 3);
+    std::vector<float> uvs(uvCount * 2);
+
+    // Pass 2: gather attributes and resolve corner indices to absolute ones
+    std::atomic<bool> outOfRange{false};
+    forEachParallel(jobs, chunks.size(), [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            Chunk& chunk = chunks[c];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.positionBase * 3);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalBase * 3);
+            std::copy(chunk.uvs.begin(), chunk.uvs.end(), uvs.begin() + chunk.uvBase * 2);
+
+            for (Corner& corner : chunk.corners) {
+                if (corner.relative & kRelativePosition) corner.position += static_cast<int32_t>(chunk.positionBase);
+                if (corner.relative & kRelativeUv) corner.uv += static_cast<int32_t>(chunk.uvBase);
+                if (corner.relative & kRelativeNormal) corner.normal += static_cast<int32_t>(chunk.normalBase);
+                corner.relative = 0;
+
+                if (corner.position < 0 || corner.position >= static_cast<int32_t>(positionCount)) {
+                    outOfRange.store(true, std::memory_order_relaxed);
+                    corner.position = 0;
+                }
+                if (corner.uv >= static_cast<int32_t>(uvCount) || corner.uv < -1) corner.uv = -1;
+                if (corner.normal >= static_cast<int32_t>(normalCount) || corner.normal < -1) corner.normal = -1;
+
+                (corner.uv < 0 ? chunk.anyMissingUv : chunk.anyUv) = true;
+                (corner.normal < 0 ? chunk.anyMissingNormal : chunk.anyNormal) = true;
+                if ((corner.uv >= 0 && corner.uv != corner.position) ||
+                    (corner.normal >= 0 && corner.normal != corner.position)) {
+                    chunk.indicesDiffer = true;
+                }
+            }
+
+            // Source chunk text is no longer needed
+            chunk.positions = {};
+            chunk.normals = {};
+            chunk.uvs = {};
+        }
+    });
+
+    if (outOfRange.load()) {
+        std::cerr << "OBJ face references a missing vertex: " << path << std::endl;
+        return false;
+    }
+
+    bool anyUv = false, anyMissingUv = false, anyNormal = false, anyMissingNormal = false, indicesDiffer = false;
+    for (const Chunk& chunk : chunks) {
+        anyUv |= chunk.anyUv;
+        anyMissingUv |= chunk.anyMissingUv;
+        anyNormal |= chunk.anyNormal;
+        anyMissingNormal |= chunk.anyMissingNormal;
+        indicesDiffer |= chunk.indicesDiffer;
+    }
+    // A corner without vt next to one with vt at the same position must
+    // become a separate vertex, so mixed presence needs the general path
+    bool identity = !indicesDiffer && !(anyUv && anyMissingUv) && !(anyNormal && anyMissingNormal);
+
+    auto makeVertex = [&](const Corner& corner, MeshVertex& vertex) {
+        vertex = {};
+        std::memcpy(vertex.position, &positions[corner.position * 3], sizeof(vertex.position));
+        if (corner.normal >= 0) std::memcpy(vertex.normal, &normals[corner.normal * 3], sizeof(vertex.normal));
+        if (corner.uv >= 0) std::memcpy(vertex.uv, &uvs[corner.uv * 2], sizeof(vertex.uv));
+    };
+
+    mesh.indices.resize(triangleCount * 3);
+
+    // Emits fan triangles for a chunk given a corner -> vertex mapping
+    auto triangulate = [&mesh](const Chunk& chunk, auto&& vertexOf) {
+        uint32_t* out = mesh.indices.data() + chunk.triangleBase * 3;
+        size_t cornerIndex = 0;
+        for (uint32_t faceSize : chunk.faceSizes) {
+            const Corner* face = &chunk.corners[cornerIndex];
+            if (faceSize >= 3) {
+                uint32_t first = vertexOf(face[0]);
+                uint32_t previous = vertexOf(face[1]);
+                for (uint32_t i = 2; i < faceSize; ++i) {
+                    uint32_t current = vertexOf(face[i]);
+                    *out++ = first;
+                    *out++ = previous;
+                    *out++ = current;
+                    previous = current;
+                }
+            }
+            cornerIndex += faceSize;
+        }
+    };
+
+    if (identity) {
+        // Every corner uses the same index for v/vt/vn (the usual exporter
+        // output): vertex i is position i, no deduplication needed. Vertices
+        // only get the attributes the faces reference.
+        mesh.vertices.resize(positionCount);
+        forEachParallel(jobs, positionCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                int32_t index = static_cast<int32_t>(i);
+                Corner corner = { index, anyUv && i < uvCount ? index : -1, anyNormal && i < normalCount ? index : -1, 0 };
+                makeVertex(corner, mesh.vertices[i]);
+            }
+        });
+        forEachParallel(jobs, chunks.size(), [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                triangulate(chunks[c], [](const Corner& corner) { return static_cast<uint32_t>(corner.position); });
+            }
+        });
+    } else {
+        CornerTable table(cornerCount);
+        forEachParallel(jobs, chunks.size(), [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                triangulate(chunks[c], [&table](const Corner& corner) { return table.insert(corner); });
+            }
+        });
+
+        mesh.vertices.resize(table.getVertexCount());
+        forEachParallel(jobs, table.getCapacity(), [&](size_t begin, size_t end) {
+            table.forEachInRange(begin, end, [&](const Corner& corner, uint32_t vertex) {
+                makeVertex(corner, mesh.vertices[vertex]);
+            });
+        });
+    }
+
+    return true;
+}
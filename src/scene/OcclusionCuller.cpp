@@ -0,0 +1,329 @@
+#include "scene/OcclusionCuller.h"
+#include "core/JobSystem.h"
+#include "core/Simd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr int kTileWidth = 64;
+constexpr int kTileHeight = 32;
+// Vertices closer than this in clip w are treated as crossing the near plane
+constexpr float kMinW = 1e-5f;
+
+double elapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void multiplyMatrices(const float* a, const float* b, float* out) {
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k) sum += a[k * 4 + r] * b[c * 4 + k];
+            out[c * 4 + r] = sum;
+        }
+    }
+}
+
+// Column-major matrix times (x, y, z, 1): one column per madd
+Float4 transformPoint(const Float4* columns, const float* p) {
+    return madd(columns[0], Float4(p[0]), madd(columns[1], Float4(p[1]), madd(columns[2], Float4(p[2]), columns[3])));
+}
+
+} // namespace
+
+OcclusionCuller::OcclusionCuller(int width, int height)
+    : m_width(width), m_height(height),
+      m_tilesX((width + kTileWidth - 1) / kTileWidth),
+      m_tilesY((height + kTileHeight - 1) / kTileHeight),
+      m_viewProjection{} {
+    if (width <= 0 || height <= 0 || width % 4 != 0) {
+        throw std::runtime_error("Occlusion buffer width must be a positive multiple of 4");
+    }
+
+    m_bins.resize(static_cast<size_t>(m_tilesX) * m_tilesY);
+
+    // Level 0 plus max-Z mips down to 1x1
+    int levelWidth = width;
+    int levelHeight = height;
+    while (true) {
+        m_levels.emplace_back(static_cast<size_t>(levelWidth) * levelHeight, 1.0f);
+        if (levelWidth == 1 && levelHeight == 1) break;
+        levelWidth = std::max(1, (levelWidth + 1) / 2);
+        levelHeight = std::max(1, (levelHeight + 1) / 2);
+    }
+}
+
+void OcclusionCuller::beginFrame(const float* viewProjection) {
+    std::copy(viewProjection, viewProjection + 16, m_viewProjection);
+    m_triangles.clear();
+    for (auto& bin : m_bins) bin.clear();
+    m_stats = {};
+}
+
+void OcclusionCuller::addOccluder(const MeshData& mesh, const float* model) {
+    addOccluder(mesh.vertices.empty() ? nullptr : mesh.vertices[0].position, sizeof(MeshVertex), mesh.vertices.size(),
+                mesh.indices.data(), mesh.lods.empty() ? mesh.indices.size() : mesh.lods[0].indexCount, model);
+}
+
+void OcclusionCuller::addOccluder(const float* positions, size_t stride, size_t vertexCount, const uint32_t* indices,
+                                  size_t indexCount, const float* model) {
+    auto start = std::chrono::steady_clock::now();
+
+    float matrix[16];
+    if (model) {
+        multiplyMatrices(m_viewProjection, model, matrix);
+    } else {
+        std::copy(m_viewProjection, m_viewProjection + 16, matrix);
+    }
+    const Float4 columns[4] = { Float4::load(matrix), Float4::load(matrix + 4), Float4::load(matrix + 8), Float4::load(matrix + 12) };
+
+    // Clip space, four floats per vertex
+    std::vector<float> clip(vertexCount * 4);
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(positions);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        transformPoint(columns, reinterpret_cast<const float*>(base + v * stride)).store(&clip[v * 4]);
+    }
+
+    const float halfWidth = static_cast<float>(m_width) * 0.5f;
+    const float halfHeight = static_cast<float>(m_height) * 0.5f;
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        Triangle triangle;
+        bool valid = true;
+        for (int k = 0; k < 3 && valid; ++k) {
+            const float* c = &clip[indices[i + k] * 4];
+            // Near-plane crossings would need clipping; dropping the
+            // triangle only makes the occluder smaller, which is safe
+            if (c[3] < kMinW || c[2] < -c[3]) {
+                valid = false;
+                break;
+            }
+            float inverseW = 1.0f / c[3];
+            triangle.x[k] = (c[0] * inverseW + 1.0f) * halfWidth;
+            triangle.y[k] = (c[1] * inverseW + 1.0f) * halfHeight;
+            triangle.z[k] = std::min(1.0f, c[2] * inverseW * 0.5f + 0.5f);
+        }
+        if (!valid) {
+            continue;
+        }
+
+        float minX = std::min({ triangle.x[0], triangle.x[1], triangle.x[2] });
+        float maxX = std::max({ triangle.x[0], triangle.x[1], triangle.x[2] });
+        float minY = std::min({ triangle.y[0], triangle.y[1], triangle.y[2] });
+        float maxY = std::max({ triangle.y[0], triangle.y[1], triangle.y[2] });
+        int tileX0 = std::max(0, static_cast<int>(minX) / kTileWidth);
+        int tileX1 = std::min(m_tilesX - 1, static_cast<int>(maxX) / kTileWidth);
+        int tileY0 = std::max(0, static_cast<int>(minY) / kTileHeight);
+        int tileY1 = std::min(m_tilesY - 1, static_cast<int>(maxY) / kTileHeight);
+        if (maxX < 0.0f || maxY < 0.0f || tileX0 > tileX1 || tileY0 > tileY1) {
+            continue;
+        }
+
+        uint32_t index = static_cast<uint32_t>(m_triangles.size());
+        m_triangles.push_back(triangle);
+        for (int ty = tileY0; ty <= tileY1; ++ty) {
+            for (int tx = tileX0; tx <= tileX1; ++tx) {
+                m_bins[static_cast<size_t>(ty) * m_tilesX + tx].push_back(index);
+            }
+        }
+    }
+
+    m_stats.occluderTriangles = m_triangles.size();
+    m_stats.rasterMilliseconds += elapsedMilliseconds(start);
+}
+
+void OcclusionCuller::render(JobSystem* jobs) {
+    auto start = std::chrono::steady_clock::now();
+
+    size_t tileCount = m_bins.size();
+    auto rasterize = [&](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; ++tile) {
+            rasterizeTile(static_cast<int>(tile));
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(tileCount, rasterize, 1);
+    } else {
+        rasterize(0, tileCount);
+    }
+    m_stats.rasterMilliseconds += elapsedMilliseconds(start);
+
+    start = std::chrono::steady_clock::now();
+    buildPyramid(jobs);
+    m_stats.pyramidMilliseconds = elapsedMilliseconds(start);
+}
+
+void OcclusionCuller::rasterizeTile(int tile) {
+    int tileX0 = (tile % m_tilesX) * kTileWidth;
+    int tileY0 = (tile / m_tilesX) * kTileHeight;
+    int tileX1 = std::min(m_width, tileX0 + kTileWidth);
+    int tileY1 = std::min(m_height, tileY0 + kTileHeight);
+    float* depth = m_levels[0].data();
+
+    for (int y = tileY0; y < tileY1; ++y) {
+        std::fill(depth + static_cast<size_t>(y) * m_width + tileX0, depth + static_cast<size_t>(y) * m_width + tileX1, 1.0f);
+    }
+
+    const Float4 laneOffsets(0.5f, 1.5f, 2.5f, 3.5f);
+    const Float4 zero(0.0f);
+    for (uint32_t index : m_bins[tile]) {
+        Triangle t = m_triangles[index];
+        float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+        if (area == 0.0f) {
+            continue;
+        }
+        // Either winding occludes; normalize to counter-clockwise
+        if (area < 0.0f) {
+            std::swap(t.x[1], t.x[2]);
+            std::swap(t.y[1], t.y[2]);
+            std::swap(t.z[1], t.z[2]);
+            area = -area;
+        }
+
+        // Edge k runs from vertex k to k+1: E(x, y) = a*x + b*y + c >= 0 inside
+        float a[3], b[3], c[3];
+        for (int k = 0; k < 3; ++k) {
+            int next = (k + 1) % 3;
+            a[k] = t.y[k] - t.y[next];
+            b[k] = t.x[next] - t.x[k];
+            c[k] = -(a[k] * t.x[k] + b[k] * t.y[k]);
+        }
+
+        // Depth plane through the three vertices
+        float dzdx = ((t.z[1] - t.z[0]) * (t.y[2] - t.y[0]) - (t.z[2] - t.z[0]) * (t.y[1] - t.y[0])) / area;
+        float dzdy = ((t.z[2] - t.z[0]) * (t.x[1] - t.x[0]) - (t.z[1] - t.z[0]) * (t.x[2] - t.x[0])) / area;
+        float z0 = t.z[0] - dzdx * t.x[0] - dzdy * t.y[0];
+
+        int minX = std::max(tileX0, static_cast<int>(std::min({ t.x[0], t.x[1], t.x[2] }))) & ~3;
+        int maxX = std::min(tileX1, static_cast<int>(std::max({ t.x[0], t.x[1], t.x[2] })) + 1);
+        int minY = std::max(tileY0, static_cast<int>(std::min({ t.y[0], t.y[1], t.y[2] })));
+        int maxY = std::min(tileY1, static_cast<int>(std::max({ t.y[0], t.y[1], t.y[2] })) + 1);
+
+        const Float4 stepX(4.0f);
+        for (int y = minY; y < maxY; ++y) {
+            float centerY = static_cast<float>(y) + 0.5f;
+            Float4 px = Float4(static_cast<float>(minX)) + laneOffsets;
+            float* row = depth + static_cast<size_t>(y) * m_width;
+
+            for (int x = minX; x < maxX; x += 4, px += stepX) {
+                Float4 e0 = madd(Float4(a[0]), px, Float4(b[0] * centerY + c[0]));
+                Float4 e1 = madd(Float4(a[1]), px, Float4(b[1] * centerY + c[1]));
+                Float4 e2 = madd(Float4(a[2]), px, Float4(b[2] * centerY + c[2]));
+                Float4 inside = cmpGe(min(e0, min(e1, e2)), zero);
+                if (moveMask(inside) == 0) {
+                    continue;
+                }
+                Float4 z = madd(Float4(dzdx), px, Float4(dzdy * centerY + z0));
+                Float4 current = Float4::load(row + x);
+                select(inside, min(current, z), current).store(row + x);
+            }
+        }
+    }
+}
+
+void OcclusionCuller::buildPyramid(JobSystem* jobs) {
+    int sourceWidth = m_width;
+    int sourceHeight = m_height;
+    for (size_t level = 1; level < m_levels.size(); ++level) {
+        int width = std::max(1, (sourceWidth + 1) / 2);
+        int height = std::max(1, (sourceHeight + 1) / 2);
+        const float* source = m_levels[level - 1].data();
+        float* target = m_levels[level].data();
+
+        // Farthest of each 2x2 block; odd edges reuse the last row/column
+        auto reduce = [=](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; ++y) {
+                int y0 = static_cast<int>(y) * 2;
+                int y1 = std::min(y0 + 1, sourceHeight - 1);
+                for (int x = 0; x < width; ++x) {
+                    int x0 = x * 2;
+                    int x1 = std::min(x0 + 1, sourceWidth - 1);
+                    target[y * width + x] = std::max(std::max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+                                                     std::max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+                }
+            }
+        };
+        if (jobs && height >= 16) {
+            jobs->parallelFor(static_cast<size_t>(height), reduce, 8);
+        } else {
+            reduce(0, static_cast<size_t>(height));
+        }
+
+        sourceWidth = width;
+        sourceHeight = height;
+    }
+}
+
+bool OcclusionCuller::isOccluded(const MeshBounds& bounds) const {
+    const Float4 columns[4] = { Float4::load(m_viewProjection), Float4::load(m_viewProjection + 4),
+                                Float4::load(m_viewProjection + 8), Float4::load(m_viewProjection + 12) };
+
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY, minZ = INFINITY;
+    for (int corner = 0; corner < 8; ++corner) {
+        const float p[3] = { corner & 1 ? bounds.max[0] : bounds.min[0],
+                             corner & 2 ? bounds.max[1] : bounds.min[1],
+                             corner & 4 ? bounds.max[2] : bounds.min[2] };
+        float c[4];
+        transformPoint(columns, p).store(c);
+        if (c[3] < kMinW || c[2] < -c[3]) {
+            return false;
+        }
+        float inverseW = 1.0f / c[3];
+        minX = std::min(minX, c[0] * inverseW);
+        maxX = std::max(maxX, c[0] * inverseW);
+        minY = std::min(minY, c[1] * inverseW);
+        maxY = std::max(maxY, c[1] * inverseW);
+        minZ = std::min(minZ, c[2] * inverseW * 0.5f + 0.5f);
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor((minX + 1.0f) * 0.5f * static_cast<float>(m_width))));
+    int x1 = std::min(m_width - 1, static_cast<int>(std::floor((maxX + 1.0f) * 0.5f * static_cast<float>(m_width))));
+    int y0 = std::max(0, static_cast<int>(std::floor((minY + 1.0f) * 0.5f * static_cast<float>(m_height))));
+    int y1 = std::min(m_height - 1, static_cast<int>(std::floor((maxY + 1.0f) * 0.5f * static_cast<float>(m_height))));
+    if (x0 > x1 || y0 > y1) {
+        return false;   // Off screen: frustum culling's job
+    }
+
+    // Coarsest useful level: the rectangle spans at most two texels per
+    // axis there (three when straddling a texel boundary)
+    int size = std::max(x1 - x0, y1 - y0) + 1;
+    int level = 0;
+    while ((size >> level) > 2 && level + 1 < static_cast<int>(m_levels.size())) {
+        ++level;
+    }
+
+    int levelWidth = m_width;
+    for (int i = 0; i < level; ++i) levelWidth = std::max(1, (levelWidth + 1) / 2);
+    const float* depth = m_levels[level].data();
+
+    float maxZ = 0.0f;
+    for (int y = y0 >> level; y <= (y1 >> level); ++y) {
+        for (int x = x0 >> level; x <= (x1 >> level); ++x) {
+            maxZ = std::max(maxZ, depth[y * levelWidth + x]);
+        }
+    }
+    return minZ > maxZ;
+}
+
+void OcclusionCuller::testBounds(const MeshBounds* bounds, size_t count, uint8_t* visible, JobSystem* jobs) {
+    auto start = std::chrono::steady_clock::now();
+
+    auto test = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            visible[i] = !isOccluded(bounds[i]);
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(count, test, 256);
+    } else {
+        test(0, count);
+    }
+
+    m_stats.objectsTested += count;
+    for (size_t i = 0; i < count; ++i) {
+        m_stats.objectsOccluded += visible[i] == 0;
+    }
+    m_stats.testMilliseconds += elapsedMilliseconds(start);
+}
@@ -0,0 +1,41 @@
+// Packs an asset directory into a single .llrpak archive.
+//
+// Usage: AssetPacker <output.llrpak> <asset directory>
+#include <filesystem>
+#include <iostream>
+
+#include "core/AssetArchive.h"
+#include "core/JobSystem.h"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <output.llrpak> <asset directory>" << std::endl;
+        return 1;
+    }
+
+    namespace fs = std::filesystem;
+    fs::path root = argv[2];
+
+    std::vector<ArchiveInput> inputs;
+    std::error_code error;
+    for (const auto& item : fs::recursive_directory_iterator(root, error)) {
+        if (item.is_regular_file()) {
+            // Names always use '/' so lookups are platform independent
+            inputs.push_back({ fs::relative(item.path(), root).generic_string(), item.path().string() });
+        }
+    }
+    if (error) {
+        std::cerr << "Failed to scan asset directory: " << root << std::endl;
+        return 1;
+    }
+
+    JobSystem jobs;
+    ArchiveWriteStats stats;
+    if (!writeAssetArchive(argv[1], inputs, &jobs, kDefaultArchiveChunkSize, &stats)) {
+        return 1;
+    }
+
+    std::cout << "Packed " << stats.fileCount << " files: " << stats.rawBytes << " -> "
+              << stats.storedBytes << " bytes" << std::endl;
+    return 0;
+}
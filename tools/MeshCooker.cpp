@@ -0,0 +1,68 @@
+// Offline mesh cooker: converts source meshes into the binary .llrmesh
+// format that the runtime maps directly, with a generated LOD chain and
+// culling clusters for level 0.
+//
+// Usage: MeshCooker [--no-lods] <input.obj> <output.llrmesh> [more pairs...]
+#include <cstring>
+#include <iostream>
+
+#include "core/JobSystem.h"
+#include "scene/MeshCache.h"
+#include "scene/MeshClusters.h"
+#include "scene/MeshSimplifier.h"
+#include "scene/ObjImporter.h"
+
+int main(int argc, char** argv) {
+    int first = 1;
+    bool lods = true;
+    if (argc > 1 && std::strcmp(argv[1], "--no-lods") == 0) {
+        lods = false;
+        ++first;
+    }
+    if (argc - first < 2 || (argc - first) % 2 != 0) {
+        std::cerr << "Usage: " << argv[0] << " [--no-lods] <input.obj> <output.llrmesh> [<input> <output> ...]" << std::endl;
+        return 1;
+    }
+
+    JobSystem jobs;
+    int failures = 0;
+
+    std::vector<MeshData> meshes;
+    std::vector<int> sources;
+    for (int i = first; i + 1 < argc; i += 2) {
+        MeshData mesh;
+        if (!importObj(argv[i], mesh, &jobs)) {
+            ++failures;
+            continue;
+        }
+        meshes.push_back(std::move(mesh));
+        sources.push_back(i);
+    }
+
+    // Simplification is single-threaded per mesh, so spread meshes instead
+    if (lods) {
+        generateLods(meshes, LodSettings{}, &jobs);
+    }
+    jobs.parallelFor(meshes.size(), [&](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; ++m) buildClusters(meshes[m]);
+    }, 1);
+
+    for (size_t m = 0; m < meshes.size(); ++m) {
+        const MeshData& mesh = meshes[m];
+        int i = sources[m];
+        if (!writeMeshCache(argv[i + 1], mesh)) {
+            ++failures;
+            continue;
+        }
+        std::cout << argv[i] << " -> " << argv[i + 1] << ": " << mesh.vertices.size() << " vertices, triangles";
+        if (mesh.lods.empty()) {
+            std::cout << " " << mesh.indices.size() / 3;
+        }
+        for (const MeshLod& lod : mesh.lods) {
+            std::cout << " " << lod.indexCount / 3;
+        }
+        std::cout << ", " << mesh.clusters.size() << " clusters" << std::endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}